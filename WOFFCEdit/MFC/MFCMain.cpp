@@ -12,13 +12,22 @@ BEGIN_MESSAGE_MAP(MFCMain, CWinApp)
 	ON_COMMAND(ID_EDIT_PASTE,				&MFCMain::MenuEditPaste)
 	ON_COMMAND(ID_EDIT_DELETE,				&MFCMain::MenuEditDelete)
 	ON_COMMAND(ID_VIEW_WIREFRAME,			&MFCMain::MenuViewWireframe)
+	ON_COMMAND_RANGE(ID_CHUNK_FIRST, ID_CHUNK_LAST, &MFCMain::MenuChunkLoad)
+	ON_COMMAND_RANGE(ID_AUTOSAVE_OFF, ID_AUTOSAVE_5MIN, &MFCMain::MenuFileAutosave)
+	ON_UPDATE_COMMAND_UI_RANGE(ID_AUTOSAVE_OFF, ID_AUTOSAVE_5MIN, &MFCMain::UpdateMenuFileAutosave)
 	ON_COMMAND(ID_BUTTON_SAVE,				&MFCMain::ToolBarSave)
 	ON_COMMAND(ID_BUTTON_WIREFRAME,			&MFCMain::ToolBarWireframe)
 	ON_UPDATE_COMMAND_UI(ID_INDICATOR_TOOL, &CMyFrame::OnUpdatePage)
 END_MESSAGE_MAP()
 
+//Seconds between autosaves for each Autosave menu item, from ID_AUTOSAVE_OFF up
+static const int AUTOSAVE_INTERVALS[] = { 0, 30, 60, 300 };
+
 BOOL MFCMain::InitInstance()
 {
+	//Preferences are kept in the registry under this key
+	SetRegistryKey(_T("WFFC-Edit"));
+
 	//Instantiate the MFC frame
 	m_frame = new CMyFrame();
 	m_pMainWnd = m_frame;
@@ -48,10 +57,43 @@ BOOL MFCMain::InitInstance()
 	m_height	= m_windowRect.Height();
 
 	m_toolSystem.onActionInitialise(m_toolHandle, m_width, m_height);
+	LoadPreferences();
+	BuildChunkMenu();
 
 	return TRUE;
 }//End InitInstance
 
+void MFCMain::BuildChunkMenu()
+{
+	//Chunks come from the database rather than the resource file, so the menu is built once it is open
+	//Beyond the command range, chunks can't be given a menu item
+	const size_t maxChunks = ID_CHUNK_LAST - ID_CHUNK_FIRST + 1;
+	m_chunkIDs = m_toolSystem.getChunkIDs();
+	if (m_chunkIDs.size() > maxChunks) m_chunkIDs.resize(maxChunks);
+	if (m_chunkIDs.empty()) return;
+
+	CMenu chunkMenu;
+	chunkMenu.CreatePopupMenu();
+	for (size_t i = 0; i < m_chunkIDs.size(); i++)
+	{
+		const UINT commandID = ID_CHUNK_FIRST + static_cast<UINT>(i);
+		const std::wstring label = L"Chunk " + std::to_wstring(m_chunkIDs[i]);
+		chunkMenu.AppendMenu(MF_STRING, commandID, label.c_str());
+		if (m_chunkIDs[i] == m_toolSystem.getCurrentChunkID()) chunkMenu.CheckMenuRadioItem(ID_CHUNK_FIRST, ID_CHUNK_LAST, commandID, MF_BYCOMMAND);
+	}//End for
+
+	//The menu bar owns the popup from here
+	m_frame->m_menu1.AppendMenu(MF_POPUP, reinterpret_cast<UINT_PTR>(chunkMenu.Detach()), _T("&Chunk"));
+	m_frame->DrawMenuBar();
+}//End BuildChunkMenu
+
+void MFCMain::LoadPreferences()
+{
+	//Without a saved interval the tool keeps its default
+	const int autosaveInterval = static_cast<int>(m_toolSystem.getAutosaveInterval());
+	m_toolSystem.setAutosaveInterval(GetProfileInt(_T("Autosave"), _T("Interval"), autosaveInterval));
+}//End LoadPreferences
+
 int MFCMain::Run()
 {
 	MSG msg;
@@ -82,10 +124,13 @@ int MFCMain::Run()
 			const int ID = m_toolSystem.getCurrentSelectionID();
 			
 			std::wstring statusString = ID != -1 ? L"Selected Object: " + std::to_wstring(ID) : L"Selected Object: NONE";
-			m_toolSystem.Tick(&msg, m_toolSelectDialogue.m_active, m_toolSelectDialogue.m_startSelected);
+			m_toolSystem.Tick(&msg, m_toolSelectDialogue.m_active);
 
 			//Send current object ID to status bar in the main frame
 			m_frame->m_wndStatusBar.SetPaneText(1, statusString.c_str(), 1);	
+
+			//Autosave progress replaces the old modal save notification
+			m_frame->m_wndStatusBar.SetPaneText(0, m_toolSystem.getSaveStatusText().c_str(), 1);
 		}//End else
 	}//End while
 
@@ -112,7 +157,7 @@ void MFCMain::MenuEditSelect()
 	m_toolSelectDialogue.Create(IDD_DIALOG_SELECT);	//Start up modeless
 	m_toolSelectDialogue.m_active = true;
 	m_toolSelectDialogue.ShowWindow(SW_SHOW);	//Show modeless
-	m_toolSelectDialogue.SetObjectData(&m_toolSystem.m_sceneGraph, &m_toolSystem.m_selectedObject);
+	m_toolSelectDialogue.SetObjectData(&m_toolSystem.m_sceneGraph, &m_toolSystem.m_dialogueSelectionID);
 }//End MenuEditSelect
 
 void MFCMain::MenuEditUndo()
@@ -150,6 +195,31 @@ void MFCMain::MenuViewWireframe()
 	m_toolSystem.onActionWireframe();
 }//End MenuViewWireframe
 
+void MFCMain::MenuFileAutosave(const UINT commandID)
+{
+	const int seconds = AUTOSAVE_INTERVALS[commandID - ID_AUTOSAVE_OFF];
+	m_toolSystem.setAutosaveInterval(seconds);
+	WriteProfileInt(_T("Autosave"), _T("Interval"), seconds);
+}//End MenuFileAutosave
+
+void MFCMain::UpdateMenuFileAutosave(CCmdUI* pCmdUI)
+{
+	//Intervals set outside the menu leave every item unchecked
+	pCmdUI->SetRadio(AUTOSAVE_INTERVALS[pCmdUI->m_nID - ID_AUTOSAVE_OFF] == m_toolSystem.getAutosaveInterval());
+}//End UpdateMenuFileAutosave
+
+void MFCMain::MenuChunkLoad(const UINT commandID)
+{
+	const size_t index = commandID - ID_CHUNK_FIRST;
+	if (index >= m_chunkIDs.size()) return;
+
+	m_toolSystem.onActionLoadChunk(m_chunkIDs[index]);
+	m_frame->m_menu1.CheckMenuRadioItem(ID_CHUNK_FIRST, ID_CHUNK_LAST, commandID, MF_BYCOMMAND);
+
+	//An open select dialogue was listing the old chunk's objects
+	if (m_toolSelectDialogue.m_active) m_toolSelectDialogue.SetObjectData(&m_toolSystem.m_sceneGraph, &m_toolSystem.m_dialogueSelectionID);
+}//End MenuChunkLoad
+
 void MFCMain::ToolBarSave()
 {
 	m_toolSystem.onActionSave();
@@ -9,6 +9,7 @@
 #include "../Resources/resource.h"
 #include "MFCFrame.h"
 #include "SelectDialogue.h"
+#include <vector>
 
 class MFCMain : public CWinApp 
 {
@@ -25,9 +26,13 @@ private:
 	ToolMain		m_toolSystem;			//Instance of Tool System that we interface to
 	CRect			m_windowRect;			//Window area rectangle
 	SelectDialogue  m_toolSelectDialogue;	//For modeless dialogue, declare it here
+	std::vector<int>	m_chunkIDs;			//Chunks listed in the Chunk menu, in menu order
 
 	int m_width{};		
 	int m_height{};
+
+	void BuildChunkMenu();					//Add a Chunk menu listing every chunk in the database
+	void LoadPreferences();					//Apply settings saved by earlier sessions
 	
 	//Interface funtions for menu, toolbar, etc
 	afx_msg void MenuFileQuit();
@@ -40,6 +45,9 @@ private:
 	afx_msg void MenuEditPaste();
 	afx_msg void MenuEditDelete();
 	afx_msg void MenuViewWireframe();
+	afx_msg void MenuChunkLoad(UINT commandID);
+	afx_msg void MenuFileAutosave(UINT commandID);
+	afx_msg void UpdateMenuFileAutosave(CCmdUI* pCmdUI);
 	afx_msg	void ToolBarSave();
 	afx_msg void ToolBarWireframe();
 
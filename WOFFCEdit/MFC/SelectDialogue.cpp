@@ -14,7 +14,7 @@ BEGIN_MESSAGE_MAP(SelectDialogue, CDialogEx)
 END_MESSAGE_MAP()
 
 //Constructor used in modal
-SelectDialogue::SelectDialogue(CWnd* pParent, std::vector<SceneObject>* sceneGraph)
+SelectDialogue::SelectDialogue(CWnd* pParent, SceneGraph* sceneGraph)
 	: CDialogEx(IDD_DIALOG1, pParent)
 {
 	m_sceneGraph = sceneGraph;
@@ -31,20 +31,25 @@ SelectDialogue::~SelectDialogue()
 }//End destructor
 
 //Pass through pointers to the data in the tool we want to manipulate
-void SelectDialogue::SetObjectData(std::vector<SceneObject>* sceneGraph, int* selection)
+void SelectDialogue::SetObjectData(SceneGraph* sceneGraph, int* selectedObjectID)
 {
 	m_sceneGraph = sceneGraph;
-	m_currentSelection = selection;
-	m_startSelected = *selection;
+	m_currentSelection = selectedObjectID;
+	m_startSelected = *selectedObjectID;
 
-	const int numSceneObjects = m_sceneGraph->size();
+	//Called again when the chunk changes, so the list starts empty
+	m_listBox.ResetContent();
+
+	const int numSceneObjects = m_sceneGraph->GetSize();
 	//Iterate through all the objects in the scene graph and put an entry for each in the listbox
+	//Names are cold, so the first listing reads them in from the database
 	for (int i = 0; i < numSceneObjects; i++)
 	{
 		//Easily possible to make the data string presented more complex, showing other columns
-		std::wstring listBoxEntry = std::to_wstring(m_sceneGraph->at(i).ID);
+		const std::string& name = m_sceneGraph->GetCold(i).name;
+		std::wstring listBoxEntry = std::to_wstring(m_sceneGraph->GetHot(i).ID);
 		listBoxEntry.append(L" - ");
-		listBoxEntry.append(m_sceneGraph->at(i).name.begin(), m_sceneGraph->at(i).name.end());
+		listBoxEntry.append(name.begin(), name.end());
 		m_listBox.AddString(listBoxEntry.c_str());
 	}//End for
 }//End SetObjectData
@@ -69,8 +74,12 @@ void SelectDialogue::Select()
 	//CString currentSelectionValue;
 	
 	//m_listBox.GetText(index, currentSelectionValue);
+	//Rows were listed when the dialogue opened - edits since then can have moved or removed them
+	if (index == LB_ERR || index >= m_sceneGraph->GetSize()) return;
+
+	//Hand back the object's ID rather than the row, as the ID stays put while rows shift
 	m_startSelected = *m_currentSelection;
-	*m_currentSelection = index;
+	*m_currentSelection = m_sceneGraph->GetHot(index).ID;
 }//End Select
 
 BOOL SelectDialogue::OnInitDialog()
@@ -78,11 +87,11 @@ BOOL SelectDialogue::OnInitDialog()
 	CDialogEx::OnInitDialog();
 	//Uncomment for modal only
 	/*//roll through all the objects in the scene graph and put an entry for each in the listbox
-	int numSceneObjects = m_sceneGraph->size();
-	for (size_t i = 0; i < numSceneObjects; i++)
+	int numSceneObjects = m_sceneGraph->GetSize();
+	for (int i = 0; i < numSceneObjects; i++)
 	{
 		//Easily possible to make the data string presented more complex, showing other columns
-		std::wstring listBoxEntry = std::to_wstring(m_sceneGraph->at(i).ID);
+		std::wstring listBoxEntry = std::to_wstring(m_sceneGraph->GetHot(i).ID);
 		m_listBox.AddString(listBoxEntry.c_str());
 	}*/
 	
@@ -2,7 +2,7 @@
 #include "afxdialogex.h"
 #include "../Resources/resource.h"
 #include "afxwin.h"
-#include "../Tool/SceneObject.h"
+#include "../Tool/SceneGraph.h"
 #include <vector>
 
 class SelectDialogue : public CDialogEx
@@ -10,10 +10,10 @@ class SelectDialogue : public CDialogEx
 	DECLARE_DYNAMIC(SelectDialogue)
 
 public:
-	SelectDialogue(CWnd* pParent, std::vector<SceneObject>* sceneGraph);   // Modal - takes in our scenegraph in the constructor
+	SelectDialogue(CWnd* pParent, SceneGraph* sceneGraph);   // Modal - takes in our scenegraph in the constructor
 	SelectDialogue(CWnd* pParent = nullptr);
 	virtual ~SelectDialogue();
-	void SetObjectData(std::vector<SceneObject>* sceneGraph, int* selection);	//Passing in pointers to the data the class will operate on
+	void SetObjectData(SceneGraph* sceneGraph, int* selectedObjectID);	//Passing in pointers to the data the class will operate on - the selection is a database ID
 	
 //Dialog Data
 #ifdef AFX_DESIGN_TIME
@@ -25,14 +25,14 @@ protected:
 	afx_msg void End();		//Kill the dialog box
 	afx_msg void Select();	//Item has been selected
 
-	std::vector<SceneObject> * m_sceneGraph{};
+	SceneGraph* m_sceneGraph{};
 	int* m_currentSelection{};
 
 	DECLARE_MESSAGE_MAP()
 public:
 	//Control variable for more efficient access of the listbox
 	CListBox m_listBox;
-	int m_startSelected;
+	int m_startSelected;	//Database ID selected before the latest pick
 	BOOL m_active = false;
 	virtual BOOL OnInitDialog() override;
 	void PostNcDestroy() override;
@@ -4,41 +4,16 @@
 DisplayObject::DisplayObject()
 {
 	m_model =			nullptr;
-	m_texture_diffuse = nullptr;
-
-	m_orientation.x =	0.0f;
-	m_orientation.y =	0.0f;
-	m_orientation.z =	0.0f;
-
-	m_position.x =		0.0f;
-	m_position.y =		0.0f;
-	m_position.z =		0.0f;
-
-	m_scale.x =			0.0f;
-	m_scale.y =			0.0f;
-	m_scale.z =			0.0f;
+	m_modelPath =		AssetPathTable::NO_ASSET;
+	m_texturePath =		AssetPathTable::NO_ASSET;
+	m_ID =				0;
+	m_transform =		-1;
 
 	m_render =			true;
 	m_wireframe =		false;
-
-	m_light_type = 0;
-
-	m_light_diffuse_r = 0.0f;
-	m_light_diffuse_g = 0.0f;
-	m_light_diffuse_b = 0.0f;
-
-	m_light_specular_r = 0.0f;
-	m_light_specular_g = 0.0f;
-	m_light_specular_b = 0.0f;
-
-	m_light_spot_cutoff =	0.0f;
-	m_light_constant =		0.0f;
-	m_light_linear =		0.0f;
-	m_light_quadratic =		0.0f;
 }//End default constructor
 
 
 DisplayObject::~DisplayObject()
 {
-	//delete m_texture_diffuse;
 }//End destructor
\ No newline at end of file
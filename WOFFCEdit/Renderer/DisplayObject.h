@@ -1,34 +1,33 @@
 #pragma once
 #include "pch.h"
+#include "TextureCache.h"
 
+//What the renderer needs to draw one object - the object's records live in the scene graph, found by m_ID
 class DisplayObject
 {
 public:
 	DisplayObject();
 	~DisplayObject();
 
-	//Object mesh and diffuse texture
-	std::shared_ptr<DirectX::Model>	m_model;
-	ID3D11ShaderResourceView*		m_texture_diffuse;
-	std::wstring					m_model_path;
-	std::wstring					m_texture_diffuse_path;
+	//Declared so the display list can move objects in and out of its slots
+	DisplayObject(const DisplayObject&) = default;
+	DisplayObject(DisplayObject&&) = default;
+	DisplayObject& operator=(const DisplayObject&) = default;
+	DisplayObject& operator=(DisplayObject&&) = default;
+
+	//Object mesh and diffuse texture - the model is shared with every object using the same mesh, so the texture is bound
+	//at draw time rather than set on its effects. Both are released with the last object holding them
+	//Both stay null while they stream in, and the object is drawn as a placeholder box until its mesh arrives
+	std::shared_ptr<DirectX::Model>		m_model;
+	TextureCache::Handle				m_texture_diffuse;
+	AssetID								m_modelPath;		//What to stream in
+	AssetID								m_texturePath;
 
 	//Object Information
-	int m_ID;
-	DirectX::SimpleMath::Vector3 m_position;
-	DirectX::SimpleMath::Vector3 m_orientation;
-	DirectX::SimpleMath::Vector3 m_scale;
+	int m_ID;					//Database ID, shared with the object's scene graph records
+	int m_transform;			//Slot holding position, orientation and scale in Game's TransformStore
 
 	//Engine Booleans
 	bool m_render;
 	bool m_wireframe;
-
-	//Light Information
-	int		m_light_type;
-	float	m_light_diffuse_r,	m_light_diffuse_g,	m_light_diffuse_b;
-	float	m_light_specular_r, m_light_specular_g, m_light_specular_b;
-	float	m_light_spot_cutoff;
-	float	m_light_constant;
-	float	m_light_linear;
-	float	m_light_quadratic;
 };
\ No newline at end of file
@@ -9,7 +9,12 @@
 #include "../Tool/Commands/CutCommand.h"
 #include "../Tool/Commands/PasteCommand.h"
 #include "../Tool/Commands/MoveObjectCommand.h"
+#include "../Tool/MappedFile.h"
+#include "../Tool/SceneDatabase.h"
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace DirectX;
 using namespace SimpleMath;
@@ -32,19 +37,57 @@ constexpr auto PI_LONG = 3.14159265358979323846264338327950288419716939937510f;
 constexpr auto PI_SHORT = 3.14159f;
 #endif
 
-Game::Game() : m_camera(std::make_unique<Camera>()), m_commandStack(std::stack<Command*>()), m_redoStack(std::stack<Command*>())
+//Stands in for an object's mesh while it streams in - drawn and picked as a box the size of the object's spatial index bounds
+static const BoundingBox PLACEHOLDER_BOUNDS(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+//The transform store keeps matrices in XMFLOAT4X4 layout, so they load straight into registers
+static XMMATRIX LoadWorldMatrix(const TransformStore& transforms, const int slot)
+{
+	return XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(transforms.GetWorldMatrix(slot)));
+}//End LoadWorldMatrix
+
+static XMMATRIX LoadInverseWorldMatrix(const TransformStore& transforms, const int slot)
+{
+	return XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(transforms.GetInverseWorldMatrix(slot)));
+}//End LoadInverseWorldMatrix
+
+//Fog everything the model draws to the highlight colour, or turn that back off
+static void SetHighlight(Model& model, const bool highlighted)
+{
+	model.UpdateEffects([highlighted](IEffect* objectEffect)
+		{
+			IEffectFog* highlightEffect = dynamic_cast<IEffectFog*>(objectEffect);
+			if (!highlightEffect) return;
+
+			if (highlighted)
+			{
+				highlightEffect->SetFogStart(0.0f);
+				highlightEffect->SetFogEnd(0.0f);
+				highlightEffect->SetFogColor(Colors::AliceBlue);
+			}//End if
+			highlightEffect->SetFogEnabled(highlighted);
+		});//End UpdateEffects lambda
+}//End SetHighlight
+
+Game::Game() : m_camera(std::make_unique<Camera>()), m_commandStack(CommandStack()), m_redoStack(CommandStack())
 {
     m_deviceResources = std::make_unique<DX::DeviceResources>();
     m_deviceResources->RegisterDeviceNotify(this);
-	m_displayList.clear();
 
 	m_previousDistance = -D3D11_FLOAT32_MAX;
 	m_currentDragActive = false;
 	m_dragStartPosition = Vector3::Zero;
+	m_idAllocator = nullptr;
+	m_database = nullptr;
+	m_highlightedObject = ObjectHandle();
+	m_sceneGraph = nullptr;
+	m_clipboardFull = false;
 	
 	//Initial settings
 	//Modes
 	m_grid = false;
+
+	RegisterMemorySources();
 }//End default constructor
 
 Game::~Game()
@@ -55,6 +98,10 @@ Game::~Game()
         m_audEngine->Suspend();
     }//End if
 #endif
+
+	//Loader threads may still be using the device
+	m_assetStreamer.Cancel();
+	ClearCommandHistory();
 }//End destructor
 
 //Initialize the Direct3D resources required to run
@@ -109,14 +156,14 @@ void Game::ToggleWireframe()
 	m_wireframeMode = !m_wireframeMode;
 }//End ToggleWireframe
 
-int Game::MousePicking() const
+ObjectHandle Game::MousePicking() const
 {
 	//Reset previous distance
 	m_previousDistance = -D3D11_FLOAT32_MAX;
 
-	static int selectedID = -1;
-	const int previousIDCache = selectedID;
-	selectedID = -1;
+	static ObjectHandle selected;
+	const ObjectHandle previousSelectedCache = selected;
+	selected = ObjectHandle();
 	float pickingDistance = 0.0f;
 	float shortestDistance = D3D11_FLOAT32_MAX;
 
@@ -124,154 +171,158 @@ int Game::MousePicking() const
 	const XMVECTOR nearPlane =	XMVectorSet(m_inputCommands.mouseX, m_inputCommands.mouseY, 0.0f, 1.0f);
 	const XMVECTOR farPlane =	XMVectorSet(m_inputCommands.mouseX, m_inputCommands.mouseY, 1.0f, 1.0f);
 
+	//Unproject the points on the near/far plane once - each object then takes the ray into its own space
+	const XMVECTOR nearPoint = XMVector3Unproject
+	(
+		nearPlane,
+		0.0f,
+		0.0f,
+		m_screenDimensions.right,
+		m_screenDimensions.bottom,
+		m_deviceResources->GetScreenViewport().MinDepth,
+		m_deviceResources->GetScreenViewport().MaxDepth,
+		m_projection,
+		m_view,
+		m_world
+	);
+	const XMVECTOR farPoint = XMVector3Unproject
+	(
+		farPlane,
+		0.0f,
+		0.0f,
+		m_screenDimensions.right,
+		m_screenDimensions.bottom,
+		m_deviceResources->GetScreenViewport().MinDepth,
+		m_deviceResources->GetScreenViewport().MaxDepth,
+		m_projection,
+		m_view,
+		m_world
+	);
+	const XMVECTOR rayDirection = XMVector3Normalize(farPoint - nearPoint);
+
 	//Loop through the object display list and check each to pick
-	for (int id = 0; id < m_displayList.size(); id++)
+	for (uint32_t index = 0; index < m_displayList.GetNumSlots(); index++)
 	{
-		//Get object translation, scale, and rotation
-		const XMVECTORF32 translation =
-		{
-			m_displayList[id].m_position.x,
-			m_displayList[id].m_position.y,
-			m_displayList[id].m_position.z
-		};
-		const XMVECTORF32 scale =
+		//Skip slots whose object has been deleted or cut
+		const DisplayObject* object = m_displayList.GetAt(index);
+		if (!object) continue;
+
+		//Transform the ray into object space with the inverse world matrix the transform store keeps cached
+		const XMMATRIX worldToObject = LoadInverseWorldMatrix(m_transforms, object->m_transform);
+		const XMVECTOR objectNearPoint = XMVector3TransformCoord(nearPoint, worldToObject);
+		const XMVECTOR pickingVector = XMVector3Normalize(XMVector3TransformNormal(rayDirection, worldToObject));
+
+		//Objects still streaming in are picked by their placeholder box
+		if (!object->m_model)
 		{
-			m_displayList[id].m_scale.x,
-			m_displayList[id].m_scale.y,
-			m_displayList[id].m_scale.z
-		};
-		const XMVECTOR rotation = Quaternion::CreateFromYawPitchRoll
-		(
-			m_displayList[id].m_orientation.y * PI_SHORT / 180.0f,
-			m_displayList[id].m_orientation.x * PI_SHORT / 180.0f,
-			m_displayList[id].m_orientation.z * PI_SHORT / 180.0f
-		);
-
-		//Construct the matrix of the object in the world
-		XMMATRIX objectTransformMatrix = m_world * XMMatrixTransformation
-		(
-			g_XMZero,
-			Quaternion::Identity,
-			scale,
-			g_XMZero,
-			rotation,
-			translation
-		);
-
-		//Unproject the points on the near/far plane using the object matrix
-		const XMVECTOR nearPoint = XMVector3Unproject
-		(
-			nearPlane,
-			0.0f,
-			0.0f,
-			m_screenDimensions.right,
-			m_screenDimensions.bottom,
-			m_deviceResources->GetScreenViewport().MinDepth,
-			m_deviceResources->GetScreenViewport().MaxDepth,
-			m_projection,
-			m_view,
-			objectTransformMatrix
-		);
-		const XMVECTOR farPoint = XMVector3Unproject
-		(
-			farPlane,
-			0.0f,
-			0.0f,
-			m_screenDimensions.right,
-			m_screenDimensions.bottom,
-			m_deviceResources->GetScreenViewport().MinDepth,
-			m_deviceResources->GetScreenViewport().MaxDepth,
-			m_projection,
-			m_view,
-			objectTransformMatrix
-		);
-
-		//Transform the points into the picking vector
-		XMVECTOR pickingVector = farPoint - nearPoint;
-		pickingVector = XMVector3Normalize(pickingVector);
+			if (PLACEHOLDER_BOUNDS.Intersects(objectNearPoint, pickingVector, pickingDistance) && pickingDistance < shortestDistance)
+			{
+				shortestDistance = pickingDistance;
+				selected = m_displayList.GetHandleAt(index);
+			}//End if
+			continue;
+		}//End if
 
 		//Loop through the object's mesh list
-		auto& objectMeshList = m_displayList[id].m_model.get()->meshes;
+		auto& objectMeshList = object->m_model.get()->meshes;
 		for (int meshIndex = 0; meshIndex < objectMeshList.size(); meshIndex++)
 		{
-			if (objectMeshList[meshIndex]->boundingBox.Intersects(nearPoint, pickingVector, pickingDistance))
+			if (objectMeshList[meshIndex]->boundingBox.Intersects(objectNearPoint, pickingVector, pickingDistance))
 			{
 				if (pickingDistance < shortestDistance)
 				{
 					shortestDistance = pickingDistance;
-					selectedID = id;
+					selected = m_displayList.GetHandleAt(index);
 				}//End if
 			}//End if
 		}//End for
 	}//End for
 
 	//Highlight the selected object
-	HighlightSelectedObject(previousIDCache, selectedID);
+	HighlightSelectedObject(previousSelectedCache, selected);
 
-	//Return the ID of the selected object
-	return selectedID;
+	//Return the handle of the selected object
+	return selected;
 }//End MousePicking
 
-void Game::Delete(int& selectedID)
+void Game::Delete(ObjectHandle& selected)
 {
 	//Can't delete if nothing is selected
-	if (selectedID == -1) return;
+	if (!m_displayList.Get(selected)) return;
 
 	//Create new delete command and push it to the command stack
-	Command* newDeletion = new DeleteCommand(m_displayList, selectedID, m_displayList[selectedID]);
+	Command* newDeletion = new DeleteCommand(m_changeTracker, m_journal, *m_sceneGraph, m_displayList, m_transforms, selected, selected);
 	m_commandStack.push(newDeletion);
 
 	//Execute the deletion
 	newDeletion->Execute();
 
 	//Clear the redo stack from the new command invalidating it
-	while (!m_redoStack.empty()) m_redoStack.pop();
+	ClearRedoStack();
 }//End Delete
 
-void Game::Copy(const int selectedID)
+void Game::Copy(const ObjectHandle selected)
 {
 	//Can't copy if nothing is selected
-	if (selectedID == -1) return;
+	const DisplayObject* object = m_displayList.Get(selected);
+	if (!object) return;
 
-	m_objectToCopy = m_displayList[selectedID];
+	CopyToClipboard(*object);
 }//End Copy
 
-void Game::Cut(int& selectedID)
+void Game::Cut(ObjectHandle& selected)
 {
 	//Can't cut if nothing is selected
-	if (selectedID == -1) return;
+	const DisplayObject* object = m_displayList.Get(selected);
+	if (!object) return;
 
 	//Set the object to copy
-	m_objectToCopy = m_displayList[selectedID];
+	CopyToClipboard(*object);
 
 	//Create new cut command and push it to the command stack
-	Command* newCut = new CutCommand(m_displayList, selectedID, m_objectToCopy);
+	Command* newCut = new CutCommand(m_changeTracker, m_journal, *m_sceneGraph, m_displayList, m_transforms, selected, selected);
 	m_commandStack.push(newCut);
 
 	//Execute the cut
 	newCut->Execute();
 
 	//Clear the redo stack from the new command invalidating it
-	while (!m_redoStack.empty()) m_redoStack.pop();
+	ClearRedoStack();
 }//End Cut
 
 void Game::Paste()
 {
 	//Can't paste if we don't have anything to paste
-	if (m_objectToCopy.m_model == nullptr) return;
+	if (!m_clipboardFull || !m_idAllocator) return;
+
+	//The pasted object gets a fresh ID so it is saved as a new row - one no object in any chunk has
+	//Objects recovered from the journal can hold an ID that was freed before they were brought back, so those are skipped
+	//The scene's IDs are gathered once, so however many are skipped the scene graph is only walked once
+	std::unordered_set<int> sceneObjectIDs;
+	sceneObjectIDs.reserve(m_sceneGraph->GetSize());
+	for (int i = 0; i < m_sceneGraph->GetSize(); i++) sceneObjectIDs.insert(m_sceneGraph->GetHot(i).ID);
+
+	int pastedObjectID;
+	do
+	{
+		pastedObjectID = m_idAllocator->Allocate();
+	} while (pastedObjectID != -1 && sceneObjectIDs.count(pastedObjectID) != 0);
+	if (pastedObjectID == -1) return;
 
 	//Create new paste command and push it to the command stack
-	Command* newPaste = new PasteCommand(m_displayList, m_objectToCopy, m_deviceResources);
+	//It is attached to the original's parent if that is still there
+	const int parentTransform = m_clipboard.hot.parent_id == 0 ? TransformStore::NO_PARENT : FindTransform(m_clipboard.hot.parent_id);
+	Command* newPaste = new PasteCommand(m_changeTracker, m_journal, m_transforms, m_displayList, *m_sceneGraph, m_modelCache, m_textureCache, SceneGraph::Duplicate(m_clipboard), parentTransform, pastedObjectID);
 	m_commandStack.push(newPaste);
 
 	//Execute the paste
 	newPaste->Execute();
 
 	//Clear the redo stack from the new command invalidating it
-	while (!m_redoStack.empty()) m_redoStack.pop();
+	ClearRedoStack();
 }//End Paste
 
-void Game::Undo(const int previousSelectedID, const int& currentSelectedID)
+void Game::Undo(const ObjectHandle previousSelected, const ObjectHandle& currentSelected)
 {
 	//Can't undo if there's no commands to undo
 	if (!m_commandStack.empty())
@@ -279,11 +330,11 @@ void Game::Undo(const int previousSelectedID, const int& currentSelectedID)
 		m_commandStack.top()->Undo();
 		m_redoStack.push(m_commandStack.top());
 		m_commandStack.pop();
-		HighlightSelectedObject(previousSelectedID, currentSelectedID);
+		HighlightSelectedObject(previousSelected, currentSelected);
 	}//End if
 }//End Undo
 
-void Game::Redo(const int previousSelectedID, const int& currentSelectedID)
+void Game::Redo(const ObjectHandle previousSelected, const ObjectHandle& currentSelected)
 {
 	//Can't redo if there's no commands to redo
 	if (!m_redoStack.empty())
@@ -291,59 +342,35 @@ void Game::Redo(const int previousSelectedID, const int& currentSelectedID)
 		m_redoStack.top()->Execute();
 		m_commandStack.push(m_redoStack.top());
 		m_redoStack.pop();
-		HighlightSelectedObject(previousSelectedID, currentSelectedID);
+		HighlightSelectedObject(previousSelected, currentSelected);
 	}//End if
 }//End Redo
 
-void Game::HighlightSelectedObject(const int previousSelectedID, const int newSelectedID) const
+void Game::HighlightSelectedObject(const ObjectHandle previousSelected, const ObjectHandle newSelected) const
 {
-	//No change in highlighting status if our IDs match
-	if (previousSelectedID == newSelectedID) return;
-
-	//If we have a valid new ID
-	if (newSelectedID != -1)
-	{
-		//Change the new model's highlight to be activated
-		m_displayList[newSelectedID].m_model->UpdateEffects([](IEffect* objectEffect)
-			{
-				IEffectFog* highlightEffect = dynamic_cast<IEffectFog*>(objectEffect);
-				if (highlightEffect)
-				{
-					highlightEffect->SetFogStart(0.0f);
-					highlightEffect->SetFogEnd(0.0f);
-					highlightEffect->SetFogColor(Colors::AliceBlue);
-					highlightEffect->SetFogEnabled(true);
-				}//End if
-			});//End UpdateEffects lambda
-	}//End if
+	//No change in highlighting status if our handles match
+	if (previousSelected == newSelected) return;
 
-	//If we changed from a previous ID
-	if (previousSelectedID != -1 && previousSelectedID < m_displayList.size())
-	{
-		//Change the previous model's highlight back to normal
-		m_displayList[previousSelectedID].m_model->UpdateEffects([](IEffect* objectEffect)
-			{
-				IEffectFog* highlightEffect = dynamic_cast<IEffectFog*>(objectEffect);
-				if (highlightEffect) highlightEffect->SetFogEnabled(false);
-			});//End UpdateEffects lambda
-	}//End if
+	//The highlight is applied as the object is drawn, since its model is shared - a stale or null handle highlights nothing
+	m_highlightedObject = newSelected;
 }//End HighlightSelectedObject
 
-void Game::MoveSelectedObjectStart(int& selectedID) const
+void Game::MoveSelectedObjectStart(ObjectHandle& selected) const
 {
-	selectedID = MousePicking();
+	selected = MousePicking();
 }//End MoveSelectedObjectStart
 
-void Game::MoveSelectedObject(const int selectedID)
+void Game::MoveSelectedObject(const ObjectHandle selected)
 {
     //Can't move the object if there's no object to move
-	if(selectedID == -1) return;
+	const DisplayObject* selectedObject = m_displayList.Get(selected);
+	if(!selectedObject) return;
 
 	//If this is the first frame of moving the object
 	if(!m_currentDragActive)
 	{
 		//Log the start position before anything moves
-		m_dragStartPosition = m_displayList[selectedID].m_position;
+		m_transforms.GetPosition(selectedObject->m_transform, &m_dragStartPosition.x);
 		m_currentDragActive = true;
 	}//End if
 
@@ -387,79 +414,25 @@ void Game::MoveSelectedObject(const int selectedID)
 	mouseToWorld = XMVector3Normalize(mouseToWorld);
 	if(m_previousDistance <= -D3D11_FLOAT32_MAX)
 	{
-		//Get object translation, scale, and rotation
-		const XMVECTORF32 translation =
+		//Transform the ray into object space with the inverse world matrix the transform store keeps cached
+		const XMMATRIX worldToObject = LoadInverseWorldMatrix(m_transforms, selectedObject->m_transform);
+		const XMVECTOR objectNearPoint = XMVector3TransformCoord(nearPoint, worldToObject);
+		const XMVECTOR objectCameraToWorldVector = XMVector3Normalize(XMVector3TransformNormal(mouseToWorld, worldToObject));
+
+		//Loop through the object's mesh list - or its placeholder box if the mesh is still streaming in
+		if (!selectedObject->m_model) PLACEHOLDER_BOUNDS.Intersects(objectNearPoint, objectCameraToWorldVector, distance);
+		else
 		{
-			m_displayList[selectedID].m_position.x,
-			m_displayList[selectedID].m_position.y,
-			m_displayList[selectedID].m_position.z
-		};
-		const XMVECTORF32 scale =
-		{
-			m_displayList[selectedID].m_scale.x,
-			m_displayList[selectedID].m_scale.y,
-			m_displayList[selectedID].m_scale.z
-		};
-		const XMVECTOR rotation = Quaternion::CreateFromYawPitchRoll
-		(
-			m_displayList[selectedID].m_orientation.y * PI_SHORT / 180.0f,
-			m_displayList[selectedID].m_orientation.x * PI_SHORT / 180.0f,
-			m_displayList[selectedID].m_orientation.z * PI_SHORT / 180.0f
-		);
-
-		//Construct the matrix of the object in the world
-		XMMATRIX objectTransformMatrix = m_world * XMMatrixTransformation
-		(
-			g_XMZero,
-			Quaternion::Identity,
-			scale,
-			g_XMZero,
-			rotation,
-			translation
-		);
-
-		//Unproject the points on the near/far plane using the object matrix
-		const XMVECTOR objectNearPoint = XMVector3Unproject
-		(
-			nearPlane,
-			0.0f,
-			0.0f,
-			m_screenDimensions.right,
-			m_screenDimensions.bottom,
-			m_deviceResources->GetScreenViewport().MinDepth,
-			m_deviceResources->GetScreenViewport().MaxDepth,
-			m_projection,
-			m_view,
-			objectTransformMatrix
-		);
-		const XMVECTOR objectFarPoint = XMVector3Unproject
-		(
-			farPlane,
-			0.0f,
-			0.0f,
-			m_screenDimensions.right,
-			m_screenDimensions.bottom,
-			m_deviceResources->GetScreenViewport().MinDepth,
-			m_deviceResources->GetScreenViewport().MaxDepth,
-			m_projection,
-			m_view,
-			objectTransformMatrix
-		);
-
-		//Get the vector from the camera to the object
-		XMVECTOR objectCameraToWorldVector = objectFarPoint - objectNearPoint;
-		objectCameraToWorldVector = XMVector3Normalize(objectCameraToWorldVector);
-
-		//Loop through the object's mesh list
-	    std::vector<std::shared_ptr<ModelMesh>>& objectMeshList = m_displayList[selectedID].m_model.get()->meshes;
-		for (int meshIndex = 0; meshIndex < objectMeshList.size(); meshIndex++)
-		{
-			objectMeshList[meshIndex]->boundingBox.Intersects(objectNearPoint, objectCameraToWorldVector, distance);
-			if(distance < m_previousDistance)
+		    std::vector<std::shared_ptr<ModelMesh>>& objectMeshList = selectedObject->m_model.get()->meshes;
+			for (int meshIndex = 0; meshIndex < objectMeshList.size(); meshIndex++)
 			{
-				distance = m_previousDistance;
-			}//End if
-		}//End for
+				objectMeshList[meshIndex]->boundingBox.Intersects(objectNearPoint, objectCameraToWorldVector, distance);
+				if(distance < m_previousDistance)
+				{
+					distance = m_previousDistance;
+				}//End if
+			}//End for
+		}//End else
 
 		m_previousDistance = distance;
 	}//End if
@@ -468,25 +441,34 @@ void Game::MoveSelectedObject(const int selectedID)
 		distance = m_previousDistance;
 	}//End else
 
-	//Set the position of the selected object
+	//Set the position of the selected object - a child's position is relative to its parent, so bring the point into the parent's space
 	Vector3 objectPosition = nearPoint + mouseToWorld * distance;
-	m_displayList[selectedID].m_position = objectPosition;
+	const int parentSlot = m_transforms.GetParent(selectedObject->m_transform);
+	if (parentSlot != TransformStore::NO_PARENT) objectPosition = XMVector3TransformCoord(objectPosition, LoadInverseWorldMatrix(m_transforms, parentSlot));
+	m_transforms.SetPosition(selectedObject->m_transform, &objectPosition.x);
 }//End MoveSelectedObject
 
-void Game::MoveSelectedObjectEnd(int& selectedID, int movedObjectID)
+void Game::MoveSelectedObjectEnd(ObjectHandle& selected, const ObjectHandle movedObjectHandle)
 {
-	//We didn't actually move an object if the ID isn't valid
-	if(movedObjectID == -1) return;
+	//We didn't actually move an object if the handle isn't valid
+	const DisplayObject* movedObject = m_displayList.Get(movedObjectHandle);
+	if(!movedObject) return;
 
-	//Get the ID of the object that just moved
-	DisplayObject* movedObject = &m_displayList[selectedID];
+	//Get the position the object was dropped at
+	Vector3 finalPosition;
+	m_transforms.GetPosition(movedObject->m_transform, &finalPosition.x);
 
 	//Create a movement command for undo/redo support, passing in the start and final positions
-	Command* newMoveObject = new MoveObjectCommand(selectedID, movedObjectID, movedObject->m_position, m_dragStartPosition, m_displayList[movedObjectID].m_position);
+	Command* newMoveObject = new MoveObjectCommand(m_changeTracker, m_journal, selected, movedObjectHandle, movedObject->m_ID, *m_sceneGraph, m_transforms, movedObject->m_transform, m_dragStartPosition, finalPosition);
 
 	//Add the movement command to the command stack
 	m_commandStack.push(newMoveObject);
 
+	//The drag has already moved the object, so the command isn't executed - record the drop and flag the change here instead
+	SetScenePosition(*m_sceneGraph, movedObject->m_ID, &finalPosition.x);
+	m_changeTracker.ObjectModified(movedObject->m_ID);
+	m_journal.ObjectMoved(movedObject->m_ID, &finalPosition.x);
+
 	//Reset the drag start position here to be safe
 	m_dragStartPosition = Vector3::Zero;
 
@@ -494,7 +476,61 @@ void Game::MoveSelectedObjectEnd(int& selectedID, int movedObjectID)
 	m_currentDragActive = false;
 }//End MoveSelectedObjectEnd
 
-const std::vector<DisplayObject>& Game::GetDisplayList()
+void Game::CopyToClipboard(const DisplayObject& object)
+{
+	//Every column is copied, names, lights and the rest included, so the pasted object is a true duplicate
+	const int sceneIndex = m_sceneGraph->Find(object.m_ID);
+	if (sceneIndex == -1) return;
+
+	m_clipboard = m_sceneGraph->Duplicate(sceneIndex);
+	m_clipboardFull = true;
+}//End CopyToClipboard
+
+int Game::FindTransform(const int objectID) const
+{
+	const DisplayObject* object = m_displayList.Get(FindObject(objectID));
+	return object ? object->m_transform : TransformStore::NO_PARENT;
+}//End FindTransform
+
+void Game::ClearCommandHistory()
+{
+	while (!m_commandStack.empty())
+	{
+		delete m_commandStack.top();
+		m_commandStack.pop();
+	}//End while
+
+	ClearRedoStack();
+}//End ClearCommandHistory
+
+void Game::ClearRedoStack()
+{
+	//Deleting the commands lets them release the display list slots they were holding on to
+	while (!m_redoStack.empty())
+	{
+		delete m_redoStack.top();
+		m_redoStack.pop();
+	}//End while
+}//End ClearRedoStack
+
+ObjectHandle Game::FindObject(const int objectID) const
+{
+	for (uint32_t index = 0; index < m_displayList.GetNumSlots(); index++)
+	{
+		const DisplayObject* object = m_displayList.GetAt(index);
+		if (object && object->m_ID == objectID) return m_displayList.GetHandleAt(index);
+	}//End for
+
+	return ObjectHandle();
+}//End FindObject
+
+int Game::GetObjectID(const ObjectHandle object) const
+{
+	const DisplayObject* displayObject = m_displayList.Get(object);
+	return displayObject ? displayObject->m_ID : -1;
+}//End GetObjectID
+
+const SlotMap<DisplayObject>& Game::GetDisplayList()
 {
     return m_displayList;
 }//End GetDisplayList
@@ -506,6 +542,10 @@ void Game::Tick(const InputCommands *input)
 {
 	//Copy over input commands so we have a local version to use elsewhere
 	m_inputCommands = *input;
+
+	//Frame boundary - meshes and textures loaded since the last frame go into their caches before anything is updated or drawn
+	m_assetStreamer.ApplyCompletions();
+
     m_timer.Tick([&]()
     {
         m_camera->Update(*input);
@@ -531,6 +571,10 @@ void Game::Update(DX::StepTimer const& timer)
 	//Apply camera vectors
     m_view = Matrix::CreateLookAt(m_camera->m_camPosition, m_camera->m_camLookAt, Vector3::UnitY);
 
+	//Rebuild the matrices of objects edited since the last frame and everything attached to them, ready for rendering and picking
+	//Untouched objects cost nothing
+	m_transforms.UpdateWorldMatrices(&m_transformWorkers);
+
     m_batchEffect->SetView(m_view);
     m_batchEffect->SetWorld(Matrix::Identity);
 	m_displayChunk.m_terrainEffect->SetView(m_view);
@@ -585,41 +629,54 @@ void Game::Render()
 		}//End if
 
 		//RENDER OBJECTS FROM SCENEGRAPH
-	    const int numRenderObjects = m_displayList.size();
-		for (int i = 0; i < numRenderObjects; i++)
+	    const uint32_t numSlots = m_displayList.GetNumSlots();
+		int highlightedPlaceholder = -1;			//Transform slot of the selected object, if it is still a placeholder
+		for (uint32_t i = 0; i < numSlots; i++)
 		{
-			m_displayList[i].m_wireframe = m_wireframeMode;
+			//Empty slots belong to deleted or cut objects
+			DisplayObject* object = m_displayList.GetAt(i);
+			if (!object) continue;
+
+			//Objects still streaming in pick up their mesh and texture as soon as they are resident
+			if (!object->m_model || !object->m_texture_diffuse) ResolveStreamedAssets(*object);
+
+			object->m_wireframe = m_wireframeMode;
+			const bool highlighted = m_displayList.GetHandleAt(i) == m_highlightedObject;
+
+			//Until then they are boxes, drawn together once every model is done
+			if (!object->m_model)
+			{
+				m_placeholderTransforms.push_back(object->m_transform);
+				if (highlighted) highlightedPlaceholder = object->m_transform;
+				continue;
+			}//End if
 
 			m_deviceResources->PIXBeginEvent(L"Draw Model");
-			const XMVECTORF32 scale =
-	        {
-				m_displayList[i].m_scale.x,
-				m_displayList[i].m_scale.y,
-				m_displayList[i].m_scale.z
-	        };
-
-			const XMVECTORF32 translate =
-	        {
-				m_displayList[i].m_position.x,
-				m_displayList[i].m_position.y,
-				m_displayList[i].m_position.z
-	        };
-
-			//Convert degrees into radians for rotation matrix
-			const XMVECTOR rotate = Quaternion::CreateFromYawPitchRoll
-			(
-	            m_displayList[i].m_orientation.y * PI_SHORT / 180,
-	            m_displayList[i].m_orientation.x * PI_SHORT / 180,
-	            m_displayList[i].m_orientation.z * PI_SHORT / 180
-	        );
-
-			const XMMATRIX local = m_world * XMMatrixTransformation(g_XMZero, Quaternion::Identity, scale, g_XMZero, rotate, translate);
+			//m_world is never changed from identity, so the cached matrix is drawn as it is
+			const XMMATRIX local = LoadWorldMatrix(m_transforms, object->m_transform);
+
+			//The model is shared by every object using the same mesh, so this object's own state goes on for its draw only -
+			//the texture is bound after the model's effect has applied its own, and the highlight is switched on and back off
+			if (highlighted) SetHighlight(*object->m_model, true);
 
 			//Last variable in draw - make last boolean TRUE for wireframe mode
-			m_displayList[i].m_model->Draw(context, *m_states, local, m_view, m_projection, m_displayList[i].m_wireframe);
+			ID3D11ShaderResourceView* texture = object->m_texture_diffuse.GetResource().Get();
+			object->m_model->Draw(context, *m_states, local, m_view, m_projection, object->m_wireframe, [context, &texture]()
+			{
+				if (texture) context->PSSetShaderResources(0, 1, &texture);
+			});
+
+			if (highlighted) SetHighlight(*object->m_model, false);
 
 			m_deviceResources->PIXEndEvent();
 		}//End for
+
+		DrawPlaceholders(highlightedPlaceholder);
+		m_placeholderTransforms.clear();
+
+		//Every placeholder waiting on this frame's arrivals has them now
+		m_streamedModels.clear();
+		m_streamedTextures.clear();
     m_deviceResources->PIXEndEvent();
 
 	//RENDER TERRAIN
@@ -642,6 +699,16 @@ void Game::Render()
 		        L"            " +
 		        L"Cam Z: " + std::to_wstring(m_camera->m_camPosition.z);
 			m_font->DrawString(m_sprites.get(), cameraPositionText.c_str() , XMFLOAT2(100, 10), Colors::White);
+
+		    //MATRICES REBUILT THIS FRAME ON HUD
+		    const std::wstring matrixCountText = L"Matrices recomputed: " + std::to_wstring(m_transforms.GetNumRecomputed());
+			m_font->DrawString(m_sprites.get(), matrixCountText.c_str(), XMFLOAT2(100, 40), Colors::White);
+
+		    //MEMORY BY CATEGORY ON HUD - measuring walks every model and texture, so not every frame
+		    if (m_memoryText.empty() || m_timer.GetFrameCount() % 60 == 0) UpdateMemoryText();
+			m_font->DrawString(m_sprites.get(), m_memoryText.c_str(), XMFLOAT2(100, 70), Colors::White);
+			m_font->DrawString(m_sprites.get(), m_modelCacheText.c_str(), XMFLOAT2(100, 100), Colors::White);
+			m_font->DrawString(m_sprites.get(), m_textureCacheText.c_str(), XMFLOAT2(100, 130), Colors::White);
 		m_sprites->End();
     m_deviceResources->PIXEndEvent();
 
@@ -670,6 +737,43 @@ void Game::Clear()
     m_deviceResources->PIXEndEvent();
 }//End Clear
 
+void Game::DrawPlaceholders(const int highlightedTransform)
+{
+	if (m_placeholderTransforms.empty()) return;
+
+    m_deviceResources->PIXBeginEvent(L"Draw Placeholders");
+
+    auto context = m_deviceResources->GetD3DDeviceContext();
+    context->OMSetBlendState(m_states->Opaque(), nullptr, 0xFFFFFFFF);
+    context->OMSetDepthStencilState(m_states->DepthDefault(), 0);
+    context->RSSetState(m_states->CullNone());
+
+    m_batchEffect->Apply(context);
+
+    context->IASetInputLayout(m_batchInputLayout.Get());
+
+	//GetCorners gives the +z face then the -z face, each going round from the bottom left
+	XMFLOAT3 corners[BoundingBox::CORNER_COUNT];
+	PLACEHOLDER_BOUNDS.GetCorners(corners);
+	static const int EDGES[12][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+    m_batch->Begin();
+
+	for (const int transform : m_placeholderTransforms)
+	{
+		const XMMATRIX world = LoadWorldMatrix(m_transforms, transform);
+		const XMVECTOR color = transform == highlightedTransform ? Colors::Yellow : Colors::LightGray;
+
+		XMVECTOR points[BoundingBox::CORNER_COUNT];
+		for (int c = 0; c < BoundingBox::CORNER_COUNT; c++) points[c] = XMVector3TransformCoord(XMLoadFloat3(&corners[c]), world);
+		for (const int* edge : EDGES) m_batch->DrawLine(VertexPositionColor(points[edge[0]], color), VertexPositionColor(points[edge[1]], color));
+	}//End for
+
+    m_batch->End();
+
+    m_deviceResources->PIXEndEvent();
+}//End DrawPlaceholders
+
 void XM_CALLCONV Game::DrawGrid(FXMVECTOR xAxis, FXMVECTOR yAxis, FXMVECTOR origin, size_t xDivs, size_t yDivs, GXMVECTOR color)
 {
     m_deviceResources->PIXBeginEvent(L"Draw Grid");
@@ -752,83 +856,173 @@ void Game::OnWindowSizeChanged(const int width, const int height)
     CreateWindowSizeDependentResources();
 }//End OnWindowSizeChanged
 
-void Game::BuildDisplayList(const std::vector<SceneObject>* sceneGraph)
+void Game::RegisterMemorySources()
+{
+	MemoryTracker& tracker = MemoryTracker::GetInstance();
+	m_displayListMemory = tracker.Register(MemoryCategory::SCENE_RECORDS, "display list", [this]()
+	{
+		return m_displayList.GetMemoryUsage() + m_transforms.GetMemoryUsage();
+	});
+
+	//Every model still held, by display objects or undo history alike
+	m_meshMemory = tracker.Register(MemoryCategory::MESHES, "object models", [this]() { return m_modelCache.GetStats().residentBytes; });
+
+	//Object textures are each resident once in the cache however many objects use them - the terrain loads its own
+	m_textureMemory = tracker.Register(MemoryCategory::TEXTURES, "object and terrain textures", [this]()
+	{
+		size_t bytes = m_textureCache.GetStats().residentBytes;
+		if (m_displayChunk.m_texture_diffuse) bytes += TextureCache::GetTextureBytes(m_displayChunk.m_texture_diffuse);
+		return bytes;
+	});
+}//End RegisterMemorySources
+
+void Game::UpdateMemoryText()
+{
+	const MemoryTracker::Report report = MemoryTracker::GetInstance().GetReport();
+	m_memoryText = L"Memory (MB):";
+	for (int i = 0; i < static_cast<int>(MemoryCategory::COUNT); i++)
+	{
+		wchar_t megabytes[32];
+		swprintf_s(megabytes, L" %.2f", report.categories[i].GetTotal() / 1048576.0);
+		m_memoryText += L"   " + AssetPathTable::Utf8ToWide(MemoryTracker::GetCategoryName(static_cast<MemoryCategory>(i))) + megabytes;
+	}//End for
+
+	const ModelCache::Stats models = m_modelCache.GetStats();
+	m_modelCacheText = L"Models: " + std::to_wstring(models.numResident) + L" resident, " + std::to_wstring(models.misses) + L" loaded, " +
+		std::to_wstring(static_cast<int>(models.GetHitRate() * 100.0 + 0.5)) + L"% cache hits, " + std::to_wstring(m_assetStreamer.GetNumPending()) + L" loads streaming";
+
+	const TextureCache::Stats textures = m_textureCache.GetStats();
+	m_textureCacheText = L"Textures: " + std::to_wstring(textures.numResident) + L" resident, " + std::to_wstring(textures.misses) + L" loaded, " +
+		std::to_wstring(textures.failures) + L" missing, " + std::to_wstring(static_cast<int>(textures.GetHitRate() * 100.0 + 0.5)) + L"% cache hits";
+}//End UpdateMemoryText
+
+void Game::ResolveStreamedAssets(DisplayObject& object)
+{
+	if (!object.m_model)
+	{
+		object.m_model = m_modelCache.Find(object.m_modelPath);
+		if (!object.m_model) RequestModel(object.m_modelPath);
+	}//End if
+
+	//Paths that failed to load get the error texture
+	if (!object.m_texture_diffuse)
+	{
+		object.m_texture_diffuse = m_textureCache.Find(object.m_texturePath);
+		if (!object.m_texture_diffuse) RequestTexture(object.m_texturePath);
+	}//End if
+}//End ResolveStreamedAssets
+
+void Game::RequestModel(const AssetID modelPath)
+{
+	if (m_failedModels.count(modelPath) != 0 || !m_modelsInFlight.insert(modelPath).second) return;
+
+	m_assetStreamer.Submit([this, modelPath]()
+	{
+		//On a loader thread - parsing is CPU work only, so meshes are parsed side by side on every loader thread
+		std::shared_ptr<CMOModel> parsed = std::make_shared<CMOModel>();
+		if (!ModelCache::Parse(modelPath, *parsed)) parsed.reset();
+		const float radius = parsed ? parsed->GetBoundingRadius() : 0.0f;
+
+		//Back on the UI thread, where models are made one at a time and held until the placeholders waiting on them have
+		//picked them up - a mesh that can't be loaded leaves its objects as placeholders
+		return AssetStreamer::Completion([this, modelPath, parsed, radius]()
+		{
+			m_modelsInFlight.erase(modelPath);
+
+			//The spatial index only learns a mesh's size from here - a failure leaves its objects at the unit radius
+			if (parsed && m_database) m_database->SetModelRadius(AssetPathTable::GetInstance().GetPath(modelPath), radius);
+
+			std::shared_ptr<Model> model;
+			try
+			{
+				if (parsed) model = ModelCache::CreateModel(m_modelCache.GetDevice(), *parsed, *m_fxFactory);
+			}//End try
+			catch (const std::exception&)
+			{
+			}//End catch
+
+			if (model) m_streamedModels.push_back(m_modelCache.Insert(modelPath, model));
+			else m_failedModels.insert(modelPath);
+		});
+	});
+}//End RequestModel
+
+void Game::RequestTexture(const AssetID texturePath)
 {
-	const auto device = m_deviceResources->GetD3DDevice();
+	if (m_textureCache.Contains(texturePath) || !m_texturesInFlight.insert(texturePath).second) return;
+
+	ID3D11Device* device = m_deviceResources->GetD3DDevice();
+	m_assetStreamer.Submit([this, device, texturePath]()
+	{
+		TextureCache::Texture texture;
+		const bool loaded = texturePath != AssetPathTable::NO_ASSET && TextureCache::Load(device, texturePath, texture);
 
-	if (!m_displayList.empty()) m_displayList.clear();
+		return AssetStreamer::Completion([this, texturePath, loaded, texture]()
+		{
+			m_texturesInFlight.erase(texturePath);
+			m_streamedTextures.push_back(loaded ? m_textureCache.Insert(texturePath, texture) : m_textureCache.InsertMissing(texturePath));
+		});
+	});
+}//End RequestTexture
 
-	const int numObjects = sceneGraph->size();
+void Game::BuildDisplayList(SceneGraph& sceneGraph)
+{
+	//Transforms, the clipboard and the undo history all refer to the outgoing scene
+	//The history goes first so its commands release their slots before the list is emptied
+	ClearCommandHistory();
+	m_displayList.Clear();
+	m_transforms.Clear();
+	m_clipboard = SceneGraph::Entry();
+	m_clipboardFull = false;
+	m_sceneGraph = &sceneGraph;
+
+	//Freshly loaded objects match the database, so there is nothing to save yet
+	m_changeTracker.Clear();
+
+	//A new level gets another try at meshes that failed to load
+	m_failedModels.clear();
+
+	const int numObjects = sceneGraph.GetSize();
+	std::unordered_map<int, int> transformSlots;			//Object ID to transform slot, for linking parents
+	transformSlots.reserve(numObjects);
     //For every item in the SceneGraph
 	for (int i = 0; i < numObjects; i++)
 	{
+		//Only the hot records are needed here, so cold records stay unloaded
+		const SceneObjectHot& sceneObject = sceneGraph.GetHot(i);
+
 		//Create a temporary display object that we will populate then append to the display list
 		DisplayObject newDisplayObject;
+		newDisplayObject.m_ID = sceneObject.ID;
 		
-		//Load the model
-		std::wstring modelwstr = StringToWCHART(sceneGraph->at(i).model_path);
-        newDisplayObject.m_model_path = modelwstr;
-        //Get DXSDK to load model
-        //Set final boolean to "false" for left-handed coordinate system (Maya)
-		newDisplayObject.m_model = Model::CreateFromCMO(device, modelwstr.c_str(), *m_fxFactory, true);	
-
-		//Load diffuse texture
-		std::wstring texturewstr = StringToWCHART(sceneGraph->at(i).tex_diffuse_path);
-        newDisplayObject.m_texture_diffuse_path = texturewstr;
-        //Load texture into shader resource
-		const HRESULT rs = CreateDDSTextureFromFile(device, texturewstr.c_str(), nullptr, &newDisplayObject.m_texture_diffuse);	
-
-		//If texture loading fails, load error default
-		if (rs)
-		{
-            //Load texture into shader resource
-			CreateDDSTextureFromFile(device, L"database/data/Error.dds", nullptr, &newDisplayObject.m_texture_diffuse);
-		}//End if
+		//Every object using the same mesh shares one model, and likewise one texture - those not yet resident are loaded on
+		//the loader threads while the object waits as a placeholder, so building the list never waits on a file
+		newDisplayObject.m_modelPath = sceneObject.model_path;
+		newDisplayObject.m_texturePath = sceneObject.tex_diffuse_path;
+		ResolveStreamedAssets(newDisplayObject);
+
+		//Set position, orientation and scale
+		newDisplayObject.m_transform = m_transforms.Allocate();
+		m_transforms.SetPosition(newDisplayObject.m_transform, &sceneObject.posX);
+		m_transforms.SetOrientation(newDisplayObject.m_transform, &sceneObject.rotX);
+		m_transforms.SetScale(newDisplayObject.m_transform, &sceneObject.scaX);
 
-		//Apply new texture to model's effect
-        //Handled using an in-line function via Lambda
-		newDisplayObject.m_model->UpdateEffects([&](IEffect* effect)
-		{
-			const auto lights = dynamic_cast<BasicEffect*>(effect);
-			if (lights)
-			{
-				lights->SetTexture(newDisplayObject.m_texture_diffuse);			
-			}//End if
-		});
+		//Set wireframe/render flags
+		newDisplayObject.m_render		= sceneObject.GetFlag(EDITOR_RENDER);
+		newDisplayObject.m_wireframe	= sceneObject.GetFlag(EDITOR_WIREFRAME);
 
-		//Set position
-		newDisplayObject.m_position.x = sceneGraph->at(i).posX;
-		newDisplayObject.m_position.y = sceneGraph->at(i).posY;
-		newDisplayObject.m_position.z = sceneGraph->at(i).posZ;
-		
-		//Set orientation
-		newDisplayObject.m_orientation.x = sceneGraph->at(i).rotX;
-		newDisplayObject.m_orientation.y = sceneGraph->at(i).rotY;
-		newDisplayObject.m_orientation.z = sceneGraph->at(i).rotZ;
+		transformSlots.emplace(newDisplayObject.m_ID, newDisplayObject.m_transform);
+		m_displayList.Insert(std::move(newDisplayObject));
+	}//End for
 
-		//Set scale
-		newDisplayObject.m_scale.x = sceneGraph->at(i).scaX;
-		newDisplayObject.m_scale.y = sceneGraph->at(i).scaY;
-		newDisplayObject.m_scale.z = sceneGraph->at(i).scaZ;
+	//Attach children once every object has a slot - parents missing from the chunk, or that would form a cycle, leave the child a root
+	for (int i = 0; i < numObjects; i++)
+	{
+		const SceneObjectHot& sceneObject = sceneGraph.GetHot(i);
+		if (sceneObject.parent_id == 0) continue;
 
-		//Set wireframe/render flags
-		newDisplayObject.m_render		= sceneGraph->at(i).editor_render;
-		newDisplayObject.m_wireframe	= sceneGraph->at(i).editor_wireframe;
-
-        //Set light data
-		newDisplayObject.m_light_type		    = sceneGraph->at(i).light_type;
-		newDisplayObject.m_light_diffuse_r	    = sceneGraph->at(i).light_diffuse_r;
-		newDisplayObject.m_light_diffuse_g	    = sceneGraph->at(i).light_diffuse_g;
-		newDisplayObject.m_light_diffuse_b	    = sceneGraph->at(i).light_diffuse_b;
-		newDisplayObject.m_light_specular_r     = sceneGraph->at(i).light_specular_r;
-		newDisplayObject.m_light_specular_g     = sceneGraph->at(i).light_specular_g;
-		newDisplayObject.m_light_specular_b     = sceneGraph->at(i).light_specular_b;
-		newDisplayObject.m_light_spot_cutoff    = sceneGraph->at(i).light_spot_cutoff;
-		newDisplayObject.m_light_constant	    = sceneGraph->at(i).light_constant;
-		newDisplayObject.m_light_linear		    = sceneGraph->at(i).light_linear;
-		newDisplayObject.m_light_quadratic	    = sceneGraph->at(i).light_quadratic;
-		
-		m_displayList.push_back(newDisplayObject);
+		const auto parentSlot = transformSlots.find(sceneObject.parent_id);
+		if (parentSlot != transformSlots.end()) m_transforms.SetParent(transformSlots[sceneObject.ID], parentSlot->second);
 	}//End for
 }//End BuildDisplayList
 
@@ -868,11 +1062,10 @@ void Game::CreateDeviceDependentResources()
 
     m_states = std::make_unique<CommonStates>(device);
 
-    m_fxFactory = std::make_unique<EffectFactory>(device);
-    //Look in the database directory
-	m_fxFactory->SetDirectory(L"database/data/");
-    //We must set this to false - otherwise, it will share effects based on the initial texture loaded (when the model loads) rather than what we change them to
-	m_fxFactory->SetSharing(false);
+    //Look in the database directory, with effects of each model's own as the model cache's loads have
+    m_fxFactory = ModelCache::CreateEffectFactory(device);
+	m_modelCache.SetDevice(device);
+	m_textureCache.SetDevice(device);
 
     m_sprites = std::make_unique<SpriteBatch>(context);
 
@@ -896,7 +1089,9 @@ void Game::CreateDeviceDependentResources()
     m_font = std::make_unique<SpriteFont>(device, L"Resources/SegoeUI_18.spritefont");
 
     //SDKMESH has to use clockwise winding with right-handed coordinates, so textures are flipped in the U-axis
-    m_model = Model::CreateFromSDKMESH(device, L"Resources/tiny.sdkmesh", *m_fxFactory);
+    MappedFile modelFile;
+    if (!modelFile.Open(L"Resources/tiny.sdkmesh")) throw std::runtime_error("Can't open Resources/tiny.sdkmesh");
+    m_model = Model::CreateFromSDKMESH(device, modelFile.GetData(), modelFile.GetSize(), *m_fxFactory);
 	
     //Load textures
     DX::ThrowIfFailed(
@@ -934,6 +1129,14 @@ void Game::CreateWindowSizeDependentResources()
 
 void Game::OnDeviceLost()
 {
+	//Loads in flight were made on the outgoing device
+	m_assetStreamer.Cancel();
+	m_modelsInFlight.clear();
+	m_texturesInFlight.clear();
+	m_streamedModels.clear();
+	m_streamedTextures.clear();
+	m_modelCache.SetDevice(nullptr);
+	m_textureCache.SetDevice(nullptr);
     m_states.reset();
     m_fxFactory.reset();
     m_sprites.reset();
@@ -957,17 +1160,6 @@ void Game::OnDeviceRestored()
 
 std::wstring StringToWCHART(const std::string s)
 {
-	const int slength = static_cast<int>(s.length()) + 1;
-	const int len = MultiByteToWideChar(CP_ACP, 0, s.c_str(), slength, nullptr, 0);
-	wchar_t* buf = new wchar_t[len];
-	MultiByteToWideChar(CP_ACP, 0, s.c_str(), slength, buf, len);
-	std::wstring r(buf);
-	delete[] buf;
-	return r;
+	//The database stores UTF-8, so decode it as such rather than through the ANSI code page
+	return AssetPathTable::Utf8ToWide(s);
 }//End StringToWCHART
-
-std::string WCHARTToString(std::wstring ws)
-{
-	string str(ws.begin(), ws.end());
-	return str;
-}//End WCHARTToString
@@ -5,17 +5,30 @@
 
 #include "DeviceResources.h"
 #include "StepTimer.h"
-#include "../Tool/SceneObject.h"
+#include "../Tool/SceneGraph.h"
 #include "DisplayObject.h"
 #include "DisplayChunk.h"
+#include "ModelCache.h"
+#include "TextureCache.h"
 #include "../Tool/ChunkObject.h"
 #include "../Tool/InputCommands.h"
 #include "../Tool/Commands/Command.h"
+#include "../Tool/SceneChangeTracker.h"
+#include "../Tool/EditJournal.h"
+#include "../Tool/TransformStore.h"
+#include "../Tool/WorkerPool.h"
+#include "../Tool/SlotMap.h"
+#include "../Tool/MemoryTracker.h"
+#include "../Tool/ObjectIDAllocator.h"
+#include "../Tool/AssetStreamer.h"
+#include <unordered_set>
 #include <vector>
 #include <stack>
 
 #include "../Tool/Camera.h"
 
+class SceneDatabase;
+
 //A basic game implementation that creates a D3D11 device and provides a game loop
 class Game : public DX::IDeviceNotify
 {
@@ -46,26 +59,32 @@ public:
 	void OnWindowSizeChanged(int width, int height);
 
 	//Tool-specific
-	void BuildDisplayList(const std::vector<SceneObject>* sceneGraph);
+	void BuildDisplayList(SceneGraph& sceneGraph);			//The graph stays the owner of every object's records - edits write straight into it
+	void SetObjectIDAllocator(ObjectIDAllocator* allocator) { m_idAllocator = allocator; }
+	void SetSceneDatabase(SceneDatabase* database) { m_database = database; }	//Where loaded models' bounding radii are recorded
 	void BuildDisplayChunk(const ChunkObject* sceneChunk);
 	void SaveDisplayChunk(ChunkObject* sceneChunk);
 	void ClearDisplayList();
 	void ToggleWireframe();
 
 	//Functionality
-	int MousePicking() const;
-	void MoveSelectedObject(int selectedID);
-	void HighlightSelectedObject(int previousSelectedID, int newSelectedID) const;
-	void MoveSelectedObjectStart(int& selectedID) const;
-	void MoveSelectedObjectEnd(int& selectedID, int movedObjectID);
-	void Delete(int& selectedID);
-	void Copy(int selectedID);
-	void Cut(int& selectedID);
+	ObjectHandle MousePicking() const;
+	void MoveSelectedObject(ObjectHandle selected);
+	void HighlightSelectedObject(ObjectHandle previousSelected, ObjectHandle newSelected) const;
+	void MoveSelectedObjectStart(ObjectHandle& selected) const;
+	void MoveSelectedObjectEnd(ObjectHandle& selected, ObjectHandle movedObject);
+	void Delete(ObjectHandle& selected);
+	void Copy(ObjectHandle selected);
+	void Cut(ObjectHandle& selected);
 	void Paste();
-	void Undo(int previousSelectedID, const int& currentSelectedID);
-	void Redo(int previousSelectedID, const int& currentSelectedID);
-	const std::vector<DisplayObject>& GetDisplayList();
+	void Undo(ObjectHandle previousSelected, const ObjectHandle& currentSelected);
+	void Redo(ObjectHandle previousSelected, const ObjectHandle& currentSelected);
+	ObjectHandle FindObject(int objectID) const;			//Handle of the display object with a database ID, null if there isn't one
+	int GetObjectID(ObjectHandle object) const;				//Database ID behind a handle, -1 if the handle is null or stale
+	const SlotMap<DisplayObject>& GetDisplayList();
 	const bool& GetCurrentDragActive() const { return m_currentDragActive; }
+	SceneChangeTracker& GetChangeTracker() { return m_changeTracker; }
+	EditJournal& GetEditJournal() { return m_journal; }
 
 #ifdef DXTK_AUDIO
 	void NewAudioDevice();
@@ -77,10 +96,36 @@ private:
 	void CreateDeviceDependentResources();
 	void CreateWindowSizeDependentResources();
 
+	void ClearCommandHistory();
+	void ClearRedoStack();
+	void CopyToClipboard(const DisplayObject& object);
+	int FindTransform(int objectID) const;					//Transform slot of the display object with a database ID, NO_PARENT if there isn't one
+	void RegisterMemorySources();							//Report the display list, meshes and textures to the memory tracker
+	void UpdateMemoryText();
+
+	//Asset streaming - requests skip paths already loading, or that failed to
+	void ResolveStreamedAssets(DisplayObject& object);		//Take the object's mesh and texture from the caches, requesting any not resident
+	void RequestModel(AssetID modelPath);
+	void RequestTexture(AssetID texturePath);
+	void DrawPlaceholders(int highlightedTransform);
+
 	void XM_CALLCONV DrawGrid(DirectX::FXMVECTOR xAxis, DirectX::FXMVECTOR yAxis, DirectX::FXMVECTOR origin, size_t xDivs, size_t yDivs, DirectX::GXMVECTOR color);
 
 	//Tool-specific
-	std::vector<DisplayObject>		m_displayList{};
+	SceneGraph*						m_sceneGraph;			//ToolMain's, viewed rather than copied - null until a display list is built
+	SlotMap<DisplayObject>			m_displayList;			//Indexed by handle, so entries never shift
+	ModelCache						m_modelCache;			//One model per mesh path, shared by the display list and undo history
+	TextureCache					m_textureCache;			//Likewise one texture per path
+	AssetStreamer					m_assetStreamer;		//Loads meshes and textures off the UI thread, applied at the start of each frame
+	std::unordered_set<AssetID>		m_modelsInFlight;		//Requested and not yet applied, so each path is only loaded once
+	std::unordered_set<AssetID>		m_texturesInFlight;
+	std::unordered_set<AssetID>		m_failedModels;			//Not tried again until the next level is built
+	std::vector<std::shared_ptr<DirectX::Model>>	m_streamedModels;		//Arrived this frame - held until the placeholders waiting on them
+	std::vector<TextureCache::Handle>				m_streamedTextures;		//have picked them up, as the caches don't keep them alive
+	std::vector<int>				m_placeholderTransforms;	//Objects drawn as boxes this frame
+	mutable ObjectHandle			m_highlightedObject;	//Drawn highlighted - only draw-time state, so the const selection queries may change it
+	TransformStore					m_transforms;			//Every display object's transform, referenced by slot
+	WorkerPool						m_transformWorkers;		//Shares out each level of a hierarchy update
 	DisplayChunk					m_displayChunk;
 	InputCommands					m_inputCommands{};
 	bool							m_wireframeMode;
@@ -91,12 +136,19 @@ private:
 	//Camera
 	std::unique_ptr<Camera>			m_camera{};
 
-	//Copy/paste
-	DisplayObject					m_objectToCopy;
+	//Copy/paste - the clipboard holds its own copy of the records, so editing the original afterwards doesn't change what gets pasted
+	SceneGraph::Entry				m_clipboard;
+	bool							m_clipboardFull;
 
 	//Undo/redo
-	std::stack<Command*>			m_commandStack{};
-	std::stack<Command*>			m_redoStack{};
+	CommandStack					m_commandStack{};
+	CommandStack					m_redoStack{};
+
+	//Objects edited since the last save, fed by the commands above
+	SceneChangeTracker				m_changeTracker;
+	EditJournal						m_journal;				//Crash-recovery log of the same edits
+	ObjectIDAllocator*				m_idAllocator;			//ToolMain's - where pasted objects get their IDs
+	SceneDatabase*					m_database;				//ToolMain's - the spatial index bounds objects by their model's radius
 
 	//Object movement with mouse
 	static float							m_previousDistance;
@@ -149,7 +201,14 @@ private:
     DirectX::SimpleMath::Matrix                                             m_world;
     DirectX::SimpleMath::Matrix                                             m_view;
     DirectX::SimpleMath::Matrix                                             m_projection;
+
+	//Memory report sources - last, so they unregister before anything they measure is destroyed
+	MemoryTracker::Registration		m_displayListMemory;
+	MemoryTracker::Registration		m_meshMemory;
+	MemoryTracker::Registration		m_textureMemory;
+	std::wstring					m_memoryText;			//HUD lines, remeasured about once a second
+	std::wstring					m_modelCacheText;
+	std::wstring					m_textureCacheText;
 };
 
-std::wstring StringToWCHART(std::string s);
-std::string WCHARTToString(std::wstring ws);
\ No newline at end of file
+std::wstring StringToWCHART(std::string s);
\ No newline at end of file
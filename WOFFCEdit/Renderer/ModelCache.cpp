@@ -0,0 +1,189 @@
+#include "ModelCache.h"
+#include "../Tool/MappedFile.h"
+#include <unordered_set>
+
+using namespace DirectX;
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+	ComPtr<ID3D11Buffer> CreateBuffer(ID3D11Device* device, const void* data, const size_t bytes, const UINT bindFlags)
+	{
+		D3D11_BUFFER_DESC desc = {};
+		desc.Usage = D3D11_USAGE_DEFAULT;
+		desc.ByteWidth = static_cast<UINT>(bytes);
+		desc.BindFlags = bindFlags;
+
+		D3D11_SUBRESOURCE_DATA initData = {};
+		initData.pSysMem = data;
+
+		ComPtr<ID3D11Buffer> buffer;
+		DX::ThrowIfFailed(device->CreateBuffer(&desc, &initData, buffer.GetAddressOf()));
+		return buffer;
+	}//End CreateBuffer
+}
+
+ModelCache::ModelCache() : m_device(nullptr), m_hits(0), m_misses(0)
+{
+}//End default constructor
+
+void ModelCache::SetDevice(ID3D11Device* device)
+{
+	m_device = device;
+	m_entries.clear();
+}//End SetDevice
+
+std::shared_ptr<Model> ModelCache::Find(const AssetID modelPath)
+{
+	const auto found = m_entries.find(modelPath);
+	if (found == m_entries.end()) return nullptr;
+
+	//Every object using it may have gone since it was loaded
+	std::shared_ptr<Model> model = found->second.model.lock();
+	if (model) m_hits++;
+	return model;
+}//End Find
+
+std::shared_ptr<Model> ModelCache::Insert(const AssetID modelPath, std::shared_ptr<Model> model)
+{
+	m_misses++;
+	Entry& entry = m_entries[modelPath];
+	if (std::shared_ptr<Model> resident = entry.model.lock()) return resident;
+
+	entry.model = model;
+	entry.bytes = model ? GetModelBytes(*model) : 0;
+	return model;
+}//End Insert
+
+ModelCache::Stats ModelCache::GetStats() const
+{
+	Stats stats = {};
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+
+	for (const auto& entry : m_entries)
+	{
+		if (entry.second.model.expired()) continue;
+
+		stats.numResident++;
+		stats.residentBytes += entry.second.bytes;
+	}//End for
+
+	return stats;
+}//End GetStats
+
+bool ModelCache::Parse(const AssetID modelPath, CMOModel& model)
+{
+	MappedFile file;
+	return file.Open(AssetPathTable::GetInstance().GetWidePath(modelPath).c_str()) && model.Parse(file.GetData(), file.GetSize());
+}//End Parse
+
+std::unique_ptr<Model> ModelCache::CreateModel(ID3D11Device* device, const CMOModel& model, IEffectFactory& effectFactory)
+{
+	//Every part of a kind shares one declaration, as it does in models DirectXTK loads
+	static const std::shared_ptr<std::vector<D3D11_INPUT_ELEMENT_DESC>> vertexDeclaration = std::make_shared<std::vector<D3D11_INPUT_ELEMENT_DESC>>(
+		VertexPositionNormalTangentColorTexture::InputElements, VertexPositionNormalTangentColorTexture::InputElements + VertexPositionNormalTangentColorTexture::InputElementCount);
+	static const std::shared_ptr<std::vector<D3D11_INPUT_ELEMENT_DESC>> skinnedVertexDeclaration = std::make_shared<std::vector<D3D11_INPUT_ELEMENT_DESC>>(
+		VertexPositionNormalTangentColorTextureSkinning::InputElements, VertexPositionNormalTangentColorTextureSkinning::InputElements + VertexPositionNormalTangentColorTextureSkinning::InputElementCount);
+
+	std::unique_ptr<Model> created = std::make_unique<Model>();
+	for (const CMOModel::Mesh& parsedMesh : model.meshes)
+	{
+		std::shared_ptr<ModelMesh> mesh = std::make_shared<ModelMesh>();
+		mesh->name = parsedMesh.name;
+		mesh->ccw = true;							//Right-handed, as CMO files from Visual Studio are
+		mesh->pmalpha = false;
+		mesh->boundingSphere.Center = XMFLOAT3(parsedMesh.sphereCenter);
+		mesh->boundingSphere.Radius = parsedMesh.sphereRadius;
+		const XMFLOAT3 boxMin(parsedMesh.boxMin), boxMax(parsedMesh.boxMax);
+		BoundingBox::CreateFromPoints(mesh->boundingBox, XMLoadFloat3(&boxMin), XMLoadFloat3(&boxMax));
+
+		std::vector<ComPtr<ID3D11Buffer>> indexBuffers, vertexBuffers;
+		for (const std::vector<uint16_t>& indices : parsedMesh.indexBuffers)
+		{
+			indexBuffers.push_back(CreateBuffer(device, indices.data(), indices.size() * sizeof(uint16_t), D3D11_BIND_INDEX_BUFFER));
+		}//End for
+		for (const std::vector<uint8_t>& vertices : parsedMesh.vertexBuffers)
+		{
+			vertexBuffers.push_back(CreateBuffer(device, vertices.data(), vertices.size(), D3D11_BIND_VERTEX_BUFFER));
+		}//End for
+
+		//An effect and input layout per material
+		std::vector<std::shared_ptr<IEffect>> effects;
+		std::vector<ComPtr<ID3D11InputLayout>> inputLayouts;
+		for (const CMOModel::Material& material : parsedMesh.materials)
+		{
+			IEffectFactory::EffectInfo info;
+			info.name = material.name.c_str();
+			info.specularPower = material.specularPower;
+			info.perVertexColor = true;
+			info.enableSkinning = parsedMesh.skinned;
+			info.alpha = material.diffuse[3];
+			info.ambientColor = XMFLOAT3(material.ambient);
+			info.diffuseColor = XMFLOAT3(material.diffuse);
+			info.specularColor = XMFLOAT3(material.specular);
+			info.emissiveColor = XMFLOAT3(material.emissive);
+			info.diffuseTexture = material.textures[0].c_str();
+			effects.push_back(effectFactory.CreateEffect(info, nullptr));
+
+			const void* shaderByteCode;
+			size_t byteCodeLength;
+			effects.back()->GetVertexShaderBytecode(&shaderByteCode, &byteCodeLength);
+
+			ComPtr<ID3D11InputLayout> inputLayout;
+			const std::vector<D3D11_INPUT_ELEMENT_DESC>& declaration = parsedMesh.skinned ? *skinnedVertexDeclaration : *vertexDeclaration;
+			DX::ThrowIfFailed(device->CreateInputLayout(declaration.data(), static_cast<UINT>(declaration.size()), shaderByteCode, byteCodeLength, inputLayout.GetAddressOf()));
+			inputLayouts.push_back(inputLayout);
+		}//End for
+
+		for (const CMOModel::Part& parsedPart : parsedMesh.parts)
+		{
+			std::unique_ptr<ModelMeshPart> part(new ModelMeshPart());
+			part->isAlpha = parsedMesh.materials[parsedPart.materialIndex].diffuse[3] < 1.0f;
+			part->indexCount = parsedPart.indexCount;
+			part->startIndex = parsedPart.startIndex;
+			part->vertexStride = static_cast<UINT>(parsedMesh.GetVertexStride());
+			part->inputLayout = inputLayouts[parsedPart.materialIndex];
+			part->indexBuffer = indexBuffers[parsedPart.indexBufferIndex];
+			part->vertexBuffer = vertexBuffers[parsedPart.vertexBufferIndex];
+			part->effect = effects[parsedPart.materialIndex];
+			part->vbDecl = parsedMesh.skinned ? skinnedVertexDeclaration : vertexDeclaration;
+			mesh->meshParts.push_back(std::move(part));
+		}//End for
+
+		created->meshes.push_back(mesh);
+	}//End for
+
+	return created;
+}//End CreateModel
+
+std::unique_ptr<EffectFactory> ModelCache::CreateEffectFactory(ID3D11Device* device)
+{
+	std::unique_ptr<EffectFactory> effectFactory = std::make_unique<EffectFactory>(device);
+	effectFactory->SetDirectory(L"database/data/");
+	effectFactory->SetSharing(false);
+	return effectFactory;
+}//End CreateEffectFactory
+
+size_t ModelCache::GetModelBytes(const Model& model)
+{
+	std::unordered_set<ID3D11Buffer*> counted;
+	size_t bytes = 0;
+	for (const std::shared_ptr<ModelMesh>& mesh : model.meshes)
+	{
+		for (const std::unique_ptr<ModelMeshPart>& part : mesh->meshParts)
+		{
+			ID3D11Buffer* const buffers[] = { part->indexBuffer.Get(), part->vertexBuffer.Get() };
+			for (ID3D11Buffer* buffer : buffers)
+			{
+				if (!buffer || !counted.insert(buffer).second) continue;
+
+				D3D11_BUFFER_DESC desc;
+				buffer->GetDesc(&desc);
+				bytes += desc.ByteWidth;
+			}//End for
+		}//End for
+	}//End for
+
+	return bytes;
+}//End GetModelBytes
@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+#include "../Tool/AssetPathTable.h"
+#include "../Tool/CMOModel.h"
+#include <unordered_map>
+
+//Models loaded from CMO files, one per asset path, shared by every display object that uses it
+//The cache only keeps a weak reference, so a model is released along with the last object - or undo command - holding it
+//A shared model is never changed for one object - textures, highlighting and wireframe live on the DisplayObject and Game
+//applies them as each object is drawn
+//Models are parsed on the asset streamer's loader threads, then made and inserted here on the UI thread as they arrive
+class ModelCache
+{
+public:
+	struct Stats
+	{
+		int		hits;
+		int		misses;								//Each one a CMO parse
+		int		numResident;						//Models some object still holds
+		size_t	residentBytes;						//Their vertex and index buffers
+
+		double	GetHitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+	};
+
+	ModelCache();
+
+	//Models belong to the device that made them, so this also forgets every model loaded so far
+	void			SetDevice(ID3D11Device* device);
+	ID3D11Device*	GetDevice() const { return m_device; }
+
+	//The path's model if some object still holds it - nullptr, counting nothing, if it isn't resident
+	std::shared_ptr<DirectX::Model>	Find(AssetID modelPath);
+
+	//A model loaded on a loader thread - if the path became resident in the meantime that copy is kept and returned
+	std::shared_ptr<DirectX::Model>	Insert(AssetID modelPath, std::shared_ptr<DirectX::Model> model);
+
+	Stats	GetStats() const;
+
+	//Maps the CMO file and parses it in place - touches nothing but the file, so loader threads call it, any number at once.
+	//False if the file can't be opened or isn't a CMO model
+	static bool	Parse(AssetID modelPath, CMOModel& model);
+
+	//Makes a parsed model's buffers, effects and input layouts - the short serial end of a load, run on the UI thread so models
+	//are made one at a time. Throws if the device can't make them
+	static std::unique_ptr<DirectX::Model>	CreateModel(ID3D11Device* device, const CMOModel& model, DirectX::IEffectFactory& effectFactory);
+
+	//Looks for textures in the database directory, and gives each model its own effects so highlighting one model's objects
+	//leaves other models alone
+	static std::unique_ptr<DirectX::EffectFactory>	CreateEffectFactory(ID3D11Device* device);
+
+	static size_t	GetModelBytes(const DirectX::Model& model);		//Vertex and index buffers, each counted once
+
+private:
+	struct Entry
+	{
+		std::weak_ptr<DirectX::Model>	model;
+		size_t							bytes;
+	};
+
+	ID3D11Device*						m_device;
+	std::unordered_map<AssetID, Entry>	m_entries;
+	int									m_hits;
+	int									m_misses;
+};
@@ -0,0 +1,78 @@
+#include "TextureCache.h"
+#include "../Tool/MappedFile.h"
+
+using namespace DirectX;
+using Microsoft::WRL::ComPtr;
+
+TextureCache::TextureCache()
+	: m_device(nullptr),
+	m_textures([this](const AssetID path, Texture& texture) { return m_device && Load(m_device, path, texture); },
+		[](const Texture& texture) { return GetTextureBytes(texture.Get()); },
+		AssetPathTable::GetInstance().Intern(std::string("database/data/Error.dds")))
+{
+}//End default constructor
+
+void TextureCache::SetDevice(ID3D11Device* device)
+{
+	m_device = device;
+	m_textures.Clear();
+}//End SetDevice
+
+bool TextureCache::Load(ID3D11Device* device, const AssetID texturePath, Texture& texture)
+{
+	//Mapped rather than read into a heap copy - the texture is made from the mapping before it's unmapped
+	MappedFile file;
+	if (!file.Open(AssetPathTable::GetInstance().GetWidePath(texturePath).c_str())) return false;
+
+	return SUCCEEDED(CreateDDSTextureFromMemory(device, file.GetData(), file.GetSize(), nullptr, texture.ReleaseAndGetAddressOf()));
+}//End Load
+
+size_t TextureCache::GetTextureBytes(ID3D11ShaderResourceView* view)
+{
+	ComPtr<ID3D11Resource> resource;
+	view->GetResource(&resource);
+	ComPtr<ID3D11Texture2D> texture;
+	if (FAILED(resource.As(&texture))) return 0;
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+
+	//Block-compressed formats store each 4x4 block of texels in 8 or 16 bytes
+	size_t blockBytes = 0;
+	size_t texelBytes = 4;
+	switch (desc.Format)
+	{
+	case DXGI_FORMAT_BC1_TYPELESS: case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_TYPELESS: case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM:
+		blockBytes = 8;
+		break;
+	case DXGI_FORMAT_BC2_TYPELESS: case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_TYPELESS: case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC5_TYPELESS: case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC6H_TYPELESS: case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16:
+	case DXGI_FORMAT_BC7_TYPELESS: case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+		blockBytes = 16;
+		break;
+	case DXGI_FORMAT_R8_UNORM: case DXGI_FORMAT_A8_UNORM:
+		texelBytes = 1;
+		break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT: case DXGI_FORMAT_R16G16B16A16_UNORM:
+		texelBytes = 8;
+		break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		texelBytes = 16;
+		break;
+	default:
+		break;		//Everything else the editor loads is 32 bits a texel
+	}//End switch
+
+	size_t bytes = 0;
+	for (UINT mip = 0; mip < desc.MipLevels; mip++)
+	{
+		const size_t width = std::max<UINT>(desc.Width >> mip, 1);
+		const size_t height = std::max<UINT>(desc.Height >> mip, 1);
+		bytes += blockBytes ? ((width + 3) / 4) * ((height + 3) / 4) * blockBytes : width * height * texelBytes;
+	}//End for
+
+	return bytes * desc.ArraySize;
+}//End GetTextureBytes
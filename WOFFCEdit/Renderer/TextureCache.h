@@ -0,0 +1,41 @@
+#pragma once
+#include "pch.h"
+#include "../Tool/ResourceCache.h"
+
+//Diffuse textures loaded from DDS files, one per asset path, shared by every display object that uses it
+//The path lookup, counting and eviction are ResourceCache's - this supplies the device, the loader and the measure
+//Textures are loaded on the asset streamer's loader threads and inserted here on the UI thread as they arrive. Those that fail
+//to load all share one copy of database/data/Error.dds
+class TextureCache
+{
+public:
+	using Texture = Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>;
+	using Handle = ResourceCache<Texture>::Handle;
+	using Stats = ResourceCache<Texture>::Stats;
+
+	TextureCache();
+
+	//Textures belong to the device that made them, so this also forgets every texture loaded so far
+	void			SetDevice(ID3D11Device* device);
+	ID3D11Device*	GetDevice() const { return m_device; }
+
+	//The path's texture, or the error texture if it failed to load - a null handle, counting nothing, if it hasn't been loaded
+	Handle	Find(AssetID texturePath)				{ return m_textures.Find(texturePath); }
+	bool	Contains(AssetID texturePath) const		{ return m_textures.Contains(texturePath); }	//Loaded, or known to be missing
+
+	//Results of loads made on a loader thread
+	Handle	Insert(AssetID texturePath, Texture texture)	{ return m_textures.Insert(texturePath, std::move(texture)); }
+	Handle	InsertMissing(AssetID texturePath)				{ return m_textures.InsertMissing(texturePath); }	//Gets the error texture
+
+	Stats	GetStats() const { return m_textures.GetStats(); }
+
+	//Loads the DDS file into a new texture - touches nothing but the device, which is free-threaded, so loader threads call it
+	static bool		Load(ID3D11Device* device, AssetID texturePath, Texture& texture);
+
+	static size_t	GetTextureBytes(ID3D11ShaderResourceView* view);	//Every mip of every array slice at its format's storage rate
+
+private:
+
+	ID3D11Device*			m_device;
+	ResourceCache<Texture>	m_textures;
+};
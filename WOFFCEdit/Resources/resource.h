@@ -24,13 +24,19 @@
 #define ID_BUTTON_WIREFRAME             40013
 #define ID_BUTTON_SAVE                  40014
 #define ID_VIEW_WIREFRAME               40015
+#define ID_AUTOSAVE_OFF                 40016
+#define ID_AUTOSAVE_30S                 40017
+#define ID_AUTOSAVE_1MIN                40018
+#define ID_AUTOSAVE_5MIN                40019
+#define ID_CHUNK_FIRST                  40100
+#define ID_CHUNK_LAST                   40355
 
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        111
-#define _APS_NEXT_COMMAND_VALUE         40016
+#define _APS_NEXT_COMMAND_VALUE         40020
 #define _APS_NEXT_CONTROL_VALUE         1002
 #define _APS_NEXT_SYMED_VALUE           102
 #endif
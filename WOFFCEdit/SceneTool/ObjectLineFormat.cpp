@@ -0,0 +1,323 @@
+#include "ObjectLineFormat.h"
+#include "../Tool/SceneSchema.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using SceneSchema::FieldType;
+
+static void WriteString(const std::string& text, std::string& out)
+{
+	static const char HEX[] = "0123456789abcdef";
+
+	out += '"';
+	for (const char c : text)
+	{
+		switch (c)
+		{
+			case '"':	out += "\\\"";	break;
+			case '\\':	out += "\\\\";	break;
+			case '\n':	out += "\\n";	break;
+			case '\r':	out += "\\r";	break;
+			case '\t':	out += "\\t";	break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					out += "\\u00";
+					out += HEX[(c >> 4) & 0xf];
+					out += HEX[c & 0xf];
+				}//End if
+				else
+				{
+					out += c;
+				}//End else
+				break;
+		}//End switch
+	}//End for
+	out += '"';
+}//End WriteString
+
+void ObjectLineFormat::Write(const SceneObject& object, std::string& out)
+{
+	//9 significant digits round-trips any float exactly
+	char number[32];
+
+	out += '{';
+	for (int i = 0; i < SceneSchema::OBJECTS.numColumns; i++)
+	{
+		const SceneSchema::Column<SceneObject>& column = SceneSchema::OBJECTS.columns[i];
+		if (i > 0) out += ',';
+		out += '"';
+		out += column.name;
+		out += "\":";
+
+		switch (column.type)
+		{
+			case FieldType::INTEGER:	snprintf(number, sizeof(number), "%d", object.*column.intField);		out += number;	break;
+			case FieldType::REAL:		snprintf(number, sizeof(number), "%.9g", object.*column.floatField);	out += number;	break;
+			case FieldType::BOOLEAN:	out += object.*column.boolField ? "true" : "false";									break;
+			case FieldType::TEXT:		WriteString(object.*column.textField, out);											break;
+		}//End switch
+	}//End for
+	out += "}\n";
+}//End Write
+
+//Cursor over one line of input
+struct LineReader
+{
+	const char* position;
+	const char* end;
+
+	void SkipWhitespace()
+	{
+		while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) position++;
+	}//End SkipWhitespace
+
+	bool Consume(const char c)
+	{
+		SkipWhitespace();
+		if (position >= end || *position != c) return false;
+		position++;
+		return true;
+	}//End Consume
+};
+
+static void AppendUTF8(const unsigned codePoint, std::string& out)
+{
+	if (codePoint < 0x80)
+	{
+		out += static_cast<char>(codePoint);
+	}//End if
+	else if (codePoint < 0x800)
+	{
+		out += static_cast<char>(0xc0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3f));
+	}//End else if
+	else if (codePoint < 0x10000)
+	{
+		out += static_cast<char>(0xe0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+		out += static_cast<char>(0x80 | (codePoint & 0x3f));
+	}//End else if
+	else
+	{
+		out += static_cast<char>(0xf0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+		out += static_cast<char>(0x80 | (codePoint & 0x3f));
+	}//End else
+}//End AppendUTF8
+
+static bool ReadHex4(LineReader& reader, unsigned& value)
+{
+	if (reader.end - reader.position < 4) return false;
+
+	value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		const char c = *reader.position++;
+		value <<= 4;
+		if (c >= '0' && c <= '9')		value |= c - '0';
+		else if (c >= 'a' && c <= 'f')	value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')	value |= c - 'A' + 10;
+		else return false;
+	}//End for
+
+	return true;
+}//End ReadHex4
+
+static bool ReadString(LineReader& reader, std::string& out)
+{
+	out.clear();
+	if (!reader.Consume('"')) return false;
+
+	while (reader.position < reader.end)
+	{
+		const char c = *reader.position++;
+		if (c == '"') return true;
+		if (c != '\\')
+		{
+			out += c;
+			continue;
+		}//End if
+
+		if (reader.position >= reader.end) return false;
+		switch (*reader.position++)
+		{
+			case '"':	out += '"';		break;
+			case '\\':	out += '\\';	break;
+			case '/':	out += '/';		break;
+			case 'b':	out += '\b';	break;
+			case 'f':	out += '\f';	break;
+			case 'n':	out += '\n';	break;
+			case 'r':	out += '\r';	break;
+			case 't':	out += '\t';	break;
+			case 'u':
+			{
+				unsigned codePoint;
+				if (!ReadHex4(reader, codePoint)) return false;
+
+				//Characters outside the BMP arrive as a surrogate pair
+				if (codePoint >= 0xd800 && codePoint < 0xdc00)
+				{
+					unsigned lowSurrogate;
+					if (reader.end - reader.position < 2 || reader.position[0] != '\\' || reader.position[1] != 'u') return false;
+					reader.position += 2;
+					if (!ReadHex4(reader, lowSurrogate) || lowSurrogate < 0xdc00 || lowSurrogate >= 0xe000) return false;
+					codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+				}//End if
+
+				AppendUTF8(codePoint, out);
+				break;
+			}
+			default:
+				return false;
+		}//End switch
+	}//End while
+
+	return false;
+}//End ReadString
+
+//The raw text of a number, true, false or null
+static bool ReadLiteral(LineReader& reader, const char*& literalBegin, const char*& literalEnd)
+{
+	reader.SkipWhitespace();
+	literalBegin = reader.position;
+	while (reader.position < reader.end && *reader.position != ',' && *reader.position != '}' &&
+		*reader.position != ' ' && *reader.position != '\t' && *reader.position != '\r')
+	{
+		reader.position++;
+	}//End while
+	literalEnd = reader.position;
+
+	return literalEnd > literalBegin;
+}//End ReadLiteral
+
+static bool LiteralEquals(const char* begin, const char* end, const char* text)
+{
+	const size_t length = strlen(text);
+	return static_cast<size_t>(end - begin) == length && memcmp(begin, text, length) == 0;
+}//End LiteralEquals
+
+static bool ParseNumber(const char* begin, const char* end, double& number)
+{
+	//strtod needs a terminated string - copy to the stack rather than allocating per value
+	char text[64];
+	const size_t length = static_cast<size_t>(end - begin);
+	if (length >= sizeof(text)) return false;
+	memcpy(text, begin, length);
+	text[length] = '\0';
+
+	char* parsedEnd = nullptr;
+	number = strtod(text, &parsedEnd);
+	return parsedEnd == text + length;
+}//End ParseNumber
+
+//Find the schema column for a key - lines written by this tool list columns in order, so the next one is tried first
+static int FindColumn(const std::string& key, const int hint)
+{
+	const int numColumns = SceneSchema::OBJECTS.numColumns;
+	for (int i = 0; i < numColumns; i++)
+	{
+		const int column = (hint + i) % numColumns;
+		if (key == SceneSchema::OBJECTS.columns[column].name) return column;
+	}//End for
+
+	return -1;
+}//End FindColumn
+
+bool ObjectLineFormat::Read(const char* begin, const char* end, SceneObject& object, std::string& error)
+{
+	LineReader reader = { begin, end };
+	if (!reader.Consume('{'))
+	{
+		error = "expected '{'";
+		return false;
+	}//End if
+
+	//Allow an empty object
+	if (reader.Consume('}')) return true;
+
+	std::string key, text;
+	int nextColumn = 0;
+	do
+	{
+		if (!ReadString(reader, key) || !reader.Consume(':'))
+		{
+			error = "expected a quoted key followed by ':'";
+			return false;
+		}//End if
+
+		const int columnIndex = FindColumn(key, nextColumn);
+		const SceneSchema::Column<SceneObject>* column = columnIndex >= 0 ? &SceneSchema::OBJECTS.columns[columnIndex] : nullptr;
+		nextColumn = columnIndex + 1;
+
+		reader.SkipWhitespace();
+		if (reader.position < reader.end && *reader.position == '"')
+		{
+			if (!ReadString(reader, text))
+			{
+				error = "unterminated string for '" + key + "'";
+				return false;
+			}//End if
+
+			if (column)
+			{
+				if (column->type != FieldType::TEXT)
+				{
+					error = "'" + key + "' should not be a string";
+					return false;
+				}//End if
+				object.*column->textField = text;
+			}//End if
+		}//End if
+		else
+		{
+			const char* literalBegin;
+			const char* literalEnd;
+			if (!ReadLiteral(reader, literalBegin, literalEnd))
+			{
+				error = "missing value for '" + key + "'";
+				return false;
+			}//End if
+
+			if (column && !LiteralEquals(literalBegin, literalEnd, "null"))
+			{
+				//Column types are as forgiving as SQLite's - booleans may be given as 0/1, numbers as booleans
+				const bool isTrue = LiteralEquals(literalBegin, literalEnd, "true");
+				const bool isFalse = LiteralEquals(literalBegin, literalEnd, "false");
+				double number = isTrue ? 1.0 : 0.0;
+				if (!isTrue && !isFalse && !ParseNumber(literalBegin, literalEnd, number))
+				{
+					error = "'" + key + "' is not a number or boolean";
+					return false;
+				}//End if
+
+				switch (column->type)
+				{
+					case FieldType::INTEGER:	object.*column->intField = static_cast<int>(number);		break;
+					case FieldType::REAL:		object.*column->floatField = static_cast<float>(number);	break;
+					case FieldType::BOOLEAN:	object.*column->boolField = number != 0.0;					break;
+					case FieldType::TEXT:
+						error = "'" + key + "' should be a string";
+						return false;
+				}//End switch
+			}//End if
+		}//End else
+	} while (reader.Consume(','));
+
+	if (!reader.Consume('}'))
+	{
+		error = "expected ',' or '}'";
+		return false;
+	}//End if
+
+	reader.SkipWhitespace();
+	if (reader.position != reader.end)
+	{
+		error = "unexpected text after the object";
+		return false;
+	}//End if
+
+	return true;
+}//End Read
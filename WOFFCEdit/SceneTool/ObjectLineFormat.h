@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../Tool/SceneObject.h"
+#include <string>
+
+//Line-delimited JSON for SceneObjects - one flat object per line, keyed by the Objects table's column names
+//Driven by the schema descriptor, so it always carries every column the database does
+namespace ObjectLineFormat
+{
+	//Append the object as a single line, including the trailing newline
+	void	Write(const SceneObject& object, std::string& out);
+
+	//Parse one line into the object - keys that are missing keep the object's current values, unknown keys are ignored
+	//Returns false and describes the problem in error if the line isn't a flat JSON object
+	bool	Read(const char* begin, const char* end, SceneObject& object, std::string& error);
+}
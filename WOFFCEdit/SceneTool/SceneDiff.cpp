@@ -0,0 +1,239 @@
+#include "SceneDiff.h"
+#include "../Tool/SceneSchema.h"
+#include <cstring>
+#include <unordered_set>
+
+using SceneSchema::FieldType;
+
+static_assert(sizeof(SceneSchema::OBJECT_COLUMNS) / sizeof(SceneSchema::OBJECT_COLUMNS[0]) <= 64, "Field masks hold one bit per column");
+
+namespace
+{
+	//Steps through one database's Objects table in ID order
+	class ObjectCursor
+	{
+	public:
+		ObjectCursor() : m_statement(nullptr), m_valid(false), m_ID(0) {}
+		~ObjectCursor() { sqlite3_finalize(m_statement); }
+
+		bool Open(SceneDatabase& database)
+		{
+			if (!database.IsOpen() || sqlite3_prepare_v2(database.GetConnection(), "SELECT * FROM Objects ORDER BY ID", -1, &m_statement, nullptr) != SQLITE_OK) return false;
+
+			m_columns = SceneSchema::ResolveColumns(m_statement, SceneSchema::OBJECTS);
+			return m_columns[0] >= 0 && Next();
+		}//End Open
+
+		//Returns false only on a database error - reaching the end just invalidates the cursor
+		bool Next()
+		{
+			const int rc = sqlite3_step(m_statement);
+			m_valid = rc == SQLITE_ROW;
+			if (m_valid) m_ID = sqlite3_column_int(m_statement, m_columns[0]);
+			return m_valid || rc == SQLITE_DONE;
+		}//End Next
+
+		bool	IsAt(const int objectID) const	{ return m_valid && m_ID == objectID; }
+		bool	IsValid() const					{ return m_valid; }
+		int		GetID() const					{ return m_ID; }
+
+		void	Read(SceneObject& object) const	{ SceneSchema::Read(m_statement, SceneSchema::OBJECTS, m_columns, object); }
+
+		//Columns whose stored values differ between the rows two cursors are on - the ID is never compared
+		uint64_t Compare(const ObjectCursor& other) const
+		{
+			uint64_t fields = 0;
+			for (int i = 1; i < SceneSchema::OBJECTS.numColumns; i++)
+			{
+				const int column = m_columns[i], otherColumn = other.m_columns[i];
+				if (column < 0 || otherColumn < 0) continue;
+
+				bool equal;
+				switch (SceneSchema::OBJECTS.columns[i].type)
+				{
+					case FieldType::REAL:
+						equal = sqlite3_column_double(m_statement, column) == sqlite3_column_double(other.m_statement, otherColumn);
+						break;
+					case FieldType::TEXT:
+					{
+						//NULL and empty text load identically, so they compare equal too
+						const unsigned char* text = sqlite3_column_text(m_statement, column);
+						const unsigned char* otherText = sqlite3_column_text(other.m_statement, otherColumn);
+						const int length = text ? sqlite3_column_bytes(m_statement, column) : 0;
+						const int otherLength = otherText ? sqlite3_column_bytes(other.m_statement, otherColumn) : 0;
+						equal = length == otherLength && (length == 0 || memcmp(text, otherText, length) == 0);
+						break;
+					}
+					default:
+						equal = sqlite3_column_int64(m_statement, column) == sqlite3_column_int64(other.m_statement, otherColumn);
+						break;
+				}//End switch
+
+				if (!equal) fields |= 1ull << i;
+			}//End for
+
+			return fields;
+		}//End Compare
+
+	private:
+		sqlite3_stmt*		m_statement;
+		std::vector<int>	m_columns;
+		bool				m_valid;
+		int					m_ID;
+	};
+
+	//Smallest ID any of the cursors is on
+	int LowestID(const ObjectCursor* const* cursors, const int numCursors)
+	{
+		bool found = false;
+		int lowestID = 0;
+		for (int i = 0; i < numCursors; i++)
+		{
+			if (cursors[i]->IsValid() && (!found || cursors[i]->GetID() < lowestID))
+			{
+				lowestID = cursors[i]->GetID();
+				found = true;
+			}//End if
+		}//End for
+
+		return lowestID;
+	}//End LowestID
+}
+
+bool SceneDiff::Diff(SceneDatabase& from, SceneDatabase& to, const std::function<void(const ObjectChange&)>& visitor)
+{
+	ObjectCursor fromCursor, toCursor;
+	if (!fromCursor.Open(from) || !toCursor.Open(to)) return false;
+
+	const ObjectCursor* cursors[] = { &fromCursor, &toCursor };
+	while (fromCursor.IsValid() || toCursor.IsValid())
+	{
+		const int objectID = LowestID(cursors, 2);
+		const bool inFrom = fromCursor.IsAt(objectID);
+		const bool inTo = toCursor.IsAt(objectID);
+
+		ObjectChange change = { ObjectChange::Type::MODIFIED, objectID, 0 };
+		if (inFrom && inTo)
+		{
+			change.fields = fromCursor.Compare(toCursor);
+			if (change.fields) visitor(change);
+		}//End if
+		else
+		{
+			change.type = inTo ? ObjectChange::Type::ADDED : ObjectChange::Type::REMOVED;
+			visitor(change);
+		}//End else
+
+		if ((inFrom && !fromCursor.Next()) || (inTo && !toCursor.Next())) return false;
+	}//End while
+
+	return true;
+}//End Diff
+
+bool SceneDiff::Merge(SceneDatabase& base, SceneDatabase& ours, SceneDatabase& theirs, const bool dryRun, MergeResult& result)
+{
+	result = MergeResult();
+
+	//Only the rows that end up changing ours are held in memory
+	std::vector<SceneObject> changedObjects;
+	std::unordered_set<int> removedObjectIDs;
+
+	{
+		ObjectCursor baseCursor, ourCursor, theirCursor;
+		if (!baseCursor.Open(base) || !ourCursor.Open(ours) || !theirCursor.Open(theirs)) return false;
+
+		SceneObject theirObject;
+		const ObjectCursor* cursors[] = { &baseCursor, &ourCursor, &theirCursor };
+		while (baseCursor.IsValid() || ourCursor.IsValid() || theirCursor.IsValid())
+		{
+			const int objectID = LowestID(cursors, 3);
+			const bool inBase = baseCursor.IsAt(objectID);
+			const bool inOurs = ourCursor.IsAt(objectID);
+			const bool inTheirs = theirCursor.IsAt(objectID);
+
+			if (inBase && inOurs && inTheirs)
+			{
+				const uint64_t theirFields = baseCursor.Compare(theirCursor);
+				const uint64_t ourFields = theirFields ? baseCursor.Compare(ourCursor) : 0;
+
+				if (theirFields && !ourFields)
+				{
+					changedObjects.emplace_back();
+					theirCursor.Read(changedObjects.back());
+					result.modified++;
+				}//End if
+				else if (theirFields)
+				{
+					//Both edited the object - a field only conflicts if both changed it and they disagree
+					const uint64_t conflictingFields = ourFields & theirFields & ourCursor.Compare(theirCursor);
+					const uint64_t takenFields = theirFields & ~ourFields;
+
+					if (takenFields)
+					{
+						changedObjects.emplace_back();
+						SceneObject& mergedObject = changedObjects.back();
+						ourCursor.Read(mergedObject);
+						theirCursor.Read(theirObject);
+						for (int i = 1; i < SceneSchema::OBJECTS.numColumns; i++)
+						{
+							if (takenFields & (1ull << i)) SceneSchema::CopyField(SceneSchema::OBJECTS.columns[i], theirObject, mergedObject);
+						}//End for
+						result.modified++;
+					}//End if
+
+					if (conflictingFields) result.conflicts.push_back({ objectID, "modified on both sides", conflictingFields });
+				}//End else if
+			}//End if
+			else if (inBase && inOurs)
+			{
+				//Removed by them - only safe if we left it alone
+				if (baseCursor.Compare(ourCursor))
+				{
+					result.conflicts.push_back({ objectID, "modified in ours, removed in theirs", 0 });
+				}//End if
+				else
+				{
+					removedObjectIDs.insert(objectID);
+					result.removed++;
+				}//End else
+			}//End else if
+			else if (inBase && inTheirs)
+			{
+				if (baseCursor.Compare(theirCursor)) result.conflicts.push_back({ objectID, "removed in ours, modified in theirs", 0 });
+			}//End else if
+			else if (inOurs && inTheirs && !inBase)
+			{
+				if (ourCursor.Compare(theirCursor)) result.conflicts.push_back({ objectID, "added on both sides with different contents", 0 });
+			}//End else if
+			else if (inTheirs && !inBase)
+			{
+				changedObjects.emplace_back();
+				theirCursor.Read(changedObjects.back());
+				result.added++;
+			}//End else if
+
+			if ((inBase && !baseCursor.Next()) || (inOurs && !ourCursor.Next()) || (inTheirs && !theirCursor.Next())) return false;
+		}//End while
+	}
+
+	if (dryRun || (changedObjects.empty() && removedObjectIDs.empty())) return true;
+
+	std::vector<const SceneObject*> modifiedObjects;
+	modifiedObjects.reserve(changedObjects.size());
+	for (const SceneObject& object : changedObjects) modifiedObjects.push_back(&object);
+
+	return ours.SaveObjectChanges(modifiedObjects, removedObjectIDs) >= 0;
+}//End Merge
+
+std::string SceneDiff::FieldNames(const uint64_t fields)
+{
+	std::string names;
+	for (int i = 0; i < SceneSchema::OBJECTS.numColumns; i++)
+	{
+		if (!(fields & (1ull << i))) continue;
+		if (!names.empty()) names += ',';
+		names += SceneSchema::OBJECTS.columns[i].name;
+	}//End for
+
+	return names;
+}//End FieldNames
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../Tool/SceneDatabase.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//Structural diff and three-way merge of the Objects tables of two or three level databases
+//Tables are streamed side by side in ID order and compared column by column in place, so memory
+//grows with the number of changes rather than the size of the level
+namespace SceneDiff
+{
+	struct ObjectChange
+	{
+		enum class Type { ADDED, REMOVED, MODIFIED };
+
+		Type		type;
+		int			objectID;
+		uint64_t	fields;				//MODIFIED: one bit per schema column that differs
+	};
+
+	struct Conflict
+	{
+		int			objectID;
+		const char*	reason;
+		uint64_t	fields;				//Columns both sides changed to different values, if that is the reason
+	};
+
+	struct MergeResult
+	{
+		int						added = 0;
+		int						removed = 0;
+		int						modified = 0;
+		std::vector<Conflict>	conflicts;	//Ours is kept for each of these
+	};
+
+	//Every difference that would turn from into to, in ID order
+	bool	Diff(SceneDatabase& from, SceneDatabase& to, const std::function<void(const ObjectChange&)>& visitor);
+
+	//Bring the changes theirs made to base into ours, keeping ours wherever both sides changed the same thing
+	//Non-conflicting field edits to the same object are combined. Applied as a single transaction unless dryRun is set
+	bool	Merge(SceneDatabase& base, SceneDatabase& ours, SceneDatabase& theirs, bool dryRun, MergeResult& result);
+
+	//Comma-separated column names for a field mask
+	std::string FieldNames(uint64_t fields);
+}
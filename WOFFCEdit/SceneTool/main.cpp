@@ -0,0 +1,2360 @@
+#include "ObjectLineFormat.h"
+#include "SceneDiff.h"
+#include "../Tool/SceneSchema.h"
+#include "../Tool/SceneDatabase.h"
+#include "../Tool/SceneGraph.h"
+#include "../Tool/SceneSnapshot.h"
+#include "../Tool/AutosaveService.h"
+#include "../Tool/TransformStore.h"
+#include "../Tool/WorkerPool.h"
+#include "../Tool/MemoryTracker.h"
+#include "../Tool/ResourceCache.h"
+#include "../Tool/AssetStreamer.h"
+#include "../Tool/MappedFile.h"
+#include "../Tool/CMOModel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+//Headless entry point for the level pipeline - moves objects in and out of the level database without the editor
+//Only the portable Tool code is linked, so it builds and runs anywhere SQLite does
+
+//Objects written per call into the import transaction
+static const int IMPORT_BATCH_SIZE = 10000;
+
+static void PrintUsage()
+{
+	std::cerr <<
+		"Usage:\n"
+		"  SceneTool import <database> <objects.jsonl | ->               Insert or update every object in the file\n"
+		"  SceneTool export <database> <objects.jsonl | -> [--chunk N]  Write the objects of one chunk, or all of them\n"
+		"         [--box minX minY minZ maxX maxY maxZ]                 With --chunk, only those whose bounds meet the box\n"
+		"  SceneTool query <database> --box minX minY minZ maxX maxY maxZ\n"
+		"  SceneTool query <database> --sphere X Y Z radius             List the IDs of objects whose bounds meet the box or sphere\n"
+		"  SceneTool diff <from> <to>                                   List the objects added, removed or modified\n"
+		"  SceneTool merge <base> <ours> <theirs> [--dry-run]           Apply theirs' changes since base to ours\n"
+		"  SceneTool compact-ids <database>                             Renumber objects densely from 1 - run with the editor closed\n"
+		"  SceneTool model-bounds <database>                            Record the radius of every model the objects use, for the spatial index -\n"
+		"                                                               run from the editor's directory, which model paths are relative to\n"
+		"  SceneTool bench-merge [--objects N]                          Time diff and merge on synthetic databases\n"
+		"  SceneTool bench-save [--objects N] [--memory]                Time saving a chunk row by row against SaveObjectChanges, on disk or in memory\n"
+		"  SceneTool bench-startup [--objects N]                        Time loading a chunk from its snapshot against from the database, and\n"
+		"                                                               check both give the same objects\n"
+		"  SceneTool test-autosave [--objects N]                        Check background saves write rows as submitted while the scene keeps changing\n"
+		"  SceneTool bench-transforms [--objects N]                     Time per-frame transform and picking passes\n"
+		"  SceneTool bench-hierarchy [--objects N]                      Time transform propagation through wide and deep hierarchies\n"
+		"  SceneTool bench-components [--objects N]                     Time a light pass over component pools against full objects\n"
+		"  SceneTool bench-textures [--objects N]                       Check and time the shared texture cache with a stand-in loader\n"
+		"  SceneTool bench-streaming [--objects N]                      Time to first frame and to every mesh resident, loading on the UI thread\n"
+		"                                                               against streaming behind placeholders\n"
+		"  SceneTool bench-model-reads [--corpus N]                     Time and measure reading model files into heap copies against mapping them,\n"
+		"                                                               over database/data and N generated CMO files\n"
+		"  SceneTool bench-cmo-parse [--files N]                        Time parsing CMO files on a worker pool as the thread count doubles\n"
+		"  SceneTool memory-report [--objects N] [--json]               Compare in-memory scene layouts on a synthetic level, --json also prints the\n"
+		"                                                               memory tracker's report to stdout\n";
+}//End PrintUsage
+
+static void PrintThroughput(const char* action, const long long objects, const long long bytes, const std::chrono::steady_clock::time_point start)
+{
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	const double seconds = elapsed.count() > 0.0 ? elapsed.count() : 1e-9;
+	fprintf(stderr, "%s %lld objects (%.2f MB) in %.3fs - %.0f objects/s, %.2f MB/s\n",
+		action, objects, bytes / 1048576.0, elapsed.count(), objects / seconds, bytes / 1048576.0 / seconds);
+}//End PrintThroughput
+
+static bool OpenDatabase(SceneDatabase& database, const char* path)
+{
+	if (!database.Open(path, SQLITE_OPEN_READWRITE))
+	{
+		fprintf(stderr, "Can't open database '%s'\n", path);
+		return false;
+	}//End if
+
+	//Imports rely on the ID index for their upserts
+	if (!database.Migrate())
+	{
+		fprintf(stderr, "Database schema migration failed\n");
+		return false;
+	}//End if
+
+	return true;
+}//End OpenDatabase
+
+static int Import(const char* databasePath, const char* inputPath)
+{
+	SceneDatabase database;
+	if (!OpenDatabase(database, databasePath)) return 1;
+
+	std::ifstream inputFile;
+	if (strcmp(inputPath, "-") != 0)
+	{
+		inputFile.open(inputPath, std::ios::binary);
+		if (!inputFile)
+		{
+			fprintf(stderr, "Can't open '%s'\n", inputPath);
+			return 1;
+		}//End if
+	}//End if
+	std::istream& input = inputFile.is_open() ? inputFile : std::cin;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	//The whole file goes in as one transaction - a bad line leaves the database untouched
+	if (!database.BeginTransaction())
+	{
+		fprintf(stderr, "Can't start a transaction\n");
+		return 1;
+	}//End if
+
+	std::vector<SceneObject> batch;
+	std::vector<const SceneObject*> batchObjects;
+	batch.reserve(IMPORT_BATCH_SIZE);
+	batchObjects.reserve(IMPORT_BATCH_SIZE);
+	const std::unordered_set<int> noRemovals;
+
+	std::string line, error;
+	long long lineNumber = 0, numObjects = 0, numBytes = 0;
+	bool failed = false;
+
+	while (!failed)
+	{
+		const bool haveLine = static_cast<bool>(std::getline(input, line));
+		if (haveLine)
+		{
+			lineNumber++;
+			numBytes += line.size() + 1;
+
+			//Blank lines are allowed, e.g. a trailing newline
+			if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+			batch.emplace_back();
+			if (!ObjectLineFormat::Read(line.data(), line.data() + line.size(), batch.back(), error))
+			{
+				fprintf(stderr, "Line %lld: %s\n", lineNumber, error.c_str());
+				failed = true;
+				break;
+			}//End if
+		}//End if
+
+		//Flush a full batch, or whatever is left at the end of the input
+		if (static_cast<int>(batch.size()) == IMPORT_BATCH_SIZE || (!haveLine && !batch.empty()))
+		{
+			batchObjects.clear();
+			for (const SceneObject& object : batch) batchObjects.push_back(&object);
+
+			if (database.SaveObjectChanges(batchObjects, noRemovals) < 0)
+			{
+				fprintf(stderr, "Writing objects failed near line %lld\n", lineNumber);
+				failed = true;
+				break;
+			}//End if
+
+			numObjects += batch.size();
+			batch.clear();
+		}//End if
+
+		if (!haveLine) break;
+	}//End while
+
+	if (failed || !database.CommitTransaction())
+	{
+		database.RollbackTransaction();
+		fprintf(stderr, "Import failed - nothing was written\n");
+		return 1;
+	}//End if
+
+	PrintThroughput("Imported", numObjects, numBytes, start);
+	return 0;
+}//End Import
+
+//A box only narrows down one chunk - the spatial index answers it, so the rest of the chunk is never read
+static int Export(const char* databasePath, const char* outputPath, const int chunkID, const ObjectBounds* box)
+{
+	SceneDatabase database;
+	if (!OpenDatabase(database, databasePath)) return 1;
+
+	std::ofstream outputFile;
+	if (strcmp(outputPath, "-") != 0)
+	{
+		outputFile.open(outputPath, std::ios::binary | std::ios::trunc);
+		if (!outputFile)
+		{
+			fprintf(stderr, "Can't open '%s'\n", outputPath);
+			return 1;
+		}//End if
+	}//End if
+	std::ostream& output = outputFile.is_open() ? outputFile : std::cout;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	//Lines are gathered into one buffer and written out in large blocks
+	static const size_t FLUSH_SIZE = 1 << 20;
+	std::string buffer;
+	buffer.reserve(FLUSH_SIZE + 4096);
+	long long numObjects = 0, numBytes = 0;
+
+	const auto writeObject = [&](const SceneObject& object)
+	{
+		ObjectLineFormat::Write(object, buffer);
+		numObjects++;
+
+		if (buffer.size() >= FLUSH_SIZE)
+		{
+			output.write(buffer.data(), buffer.size());
+			numBytes += buffer.size();
+			buffer.clear();
+		}//End if
+
+		return static_cast<bool>(output);
+	};
+
+	bool read;
+	if (box)
+	{
+		std::vector<SceneObject> objects;
+		read = database.LoadObjectsInBox(chunkID, *box, objects);
+		for (size_t i = 0; read && i < objects.size() && writeObject(objects[i]); i++) {}
+	}//End if
+	else
+	{
+		read = database.ForEachObject(chunkID, writeObject);
+	}//End else
+
+	output.write(buffer.data(), buffer.size());
+	numBytes += buffer.size();
+	output.flush();
+
+	if (!read || !output)
+	{
+		fprintf(stderr, "Export failed\n");
+		return 1;
+	}//End if
+
+	PrintThroughput("Exported", numObjects, numBytes, start);
+	return 0;
+}//End Export
+
+static int Query(const char* databasePath, const ObjectBounds* box, const float sphere[4])
+{
+	SceneDatabase database;
+	if (!OpenDatabase(database, databasePath)) return 1;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<int> objectIDs;
+	const bool queried = box ? database.QueryObjectsInBox(*box, objectIDs) : database.QueryObjectsInSphere(sphere[0], sphere[1], sphere[2], sphere[3], objectIDs);
+	if (!queried)
+	{
+		fprintf(stderr, "Query failed\n");
+		return 1;
+	}//End if
+
+	//IDs on stdout, one per line, so scripts can read them straight off
+	std::string output;
+	for (const int objectID : objectIDs) output += std::to_string(objectID) + "\n";
+	std::cout << output;
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "%zu objects in %.3fms\n", objectIDs.size(), elapsed.count() * 1000.0);
+	return 0;
+}//End Query
+
+static bool OpenReadOnly(SceneDatabase& database, const char* path)
+{
+	if (database.Open(path, SQLITE_OPEN_READONLY)) return true;
+
+	fprintf(stderr, "Can't open database '%s'\n", path);
+	return false;
+}//End OpenReadOnly
+
+static int Diff(const char* fromPath, const char* toPath)
+{
+	SceneDatabase from, to;
+	if (!OpenReadOnly(from, fromPath) || !OpenReadOnly(to, toPath)) return 1;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	//One line per change: + added, - removed, ~ modified followed by the columns that differ
+	long long numChanges = 0;
+	const bool compared = SceneDiff::Diff(from, to, [&numChanges](const SceneDiff::ObjectChange& change)
+	{
+		switch (change.type)
+		{
+			case SceneDiff::ObjectChange::Type::ADDED:		printf("+ %d\n", change.objectID);	break;
+			case SceneDiff::ObjectChange::Type::REMOVED:	printf("- %d\n", change.objectID);	break;
+			case SceneDiff::ObjectChange::Type::MODIFIED:	printf("~ %d %s\n", change.objectID, SceneDiff::FieldNames(change.fields).c_str());	break;
+		}//End switch
+		numChanges++;
+	});
+
+	if (!compared)
+	{
+		fprintf(stderr, "Diff failed\n");
+		return 1;
+	}//End if
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "%lld changes found in %.3fs\n", numChanges, elapsed.count());
+	return 0;
+}//End Diff
+
+static void PrintMergeResult(const SceneDiff::MergeResult& result)
+{
+	for (const SceneDiff::Conflict& conflict : result.conflicts)
+	{
+		printf("! %d %s%s%s\n", conflict.objectID, conflict.reason, conflict.fields ? ": " : "", SceneDiff::FieldNames(conflict.fields).c_str());
+	}//End for
+
+	fprintf(stderr, "%d added, %d removed, %d modified, %d conflicts\n", result.added, result.removed, result.modified, static_cast<int>(result.conflicts.size()));
+}//End PrintMergeResult
+
+static int Merge(const char* basePath, const char* ourPath, const char* theirPath, const bool dryRun)
+{
+	SceneDatabase base, ours, theirs;
+	if (!OpenReadOnly(base, basePath) || !OpenDatabase(ours, ourPath) || !OpenReadOnly(theirs, theirPath)) return 1;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	SceneDiff::MergeResult result;
+	if (!SceneDiff::Merge(base, ours, theirs, dryRun, result))
+	{
+		fprintf(stderr, "Merge failed - nothing was written\n");
+		return 1;
+	}//End if
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	PrintMergeResult(result);
+	fprintf(stderr, "%s in %.3fs\n", dryRun ? "Dry run" : "Merged", elapsed.count());
+
+	//Conflicts are reported through the exit code so scripts can stop for a human
+	return result.conflicts.empty() ? 0 : 2;
+}//End Merge
+
+static int CompactIDs(const char* databasePath)
+{
+	SceneDatabase database;
+	if (!OpenDatabase(database, databasePath)) return 1;
+
+	const auto start = std::chrono::steady_clock::now();
+	int numObjects, numRenumbered;
+	if (!database.CompactObjectIDs(numObjects, numRenumbered))
+	{
+		fprintf(stderr, "Compaction failed - the database is unchanged\n");
+		return 1;
+	}//End if
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "Renumbered %d of %d objects in %.3fs - IDs now run from 1 to %d\n", numRenumbered, numObjects, elapsed.count(), numObjects);
+	return 0;
+}//End CompactIDs
+
+static bool CopyFile(const std::string& from, const std::string& to)
+{
+	std::ifstream source(from, std::ios::binary);
+	std::ofstream destination(to, std::ios::binary | std::ios::trunc);
+	destination << source.rdbuf();
+	return source && destination;
+}//End CopyFile
+
+//Apply a random mix of edits to a copy of the base - a fraction each of moves, renames, removals and additions
+static bool EditSyntheticDatabase(const std::string& path, const int numObjects, const unsigned seed, const int firstNewID)
+{
+	SceneDatabase database;
+	if (!database.Open(path.c_str(), SQLITE_OPEN_READWRITE)) return false;
+
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> anyObject(1, numObjects);
+
+	const int numEdits = numObjects / 100;
+	std::vector<SceneObject> changedObjects(numEdits);
+	std::unordered_set<int> removedObjectIDs;
+	for (int i = 0; i < numEdits; i++)
+	{
+		SceneObject& object = changedObjects[i];
+		object.ID = i % 4 == 3 ? firstNewID + i : anyObject(random);
+		object.model_path = "database/data/placeholder.cmo";
+		object.posX = static_cast<float>(random() % 1000);
+		object.name = i % 2 ? "renamed" : "object";
+		if (i % 4 == 2) removedObjectIDs.insert(anyObject(random));
+	}//End for
+
+	std::vector<const SceneObject*> modifiedObjects;
+	for (const SceneObject& object : changedObjects)
+	{
+		if (!removedObjectIDs.count(object.ID)) modifiedObjects.push_back(&object);
+	}//End for
+
+	return database.SaveObjectChanges(modifiedObjects, removedObjectIDs) >= 0;
+}//End EditSyntheticDatabase
+
+static int BenchMerge(const int numObjects)
+{
+	const std::string basePath = "bench_base.db", ourPath = "bench_ours.db", theirPath = "bench_theirs.db";
+	std::remove(basePath.c_str());
+
+	//Base level - created directly, with only the ID index, so building it stays quick
+	{
+		SceneDatabase base;
+		if (!base.Open(basePath.c_str(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) ||
+			sqlite3_exec(base.GetConnection(), SceneSchema::CreateTableSQL(SceneSchema::OBJECTS).c_str(), nullptr, nullptr, nullptr) != SQLITE_OK ||
+			sqlite3_exec(base.GetConnection(), "CREATE INDEX Objects_ID ON Objects(ID)", nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			fprintf(stderr, "Can't create '%s'\n", basePath.c_str());
+			return 1;
+		}//End if
+
+		std::vector<SceneObject> objects(numObjects);
+		for (int i = 0; i < numObjects; i++)
+		{
+			objects[i].ID = i + 1;
+			objects[i].model_path = "database/data/placeholder.cmo";
+			objects[i].tex_diffuse_path = "database/data/placeholder.dds";
+			objects[i].posX = static_cast<float>(i % 1000);
+			objects[i].posZ = static_cast<float>(i / 1000);
+			objects[i].scaX = objects[i].scaY = objects[i].scaZ = 1.0f;
+			objects[i].name = "object";
+		}//End for
+
+		const auto start = std::chrono::steady_clock::now();
+		if (base.SaveAllObjects(objects) < 0) return 1;
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		fprintf(stderr, "Created a base level of %d objects in %.3fs\n", numObjects, elapsed.count());
+	}
+
+	//Two designers' copies, each with 1% of the objects edited
+	if (!CopyFile(basePath, ourPath) || !CopyFile(basePath, theirPath) ||
+		!EditSyntheticDatabase(ourPath, numObjects, 1, numObjects + 1) ||
+		!EditSyntheticDatabase(theirPath, numObjects, 2, numObjects + numObjects / 2))
+	{
+		fprintf(stderr, "Can't create the edited copies\n");
+		return 1;
+	}//End if
+
+	SceneDatabase base, ours, theirs;
+	if (!OpenReadOnly(base, basePath.c_str()) || !OpenReadOnly(theirs, theirPath.c_str()) || !ours.Open(ourPath.c_str(), SQLITE_OPEN_READWRITE)) return 1;
+
+	auto start = std::chrono::steady_clock::now();
+	long long numChanges = 0;
+	if (!SceneDiff::Diff(base, theirs, [&numChanges](const SceneDiff::ObjectChange&) { numChanges++; })) return 1;
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "Diff of %d objects: %lld changes in %.3fs (%.0f objects/s)\n", numObjects, numChanges, elapsed.count(), numObjects / elapsed.count());
+
+	start = std::chrono::steady_clock::now();
+	SceneDiff::MergeResult result;
+	if (!SceneDiff::Merge(base, ours, theirs, false, result)) return 1;
+	elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "Merge of %d objects: %d added, %d removed, %d modified, %d conflicts in %.3fs (%.0f objects/s)\n",
+		numObjects, result.added, result.removed, result.modified, static_cast<int>(result.conflicts.size()), elapsed.count(), numObjects / elapsed.count());
+
+	base.Close();
+	ours.Close();
+	theirs.Close();
+	std::remove(basePath.c_str());
+	std::remove(ourPath.c_str());
+	std::remove(theirPath.c_str());
+	return 0;
+}//End BenchMerge
+
+//The save as the editor first wrote it - every row deleted, then an INSERT built as text, prepared and stepped for each object
+//with no transaction around them, so every row commits on its own
+static int SaveRowByRow(SceneDatabase& database, const std::vector<SceneObject>& objects)
+{
+	sqlite3* connection = database.GetConnection();
+	if (sqlite3_exec(connection, "DELETE FROM Objects", nullptr, nullptr, nullptr) != SQLITE_OK) return -1;
+
+	const SceneSchema::Table<SceneObject>& table = SceneSchema::OBJECTS;
+	int rowsWritten = 0;
+	for (const SceneObject& object : objects)
+	{
+		std::stringstream command;
+		command << "INSERT INTO Objects VALUES(";
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			const SceneSchema::Column<SceneObject>& column = table.columns[i];
+			if (i > 0) command << ",";
+			switch (column.type)
+			{
+				case SceneSchema::FieldType::INTEGER:	command << object.*column.intField;							break;
+				case SceneSchema::FieldType::REAL:		command << object.*column.floatField;						break;
+				case SceneSchema::FieldType::BOOLEAN:	command << object.*column.boolField;						break;
+				case SceneSchema::FieldType::TEXT:		command << "'" << object.*column.textField << "'";			break;
+			}//End switch
+		}//End for
+		command << ")";
+
+		sqlite3_stmt* statement = nullptr;
+		const std::string sql = command.str();
+		const int rc = sqlite3_prepare_v2(connection, sql.c_str(), -1, &statement, nullptr) == SQLITE_OK ? sqlite3_step(statement) : SQLITE_ERROR;
+		sqlite3_finalize(statement);
+		if (rc != SQLITE_DONE) return -1;
+
+		rowsWritten++;
+	}//End for
+
+	return rowsWritten;
+}//End SaveRowByRow
+
+static int CountObjectRows(SceneDatabase& database)
+{
+	sqlite3_stmt* statement = nullptr;
+	int rows = -1;
+	if (sqlite3_prepare_v2(database.GetConnection(), "SELECT count(*) FROM Objects", -1, &statement, nullptr) == SQLITE_OK &&
+		sqlite3_step(statement) == SQLITE_ROW)
+	{
+		rows = sqlite3_column_int(statement, 0);
+	}//End if
+	sqlite3_finalize(statement);
+	return rows;
+}//End CountObjectRows
+
+//A database holding the objects - just the Objects table and its ID index as the editor first had it, or migrated to the
+//editor's full schema, whose saves also keep the spatial index and ID bookkeeping up to date
+static bool CreateSaveBenchDatabase(SceneDatabase& database, const std::string& path, const std::vector<SceneObject>& objects, const bool migrated)
+{
+	if (path != ":memory:") std::remove(path.c_str());
+
+	//Migrations expect a level database, which has a Chunks table
+	sqlite3* connection = nullptr;
+	const bool created = database.Open(path.c_str(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) && (connection = database.GetConnection()) &&
+		sqlite3_exec(connection, SceneSchema::CreateTableSQL(SceneSchema::OBJECTS).c_str(), nullptr, nullptr, nullptr) == SQLITE_OK &&
+		sqlite3_exec(connection, SceneSchema::CreateTableSQL(SceneSchema::CHUNKS).c_str(), nullptr, nullptr, nullptr) == SQLITE_OK &&
+		(migrated ? database.Migrate() : sqlite3_exec(connection, "CREATE INDEX Objects_ID ON Objects(ID)", nullptr, nullptr, nullptr) == SQLITE_OK) &&
+		database.SaveAllObjects(objects) == static_cast<int>(objects.size());
+
+	if (!created) fprintf(stderr, "Can't create '%s'\n", path.c_str());
+	return created;
+}//End CreateSaveBenchDatabase
+
+//Times a save of every object, printing its rate - the rate, or 0 if the save didn't write every row
+static double TimeSave(const char* name, const std::function<int()>& save, const int numObjects)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const int rows = save();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	const double rate = rows / elapsed.count();
+	fprintf(stderr, "  %-52s %d rows in %.3fs - %.0f rows/s\n", name, rows, elapsed.count(), rate);
+	return rows == numObjects ? rate : 0.0;
+}//End TimeSave
+
+static int BenchSave(const int numObjects, const bool inMemory)
+{
+	const std::string path = inMemory ? ":memory:" : "bench_save.db";
+
+	//A chunk's worth of objects with a name, a light or a sound here and there, so rows carry text and components as real ones do
+	std::vector<SceneObject> objects(numObjects);
+	std::vector<const SceneObject*> modifiedObjects(numObjects);
+	for (int i = 0; i < numObjects; i++)
+	{
+		SceneObject& object = objects[i];
+		object.ID = i + 1;
+		object.chunk_ID = 0;
+		object.model_path = "database/data/placeholder.cmo";
+		object.tex_diffuse_path = "database/data/placeholder.dds";
+		object.posX = static_cast<float>(i % 1000);
+		object.posZ = static_cast<float>(i / 1000);
+		object.scaX = object.scaY = object.scaZ = 1.0f;
+		object.name = "object " + std::to_string(i + 1);
+		if (i % 20 == 0) object.light_type = 1;
+		if (i % 50 == 0) object.audio_path = "database/data/ambience.wav";
+		modifiedObjects[i] = &object;
+	}//End for
+
+	fprintf(stderr, "Saving %d objects %s - every row rewritten, each save starting from the chunk already saved\n",
+		numObjects, inMemory ? "in memory" : ("to " + path).c_str());
+
+	//Both paths over the same rows alone, then the new one against the editor's full schema
+	double oldRate, newRate, migratedRate;
+	{
+		SceneDatabase database;
+		if (!CreateSaveBenchDatabase(database, path, objects, false)) return 1;
+
+		oldRate = TimeSave("Row by row, an INSERT string per object:", [&]() { return SaveRowByRow(database, objects); }, numObjects);
+		for (SceneObject& object : objects) object.posY += 1.0f;
+		newRate = TimeSave("SaveObjectChanges, one transaction:", [&]() { return database.SaveObjectChanges(modifiedObjects, std::unordered_set<int>()); }, numObjects);
+		if (CountObjectRows(database) != numObjects) newRate = 0.0;
+	}
+
+	{
+		SceneDatabase database;
+		if (!CreateSaveBenchDatabase(database, path, objects, true)) return 1;
+
+		for (SceneObject& object : objects) object.posY += 1.0f;
+		migratedRate = TimeSave("SaveObjectChanges, also keeping the spatial index:", [&]() { return database.SaveObjectChanges(modifiedObjects, std::unordered_set<int>()); }, numObjects);
+		if (CountObjectRows(database) != numObjects) migratedRate = 0.0;
+	}
+
+	if (!inMemory) std::remove(path.c_str());
+
+	if (oldRate == 0.0 || newRate == 0.0 || migratedRate == 0.0)
+	{
+		fprintf(stderr, "FAILED: a save didn't write every row\n");
+		return 1;
+	}//End if
+
+	fprintf(stderr, "SaveObjectChanges is %.1fx the old path's rate on the same rows\n", newRate / oldRate);
+	return 0;
+}//End BenchSave
+
+//Whether two records hold the same value in every column
+template <typename Record>
+static bool RecordsEqual(const SceneSchema::Table<Record>& table, const Record& a, const Record& b)
+{
+	for (int i = 0; i < table.numColumns; i++)
+	{
+		const SceneSchema::Column<Record>& column = table.columns[i];
+		bool equal = true;
+		switch (column.type)
+		{
+			case SceneSchema::FieldType::INTEGER:	equal = a.*column.intField == b.*column.intField;		break;
+			case SceneSchema::FieldType::REAL:		equal = a.*column.floatField == b.*column.floatField;	break;
+			case SceneSchema::FieldType::BOOLEAN:	equal = a.*column.boolField == b.*column.boolField;		break;
+			case SceneSchema::FieldType::TEXT:		equal = a.*column.textField == b.*column.textField;		break;
+		}//End switch
+
+		if (!equal) return false;
+	}//End for
+
+	return true;
+}//End RecordsEqual
+
+//A level with one chunk, and objects with a light, a sound, an AI node or a path node here and there
+static bool CreateBenchLevel(SceneDatabase& database, const std::string& path, const int chunkID, const int numObjects)
+{
+	std::remove(path.c_str());
+
+	ChunkObject chunk;
+	chunk.ID = chunkID;
+	chunk.name = "bench chunk";
+	chunk.heightmap_path = "database/data/heightmap.raw";
+	chunk.tex_diffuse_path = "database/data/rock.dds";
+
+	std::vector<SceneObject> objects(numObjects);
+	for (int i = 0; i < numObjects; i++)
+	{
+		SceneObject& object = objects[i];
+		object.ID = i + 1;
+		object.chunk_ID = chunkID;
+		object.model_path = i % 3 ? "database/data/placeholder.cmo" : "database/data/rock.cmo";
+		object.tex_diffuse_path = "database/data/placeholder.dds";
+		object.posX = static_cast<float>(i % 1000);
+		object.posZ = static_cast<float>(i / 1000);
+		object.rotY = static_cast<float>(i % 360);
+		object.scaX = object.scaY = object.scaZ = 1.0f;
+		object.name = "object " + std::to_string(i + 1);
+		if (i % 20 == 0) object.light_type = 1;
+		if (i % 50 == 0) object.audio_path = "database/data/ambience.wav";
+		object.AINode = i % 70 == 0;
+		object.path_node = i % 90 == 0;
+		object.parent_id = i % 10 ? 0 : i;
+	}//End for
+
+	sqlite3_stmt* insertChunk = nullptr;
+	const std::string insertChunkSQL = SceneSchema::InsertSQL(SceneSchema::CHUNKS);
+	const bool created = database.Open(path.c_str(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) &&
+		sqlite3_exec(database.GetConnection(), SceneSchema::CreateTableSQL(SceneSchema::OBJECTS).c_str(), nullptr, nullptr, nullptr) == SQLITE_OK &&
+		sqlite3_exec(database.GetConnection(), SceneSchema::CreateTableSQL(SceneSchema::CHUNKS).c_str(), nullptr, nullptr, nullptr) == SQLITE_OK &&
+		sqlite3_prepare_v2(database.GetConnection(), insertChunkSQL.c_str(), -1, &insertChunk, nullptr) == SQLITE_OK &&
+		SceneSchema::Bind(insertChunk, SceneSchema::CHUNKS, chunk) && sqlite3_step(insertChunk) == SQLITE_DONE &&
+		database.Migrate() && database.SaveAllObjects(objects) == numObjects;
+	sqlite3_finalize(insertChunk);
+
+	if (!created) fprintf(stderr, "Can't create '%s'\n", path.c_str());
+	return created;
+}//End CreateBenchLevel
+
+static int BenchStartup(const int numObjects)
+{
+	const std::string databasePath = "bench_startup.db";
+	const int chunkID = 0;
+
+	SceneDatabase database;
+	if (!CreateBenchLevel(database, databasePath, chunkID, numObjects)) return 1;
+
+	//Both loads as the editor makes them - the best of a few passes, so neither pays for a cold page cache
+	const int numPasses = 3;
+	const std::string snapshotPath = SceneSnapshot::GetPath(databasePath, chunkID);
+	const int64_t revision = database.GetRevision();
+	ChunkObject databaseChunk, snapshotChunk;
+	SceneGraph databaseObjects, snapshotObjects;
+	double databaseSeconds = 0.0, snapshotSeconds = 0.0;
+	bool loaded = true;
+
+	for (int pass = 0; pass < numPasses && loaded; pass++)
+	{
+		databaseObjects.Clear();
+		const auto start = std::chrono::steady_clock::now();
+		loaded = database.LoadChunk(chunkID, databaseChunk) &&
+			database.ForEachObjectWithoutCold(chunkID, [&databaseObjects](const SceneObject& object) { databaseObjects.AddHot(object); return true; });
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (pass == 0 || elapsed.count() < databaseSeconds) databaseSeconds = elapsed.count();
+	}//End for
+
+	loaded = loaded && SceneSnapshot::Write(snapshotPath, revision, databaseChunk, databaseObjects);
+
+	for (int pass = 0; pass < numPasses && loaded; pass++)
+	{
+		snapshotObjects.Clear();
+		const auto start = std::chrono::steady_clock::now();
+		loaded = SceneSnapshot::Read(snapshotPath, revision, chunkID, snapshotChunk, snapshotObjects);
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (pass == 0 || elapsed.count() < snapshotSeconds) snapshotSeconds = elapsed.count();
+	}//End for
+
+	std::ifstream snapshotFile(snapshotPath, std::ios::binary | std::ios::ate);
+	const long long snapshotBytes = snapshotFile ? static_cast<long long>(snapshotFile.tellg()) : 0;
+	snapshotFile.close();
+
+	if (!loaded)
+	{
+		fprintf(stderr, "FAILED: couldn't load the chunk from the database or its snapshot\n");
+		return 1;
+	}//End if
+
+	fprintf(stderr, "Startup load of %d objects, best of %d:\n", numObjects, numPasses);
+	fprintf(stderr, "  LoadChunk and ForEachObjectWithoutCold: %.3fs - %.0f objects/s\n", databaseSeconds, numObjects / databaseSeconds);
+	fprintf(stderr, "  SceneSnapshot::Read (%.2f MB):          %.3fs - %.0f objects/s (%.1fx)\n",
+		snapshotBytes / 1048576.0, snapshotSeconds, numObjects / snapshotSeconds, databaseSeconds / snapshotSeconds);
+
+	//Both must give the editor the same scene - every column of every object, components included, in the same order
+	//Neither graph has a cold source, so joining fills the cold fields with the same defaults on both sides
+	int numMismatched = 0;
+	if (databaseObjects.GetSize() != numObjects || snapshotObjects.GetSize() != numObjects)
+	{
+		fprintf(stderr, "FAILED: loaded %d objects from the database and %d from the snapshot, expected %d\n",
+			databaseObjects.GetSize(), snapshotObjects.GetSize(), numObjects);
+		numMismatched = numObjects;
+	}//End if
+	else
+	{
+		for (int i = 0; i < numObjects; i++)
+		{
+			if (!RecordsEqual(SceneSchema::OBJECTS, databaseObjects.Assemble(i), snapshotObjects.Assemble(i))) numMismatched++;
+		}//End for
+	}//End else
+
+	const bool chunksMatch = RecordsEqual(SceneSchema::CHUNKS, databaseChunk, snapshotChunk);
+	if (numMismatched > 0) fprintf(stderr, "FAILED: %d objects differ between the two loads\n", numMismatched);
+	if (!chunksMatch) fprintf(stderr, "FAILED: the chunk differs between the two loads\n");
+	if (numMismatched == 0 && chunksMatch) fprintf(stderr, "Both loads give the same chunk and objects\n");
+
+	database.Close();
+	std::remove(snapshotPath.c_str());
+	std::remove(databasePath.c_str());
+	return numMismatched == 0 && chunksMatch ? 0 : 1;
+}//End BenchStartup
+
+//Objects missing from either graph or differing in any column - matched by ID
+static int CountMismatchedObjects(SceneGraph& expected, SceneGraph& actual)
+{
+	std::unordered_map<int, int> actualIndices;
+	actualIndices.reserve(actual.GetSize());
+	for (int i = 0; i < actual.GetSize(); i++) actualIndices.emplace(actual.GetHot(i).ID, i);
+
+	int numMismatched = std::abs(expected.GetSize() - actual.GetSize());
+	for (int i = 0; i < expected.GetSize(); i++)
+	{
+		const auto actualIndex = actualIndices.find(expected.GetHot(i).ID);
+		if (actualIndex == actualIndices.end() || !RecordsEqual(SceneSchema::OBJECTS, expected.Assemble(i), actual.Assemble(actualIndex->second))) numMismatched++;
+	}//End for
+
+	return numMismatched;
+}//End CountMismatchedObjects
+
+//Saves through the autosave worker while the scene keeps changing, as the editor does between frames, then checks that
+//each save wrote the rows as they were at submit and that the worker's snapshot matches the database
+static int TestAutosave(const int numObjects)
+{
+	const std::string databasePath = "test_autosave.db";
+	const int chunkID = 0;
+	{
+		SceneDatabase level;
+		if (!CreateBenchLevel(level, databasePath, chunkID, numObjects)) return 1;
+	}
+
+	//The editor's side - its own connection, with cold fields read from it while the worker writes through another
+	SceneDatabase database;
+	SceneGraph scene;
+	if (!database.Open(databasePath.c_str(), SQLITE_OPEN_READWRITE) ||
+		!database.ForEachObjectWithoutCold(chunkID, [&scene](const SceneObject& object) { scene.AddHot(object); return true; }))
+	{
+		fprintf(stderr, "Can't load '%s'\n", databasePath.c_str());
+		return 1;
+	}//End if
+	scene.SetColdSource([&database, chunkID](const std::vector<int>& objectIDs, const std::function<bool(const SceneObject&)>& visitor)
+	{
+		return objectIDs.empty() ? database.ForEachObject(chunkID, visitor) : database.ForEachObjectWithID(objectIDs, visitor);
+	});
+
+	AutosaveService autosave;
+	if (!autosave.Start(databasePath))
+	{
+		fprintf(stderr, "Can't start the autosave worker\n");
+		return 1;
+	}//End if
+
+	//Moves, renames, removals and additions - flagged as SceneChangeTracker would for the next save
+	std::mt19937 random(5);
+	std::unordered_set<int> modifiedIDs, removedIDs;
+	int nextID = numObjects + 1;
+	const int editsPerBatch = std::max(8, numObjects / 200);
+	auto edit = [&]()
+	{
+		for (int i = 0; i < editsPerBatch && scene.GetSize() > 0; i++)
+		{
+			const int index = static_cast<int>(random() % scene.GetSize());
+			const int objectID = scene.GetHot(index).ID;
+			switch (i % 8)
+			{
+				case 3:
+					scene.GetCold(index).name = "renamed " + std::to_string(random() % 1000);
+					modifiedIDs.insert(objectID);
+					break;
+				case 5:
+					scene.Extract(index);
+					modifiedIDs.erase(objectID);
+					removedIDs.insert(objectID);
+					break;
+				case 7:
+				{
+					SceneObject object;
+					object.ID = nextID++;
+					object.chunk_ID = chunkID;
+					object.model_path = "database/data/placeholder.cmo";
+					object.name = "added";
+					object.light_type = i % 16 == 7 ? 2 : 0;
+					scene.Add(object);
+					modifiedIDs.insert(object.ID);
+					break;
+				}
+				default:
+					scene.GetHot(index).posY += 1.0f;
+					modifiedIDs.insert(objectID);
+					break;
+			}//End switch
+		}//End for
+	};
+
+	const int numRounds = 5;
+	int numFailures = 0;
+	for (int round = 1; round <= numRounds; round++)
+	{
+		edit();
+
+		//Assembled as ToolMain::SubmitSave does - the job owns copies of the flagged rows
+		std::vector<int> modifiedIndices;
+		for (int i = 0; i < scene.GetSize(); i++)
+		{
+			if (modifiedIDs.count(scene.GetHot(i).ID)) modifiedIndices.push_back(i);
+		}//End for
+		scene.LoadCold(modifiedIndices);
+
+		SaveJob job;
+		job.chunkID = chunkID;
+		job.removedObjectIDs = removedIDs;
+		for (const int index : modifiedIndices) job.modifiedObjects.push_back(scene.Assemble(index));
+
+		const std::vector<SceneObject> submittedRows = job.modifiedObjects;
+		const std::unordered_set<int> submittedRemovals = job.removedObjectIDs;
+		std::unordered_set<int> submittedIDs;
+		for (const SceneObject& object : submittedRows) submittedIDs.insert(object.ID);
+
+		const auto start = std::chrono::steady_clock::now();
+		if (!autosave.Submit(std::move(job)))
+		{
+			fprintf(stderr, "FAILED: round %d couldn't submit its save\n", round);
+			return 1;
+		}//End if
+		modifiedIDs.clear();
+		removedIDs.clear();
+
+		//Keep editing while the worker writes - the rows just submitted first, so a save that read the live scene would show it
+		for (int i = 0; i < scene.GetSize(); i++)
+		{
+			SceneObjectHot& object = scene.GetHot(i);
+			if (!submittedIDs.count(object.ID)) continue;
+
+			object.posX += 100.0f;
+			modifiedIDs.insert(object.ID);
+		}//End for
+
+		int numConcurrentEdits = static_cast<int>(submittedIDs.size());
+		const int maxBatches = 10;
+		for (int batch = 0; batch < maxBatches && (batch == 0 || autosave.IsBusy()); batch++)
+		{
+			edit();
+			numConcurrentEdits += editsPerBatch;
+		}//End for
+
+		autosave.Flush();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		AutosaveService::Status status;
+		int rowsWritten;
+		SaveJob failedJob;
+		if (!autosave.PollCompletion(status, rowsWritten, failedJob) || status != AutosaveService::Status::SAVED)
+		{
+			fprintf(stderr, "FAILED: round %d's save didn't complete\n", round);
+			return 1;
+		}//End if
+
+		//The database must hold each row exactly as submitted, and none of the removed ones
+		std::unordered_map<int, SceneObject> savedRows;
+		database.ForEachObject(chunkID, [&savedRows](const SceneObject& object) { savedRows.emplace(object.ID, object); return true; });
+
+		int numMismatched = 0;
+		for (const SceneObject& object : submittedRows)
+		{
+			const auto saved = savedRows.find(object.ID);
+			if (saved == savedRows.end() || !RecordsEqual(SceneSchema::OBJECTS, object, saved->second)) numMismatched++;
+		}//End for
+		for (const int objectID : submittedRemovals)
+		{
+			if (savedRows.count(objectID)) numMismatched++;
+		}//End for
+
+		fprintf(stderr, "Round %d: %d rows and %d removals saved in %.3fs, with %d edits made meanwhile - %s\n", round,
+			static_cast<int>(submittedRows.size()), static_cast<int>(submittedRemovals.size()), elapsed.count(), numConcurrentEdits,
+			numMismatched == 0 ? "saved as submitted" : "MISMATCHED");
+		if (numMismatched > 0) numFailures++;
+	}//End for
+
+	autosave.Stop();
+
+	//The worker patched its snapshot from each job's rows rather than reading the chunk back - it must still match the database
+	ChunkObject chunk;
+	SceneGraph snapshotObjects, databaseObjects;
+	const bool snapshotRead = SceneSnapshot::Read(SceneSnapshot::GetPath(databasePath, chunkID), database.GetRevision(), chunkID, chunk, snapshotObjects);
+	database.ForEachObjectWithoutCold(chunkID, [&databaseObjects](const SceneObject& object) { databaseObjects.AddHot(object); return true; });
+	const int numSnapshotMismatched = snapshotRead ? CountMismatchedObjects(databaseObjects, snapshotObjects) : databaseObjects.GetSize();
+	if (!snapshotRead) fprintf(stderr, "FAILED: no snapshot for the database's current revision\n");
+	else fprintf(stderr, "Snapshot: %d of %d objects differ from the database\n", numSnapshotMismatched, databaseObjects.GetSize());
+
+	database.Close();
+	std::remove(SceneSnapshot::GetPath(databasePath, chunkID).c_str());
+	std::remove(databasePath.c_str());
+	std::remove((databasePath + "-wal").c_str());
+	std::remove((databasePath + "-shm").c_str());
+	return numFailures == 0 && numSnapshotMismatched == 0 ? 0 : 1;
+}//End TestAutosave
+
+//DisplayObject as it was before transforms moved into the TransformStore - same members, so the same stride
+struct FatDisplayObject
+{
+	std::shared_ptr<int>	model;
+	void*					texture;
+	std::wstring			modelPath;
+	std::wstring			texturePath;
+	int						ID;
+	float					position[3];
+	float					orientation[3];
+	float					scale[3];
+	bool					render;
+	bool					wireframe;
+	int						lightType;
+	float					light[10];
+};
+
+//Nearest object whose unit bounding sphere the ray (origin, normalised direction) passes through
+static int PickNearest(const float* translations, const int stride, const int numObjects, const float origin[3], const float direction[3])
+{
+	int nearest = -1;
+	float nearestDistance = 1e30f;
+	for (int i = 0; i < numObjects; i++)
+	{
+		const float* centre = translations + static_cast<size_t>(i) * stride;
+		const float toX = centre[0] - origin[0], toY = centre[1] - origin[1], toZ = centre[2] - origin[2];
+		const float along = toX * direction[0] + toY * direction[1] + toZ * direction[2];
+		const float missSquared = toX * toX + toY * toY + toZ * toZ - along * along;
+		if (along > 0.0f && missSquared <= 1.0f && along < nearestDistance)
+		{
+			nearestDistance = along;
+			nearest = i;
+		}//End if
+	}//End for
+
+	return nearest;
+}//End PickNearest
+
+static int BenchTransforms(const int numObjects)
+{
+	const int NUM_FRAMES = 20;
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f), angle(0.0f, 360.0f), size(0.5f, 2.0f);
+
+	//The same scene held both ways - fat objects in a vector, and slots in a transform store
+	std::vector<FatDisplayObject> fatObjects(numObjects);
+	TransformStore transforms;
+	for (int i = 0; i < numObjects; i++)
+	{
+		FatDisplayObject& object = fatObjects[i];
+		object.model = std::make_shared<int>(i);
+		object.modelPath = L"database/data/placeholder.cmo";
+		object.texturePath = L"database/data/placeholder.dds";
+		object.ID = i + 1;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			object.position[axis] = coordinate(random);
+			object.orientation[axis] = angle(random);
+			object.scale[axis] = size(random);
+		}//End for
+
+		const int slot = transforms.Allocate();
+		transforms.SetPosition(slot, object.position);
+		transforms.SetOrientation(slot, object.orientation);
+		transforms.SetScale(slot, object.scale);
+	}//End for
+
+	//Per-frame pass - build every object's world matrix
+	std::vector<float> fatMatrices(static_cast<size_t>(numObjects) * 16);
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < NUM_FRAMES; frame++)
+	{
+		for (int i = 0; i < numObjects; i++)
+		{
+			TransformStore::ComposeWorldMatrix(fatObjects[i].position, fatObjects[i].orientation, fatObjects[i].scale, &fatMatrices[static_cast<size_t>(i) * 16]);
+		}//End for
+	}//End for
+	const std::chrono::duration<double> fatFrameTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < NUM_FRAMES; frame++) transforms.UpdateAllWorldMatrices();
+	const std::chrono::duration<double> storeFrameTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	if (memcmp(fatMatrices.data(), transforms.GetWorldMatrix(0), fatMatrices.size() * sizeof(float)) != 0)
+	{
+		fprintf(stderr, "Transform store matrices don't match the per-object ones\n");
+		return 1;
+	}//End if
+
+	//Every cached inverse should undo its world matrix
+	float worstError = 0.0f;
+	for (int i = 0; i < numObjects; i++)
+	{
+		const float* world = transforms.GetWorldMatrix(i);
+		const float* inverse = transforms.GetInverseWorldMatrix(i);
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				float product = 0.0f;
+				for (int k = 0; k < 4; k++) product += world[row * 4 + k] * inverse[k * 4 + column];
+				worstError = std::max(worstError, std::fabs(product - (row == column ? 1.0f : 0.0f)));
+			}//End for
+		}//End for
+	}//End for
+	if (worstError > 1e-3f)
+	{
+		fprintf(stderr, "Cached inverse matrices are off by up to %g\n", worstError);
+		return 1;
+	}//End if
+
+	//Cached frames - an idle frame, and a frame where a drag moves one object
+	start = std::chrono::steady_clock::now();
+	int idleRecomputed = 0;
+	for (int frame = 0; frame < NUM_FRAMES; frame++) idleRecomputed += transforms.UpdateWorldMatrices();
+	const std::chrono::duration<double> idleFrameTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	start = std::chrono::steady_clock::now();
+	int dragRecomputed = 0;
+	for (int frame = 0; frame < NUM_FRAMES; frame++)
+	{
+		fatObjects[0].position[0] += 1.0f;
+		transforms.SetPosition(0, fatObjects[0].position);
+		dragRecomputed += transforms.UpdateWorldMatrices();
+	}//End for
+	const std::chrono::duration<double> dragFrameTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	//Picking pass - the old path rebuilt each object's matrix per click, the store already has them
+	const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	const float direction[3] = { 0.6f, 0.0f, 0.8f };
+	int fatPick = -1, storePick = -1;
+	float matrix[16];
+	std::vector<float> fatTranslations(static_cast<size_t>(numObjects) * 3);
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < NUM_FRAMES; frame++)
+	{
+		for (int i = 0; i < numObjects; i++)
+		{
+			TransformStore::ComposeWorldMatrix(fatObjects[i].position, fatObjects[i].orientation, fatObjects[i].scale, matrix);
+			memcpy(&fatTranslations[static_cast<size_t>(i) * 3], matrix + 12, 3 * sizeof(float));
+		}//End for
+		fatPick = PickNearest(fatTranslations.data(), 3, numObjects, origin, direction);
+	}//End for
+	const std::chrono::duration<double> fatPickTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < NUM_FRAMES; frame++) storePick = PickNearest(transforms.GetWorldMatrix(0) + 12, 16, numObjects, origin, direction);
+	const std::chrono::duration<double> storePickTime = (std::chrono::steady_clock::now() - start) / NUM_FRAMES;
+
+	if (fatPick != storePick)
+	{
+		fprintf(stderr, "Picking disagrees - %d against %d\n", fatPick, storePick);
+		return 1;
+	}//End if
+
+	fprintf(stderr, "%d objects, %d bytes per display object before, %d bytes of transform after\n", numObjects, static_cast<int>(sizeof(FatDisplayObject)), static_cast<int>((3 + 3 + 4 + 3 + 16 + 16) * sizeof(float) + 1));
+	fprintf(stderr, "World matrices: %.3fms per frame from display objects, %.3fms for a full rebuild of the transform store with inverses (%.1fx)\n",
+		fatFrameTime.count() * 1000.0, storeFrameTime.count() * 1000.0, fatFrameTime.count() / storeFrameTime.count());
+	fprintf(stderr, "Cached:         %.4fms for a frame without edits (%d matrices), %.4fms for a frame dragging one object (%d per frame)\n",
+		idleFrameTime.count() * 1000.0, idleRecomputed / NUM_FRAMES, dragFrameTime.count() * 1000.0, dragRecomputed / NUM_FRAMES);
+	fprintf(stderr, "Picking:        %.3fms per click from display objects, %.3fms from the transform store (%.1fx)\n",
+		fatPickTime.count() * 1000.0, storePickTime.count() * 1000.0, fatPickTime.count() / storePickTime.count());
+	return 0;
+}//End BenchTransforms
+
+//A synthetic hierarchy - each object's parent is always an earlier object, or NO_PARENT
+struct HierarchyShape
+{
+	const char*			name;
+	std::vector<int>	parents;
+	int					movedRoot;				//Root dragged in the move test
+	bool				unitScale;				//Scale compounds down a long chain until float error swamps the spot check
+};
+
+static void BuildHierarchy(TransformStore& transforms, const std::vector<int>& parents, const bool unitScale)
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> offset(-10.0f, 10.0f), angle(-30.0f, 30.0f), size(0.8f, 1.25f);
+	for (size_t i = 0; i < parents.size(); i++)
+	{
+		const float position[3] = { offset(random), offset(random), offset(random) };
+		const float orientation[3] = { angle(random), angle(random), angle(random) };
+		float scale[3] = { size(random), size(random), size(random) };
+		if (unitScale) scale[0] = scale[1] = scale[2] = 1.0f;
+
+		const int slot = transforms.Allocate();
+		transforms.SetPosition(slot, position);
+		transforms.SetOrientation(slot, orientation);
+		transforms.SetScale(slot, scale);
+		if (parents[i] != TransformStore::NO_PARENT) transforms.SetParent(slot, parents[i]);
+	}//End for
+	transforms.UpdateAllWorldMatrices();
+}//End BuildHierarchy
+
+//Mark every root changed, so the next update rebuilds the whole hierarchy
+static void TouchRoots(TransformStore& transforms)
+{
+	float position[3];
+	for (int slot = 0; slot < transforms.GetNumSlots(); slot++)
+	{
+		if (transforms.GetParent(slot) != TransformStore::NO_PARENT) continue;
+		transforms.GetPosition(slot, position);
+		transforms.SetPosition(slot, position);
+	}//End for
+}//End TouchRoots
+
+//World matrix of a slot worked out the slow way - its local matrix through every ancestor's in turn, in double precision
+static void ComposeThroughAncestors(const TransformStore& transforms, const int slot, float matrix[16])
+{
+	float position[3], orientation[3], scale[3], local[16];
+	double composed[16], product[16];
+	transforms.GetPosition(slot, position);
+	transforms.GetOrientation(slot, orientation);
+	transforms.GetScale(slot, scale);
+	TransformStore::ComposeWorldMatrix(position, orientation, scale, local);
+	for (int element = 0; element < 16; element++) composed[element] = local[element];
+
+	for (int ancestor = transforms.GetParent(slot); ancestor != TransformStore::NO_PARENT; ancestor = transforms.GetParent(ancestor))
+	{
+		transforms.GetPosition(ancestor, position);
+		transforms.GetOrientation(ancestor, orientation);
+		transforms.GetScale(ancestor, scale);
+		TransformStore::ComposeWorldMatrix(position, orientation, scale, local);
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				product[row * 4 + column] = 0.0;
+				for (int k = 0; k < 4; k++) product[row * 4 + column] += composed[row * 4 + k] * local[k * 4 + column];
+			}//End for
+		}//End for
+		memcpy(composed, product, sizeof(product));
+	}//End for
+
+	for (int element = 0; element < 16; element++) matrix[element] = static_cast<float>(composed[element]);
+}//End ComposeThroughAncestors
+
+static int BenchHierarchy(const int numObjects)
+{
+	const int NUM_FRAMES = 20;
+	const int PROPS_PER_BUILDING = 200;
+	const int CHAIN_LENGTH = 1000;
+	const int ATTACHED_DESCENDANTS = std::min(10000, numObjects - 1);
+
+	std::vector<HierarchyShape> shapes(3);
+
+	//Wide - buildings with their props attached, two levels
+	shapes[0].name = "wide (buildings of 200 props)";
+	for (int i = 0; i < numObjects; i++) shapes[0].parents.push_back(i % (PROPS_PER_BUILDING + 1) == 0 ? TransformStore::NO_PARENT : i - i % (PROPS_PER_BUILDING + 1));
+	shapes[0].movedRoot = 0;
+	shapes[0].unitScale = false;
+
+	//Deep - long chains, one object per level
+	shapes[1].name = "deep (chains of 1000)";
+	for (int i = 0; i < numObjects; i++) shapes[1].parents.push_back(i % CHAIN_LENGTH == 0 ? TransformStore::NO_PARENT : i - 1);
+	shapes[1].movedRoot = 0;
+	shapes[1].unitScale = true;
+
+	//One root carrying 10k descendants - a hundred per group, three levels deep - in a level of otherwise loose objects
+	shapes[2].name = "one root with 10k descendants";
+	shapes[2].parents.push_back(TransformStore::NO_PARENT);
+	for (int i = 1; i < numObjects; i++)
+	{
+		if (i > ATTACHED_DESCENDANTS) shapes[2].parents.push_back(TransformStore::NO_PARENT);
+		else if (i <= 100) shapes[2].parents.push_back(0);
+		else shapes[2].parents.push_back(1 + (i - 101) % 100);
+	}//End for
+	shapes[2].movedRoot = 0;
+	shapes[2].unitScale = false;
+
+	WorkerPool workers;
+	fprintf(stderr, "%d objects, %d threads\n", numObjects, workers.GetNumThreads());
+
+	for (const HierarchyShape& shape : shapes)
+	{
+		//The same hierarchy twice, one updated serially and one on the pool, which must come out identical
+		TransformStore serial, parallel;
+		BuildHierarchy(serial, shape.parents, shape.unitScale);
+		BuildHierarchy(parallel, shape.parents, shape.unitScale);
+
+		std::chrono::duration<double> serialFullTime(0), parallelFullTime(0);
+		for (int frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			TouchRoots(serial);
+			auto start = std::chrono::steady_clock::now();
+			serial.UpdateWorldMatrices();
+			serialFullTime += std::chrono::steady_clock::now() - start;
+
+			TouchRoots(parallel);
+			start = std::chrono::steady_clock::now();
+			parallel.UpdateWorldMatrices(&workers);
+			parallelFullTime += std::chrono::steady_clock::now() - start;
+		}//End for
+
+		//Dragging one root - everything under it follows
+		std::chrono::duration<double> serialMoveTime(0), parallelMoveTime(0);
+		int numMoved = 0;
+		float position[3];
+		for (int frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			serial.GetPosition(shape.movedRoot, position);
+			position[0] += 0.5f;
+			serial.SetPosition(shape.movedRoot, position);
+			auto start = std::chrono::steady_clock::now();
+			numMoved = serial.UpdateWorldMatrices();
+			serialMoveTime += std::chrono::steady_clock::now() - start;
+
+			parallel.SetPosition(shape.movedRoot, position);
+			start = std::chrono::steady_clock::now();
+			parallel.UpdateWorldMatrices(&workers);
+			parallelMoveTime += std::chrono::steady_clock::now() - start;
+		}//End for
+
+		if (memcmp(serial.GetWorldMatrix(0), parallel.GetWorldMatrix(0), static_cast<size_t>(numObjects) * 16 * sizeof(float)) != 0 ||
+			memcmp(serial.GetInverseWorldMatrix(0), parallel.GetInverseWorldMatrix(0), static_cast<size_t>(numObjects) * 16 * sizeof(float)) != 0)
+		{
+			fprintf(stderr, "%s: parallel update differs from the serial one\n", shape.name);
+			return 1;
+		}//End if
+
+		//Spot check against matrices composed through each ancestor in turn
+		for (int slot = 0; slot < numObjects; slot += std::max(numObjects / 97, 1))
+		{
+			float expected[16];
+			ComposeThroughAncestors(serial, slot, expected);
+			const float* actual = serial.GetWorldMatrix(slot);
+			for (int element = 0; element < 16; element++)
+			{
+				if (std::fabs(actual[element] - expected[element]) > 1e-3f * (1.0f + std::fabs(expected[element])))
+				{
+					fprintf(stderr, "%s: slot %d's world matrix is off - %g against %g\n", shape.name, slot, actual[element], expected[element]);
+					return 1;
+				}//End if
+			}//End for
+		}//End for
+
+		fprintf(stderr, "%-32s %4d levels - whole hierarchy %.3fms serial, %.3fms parallel (%.1fx); moving a root rebuilds %d in %.3fms serial, %.3fms parallel\n",
+			shape.name, serial.GetNumLevels(), serialFullTime.count() * 1000.0 / NUM_FRAMES, parallelFullTime.count() * 1000.0 / NUM_FRAMES,
+			serialFullTime.count() / parallelFullTime.count(), numMoved, serialMoveTime.count() * 1000.0 / NUM_FRAMES, parallelMoveTime.count() * 1000.0 / NUM_FRAMES);
+	}//End for
+
+	return 0;
+}//End BenchHierarchy
+
+static int BenchComponents(const int numObjects)
+{
+	const int NUM_PASSES = 50;
+	const int LIGHT_SPACING = 100;					//1% of objects are lights
+
+	//A dressed level - mostly props, with the odd light, AI node and sound
+	std::vector<SceneObject> fatObjects(numObjects);
+	for (int i = 0; i < numObjects; i++)
+	{
+		SceneObject& object = fatObjects[i];
+		object.ID = i + 1;
+		object.model_path = "database/data/placeholder.cmo";
+		object.tex_diffuse_path = "database/data/placeholder.dds";
+		object.posX = static_cast<float>(i % 1000);
+		object.posZ = static_cast<float>(i / 1000);
+		object.name = "Prop " + std::to_string(i);
+		if (i % LIGHT_SPACING == 0)
+		{
+			object.light_type = 2;
+			object.light_diffuse_r = static_cast<float>(i % 7) / 7.0f;
+			object.light_linear = 0.5f;
+		}//End if
+		if (i % 250 == 1) object.AINode = true;
+		if (i % 500 == 2)
+		{
+			object.audio_path = "database/data/ambience.wav";
+			object.volume = 1.0f;
+		}//End if
+	}//End for
+
+	SceneGraph sceneGraph;
+	sceneGraph.Reserve(numObjects);
+	for (const SceneObject& object : fatObjects) sceneGraph.Add(object);
+
+	//Before - a light pass has to visit every object to find the few that are lights
+	float fatSum = 0.0f;
+	int fatLights = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		for (const SceneObject& object : fatObjects)
+		{
+			if (object.light_type != 2) continue;
+			fatSum += object.light_diffuse_r * object.light_linear;
+			fatLights++;
+		}//End for
+	}//End for
+	const std::chrono::duration<double> fatTime = (std::chrono::steady_clock::now() - start) / NUM_PASSES;
+
+	//After - the light pool holds the lights and nothing else
+	const ComponentPool<LightComponent>& lights = sceneGraph.GetLights();
+	float poolSum = 0.0f;
+	int poolLights = 0;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		for (int i = 0; i < lights.GetSize(); i++)
+		{
+			const LightComponent& light = lights.GetAt(i);
+			poolSum += light.light_diffuse_r * light.light_linear;
+			poolLights++;
+		}//End for
+	}//End for
+	const std::chrono::duration<double> poolTime = (std::chrono::steady_clock::now() - start) / NUM_PASSES;
+
+	//Asking each object whether it has a light, as per-object tools do
+	int lookupLights = 0;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		for (int i = 0; i < sceneGraph.GetSize(); i++)
+		{
+			if (lights.Has(sceneGraph.GetHot(i).ID)) lookupLights++;
+		}//End for
+	}//End for
+	const std::chrono::duration<double> lookupTime = (std::chrono::steady_clock::now() - start) / NUM_PASSES;
+
+	//Pool iteration order differs from object order, so the sums are compared with a tolerance
+	if (fatLights != poolLights || fatLights != lookupLights || std::fabs(fatSum - poolSum) > 1e-3f * (1.0f + std::fabs(fatSum)))
+	{
+		fprintf(stderr, "Light passes disagree - %d and %d lights, %d found by lookup, sums %g and %g\n", fatLights, poolLights, lookupLights, fatSum, poolSum);
+		return 1;
+	}//End if
+
+	//Check every object survives the split into records and components
+	for (int i = 0; i < numObjects; i++)
+	{
+		const SceneObject joined = sceneGraph.Assemble(i);
+		const SceneObject& original = fatObjects[i];
+		if (joined.light_type != original.light_type || joined.light_diffuse_r != original.light_diffuse_r || joined.light_linear != original.light_linear ||
+			joined.AINode != original.AINode || joined.audio_path != original.audio_path || joined.volume != original.volume)
+		{
+			fprintf(stderr, "Object %d differs after the split\n", original.ID);
+			return 1;
+		}//End if
+	}//End for
+
+	const SceneGraph::MemoryUsage usage = sceneGraph.GetMemoryUsage();
+	fprintf(stderr, "%d objects - %d lights, %d audio sources, %d AI nodes, %d path nodes\n", numObjects, lights.GetSize(),
+		sceneGraph.GetAudio().GetSize(), sceneGraph.GetAINodes().GetSize(), sceneGraph.GetPathNodes().GetSize());
+	fprintf(stderr, "Plain prop:   %d bytes as a SceneObject, %d as hot and cold records with no components\n",
+		static_cast<int>(sizeof(SceneObject)), static_cast<int>(sizeof(SceneObjectHot) + sizeof(SceneObjectCold)));
+	fprintf(stderr, "Components:   %.1f KB in every pool, %.2f bytes per object\n", usage.componentBytes / 1024.0, static_cast<double>(usage.componentBytes) / numObjects);
+	fprintf(stderr, "Light pass:   %.3fms scanning SceneObjects, %.3fms over the light pool (%.1fx)\n",
+		fatTime.count() * 1000.0, poolTime.count() * 1000.0, fatTime.count() / poolTime.count());
+	fprintf(stderr, "Light lookup: %.3fms asking every object for its light\n", lookupTime.count() * 1000.0);
+	return 0;
+}//End BenchComponents
+
+//Everything a vector of SceneObjects holds - the records plus what their strings allocate
+static size_t GetSceneObjectBytes(const std::vector<SceneObject>& objects)
+{
+	size_t bytes = objects.capacity() * sizeof(SceneObject);
+	for (const SceneObject& object : objects)
+	{
+		bytes += SceneGraph::GetStringHeapBytes(object.model_path) + SceneGraph::GetStringHeapBytes(object.tex_diffuse_path) +
+			SceneGraph::GetStringHeapBytes(object.collision_mesh) + SceneGraph::GetStringHeapBytes(object.audio_path) + SceneGraph::GetStringHeapBytes(object.name);
+	}//End for
+
+	return bytes;
+}//End GetSceneObjectBytes
+
+static int MemoryReport(const int numObjects, const bool printJSON)
+{
+	const int NUM_PASSES = 20;
+	const std::string path = "memory_report.db";
+	std::remove(path.c_str());
+
+	//A level whose objects all have names and asset paths, as a dressed level would, and one in a hundred of which is a light
+	SceneDatabase database;
+	if (!database.Open(path.c_str(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) ||
+		sqlite3_exec(database.GetConnection(), SceneSchema::CreateTableSQL(SceneSchema::OBJECTS).c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		fprintf(stderr, "Can't create '%s'\n", path.c_str());
+		return 1;
+	}//End if
+
+	{
+		std::vector<SceneObject> objects(numObjects);
+		for (int i = 0; i < numObjects; i++)
+		{
+			objects[i].ID = i + 1;
+			objects[i].model_path = "database/data/placeholder.cmo";
+			objects[i].tex_diffuse_path = "database/data/placeholder.dds";
+			objects[i].posX = static_cast<float>(i % 1000);
+			objects[i].posZ = static_cast<float>(i / 1000);
+			objects[i].scaX = objects[i].scaY = objects[i].scaZ = 1.0f;
+			objects[i].name = "Rock cluster " + std::to_string(i);
+			if (i % 100 == 0) objects[i].light_type = 2;
+		}//End for
+		if (database.SaveAllObjects(objects) < 0) return 1;
+	}
+
+	//Before - every column of every object, as the scene graph used to hold them
+	auto start = std::chrono::steady_clock::now();
+	std::vector<SceneObject> fatObjects;
+	if (!database.LoadObjects(0, fatObjects)) return 1;
+	const std::chrono::duration<double> fatLoadTime = std::chrono::steady_clock::now() - start;
+
+	//After - hot records with interned asset paths and components, with cold records left in the database
+	start = std::chrono::steady_clock::now();
+	SceneGraph sceneGraph;
+	if (!database.ForEachObjectWithoutCold(0, [&sceneGraph](const SceneObject& object) { sceneGraph.AddHot(object); return true; })) return 1;
+	const std::chrono::duration<double> hotLoadTime = std::chrono::steady_clock::now() - start;
+	const SceneGraph::MemoryUsage hotUsage = sceneGraph.GetMemoryUsage();
+
+	//A pass like the ones editing makes - read every transform
+	float fatSum = 0.0f, hotSum = 0.0f;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		for (const SceneObject& object : fatObjects) fatSum += object.posX + object.posZ + object.scaY;
+	}//End for
+	const std::chrono::duration<double> fatPassTime = (std::chrono::steady_clock::now() - start) / NUM_PASSES;
+
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		for (int i = 0; i < sceneGraph.GetSize(); i++) hotSum += sceneGraph.GetHot(i).posX + sceneGraph.GetHot(i).posZ + sceneGraph.GetHot(i).scaY;
+	}//End for
+	const std::chrono::duration<double> hotPassTime = (std::chrono::steady_clock::now() - start) / NUM_PASSES;
+
+	//What the select dialogue, which reads every name, costs, and what is resident afterwards
+	sceneGraph.SetColdSource([&database](const std::vector<int>& objectIDs, const std::function<bool(const SceneObject&)>& visitor)
+	{
+		return objectIDs.empty() ? database.ForEachObject(0, visitor) : database.ForEachObjectWithID(objectIDs, visitor);
+	});
+	start = std::chrono::steady_clock::now();
+	sceneGraph.LoadCold();
+	const std::chrono::duration<double> coldLoadTime = std::chrono::steady_clock::now() - start;
+	const SceneGraph::MemoryUsage fullUsage = sceneGraph.GetMemoryUsage();
+
+	//The same accounting the editor's report uses - the asset path table registers itself
+	const MemoryTracker::Registration sceneGraphMemory = MemoryTracker::GetInstance().Register(MemoryCategory::SCENE_RECORDS, "scene graph",
+		[&sceneGraph]() { return sceneGraph.GetMemoryUsage().GetTotal(); });
+	const MemoryTracker::Report report = MemoryTracker::GetInstance().GetReport();
+	if (report.Get(MemoryCategory::SCENE_RECORDS).GetTotal() != fullUsage.GetTotal() ||
+		report.Get(MemoryCategory::STRINGS).GetTotal() != AssetPathTable::GetInstance().GetMemoryUsage())
+	{
+		fprintf(stderr, "Memory tracker disagrees with the scene graph and asset table\n");
+		return 1;
+	}//End if
+	if (printJSON) std::cout << report.ToJSON();
+
+	//Check nothing was lost in the split
+	for (int i = 0; i < numObjects; i++)
+	{
+		const SceneObject joined = sceneGraph.Assemble(i);
+		if (joined.ID != fatObjects[i].ID || joined.name != fatObjects[i].name || joined.model_path != fatObjects[i].model_path || joined.posZ != fatObjects[i].posZ || joined.editor_render != fatObjects[i].editor_render ||
+			joined.light_type != fatObjects[i].light_type)
+		{
+			fprintf(stderr, "Object %d differs after the split\n", fatObjects[i].ID);
+			return 1;
+		}//End if
+	}//End for
+
+	const double fatBytes = static_cast<double>(GetSceneObjectBytes(fatObjects));
+	const size_t assetBytes = AssetPathTable::GetInstance().GetMemoryUsage();
+	fprintf(stderr, "%d objects - SceneObject is %d bytes, SceneObjectHot %d, SceneObjectCold %d\n", numObjects,
+		static_cast<int>(sizeof(SceneObject)), static_cast<int>(sizeof(SceneObjectHot)), static_cast<int>(sizeof(SceneObjectCold)));
+	fprintf(stderr, "Before:            %7.1f bytes per object (%.2f MB), loaded in %.3fs\n", fatBytes / numObjects, fatBytes / 1048576.0, fatLoadTime.count());
+	fprintf(stderr, "After, cold unread: %7.1f bytes per object (%.2f MB) - %.1f hot, %.1f cold, %.1f components - loaded in %.3fs\n",
+		static_cast<double>(hotUsage.GetTotal()) / numObjects, hotUsage.GetTotal() / 1048576.0, static_cast<double>(hotUsage.hotBytes) / numObjects,
+		static_cast<double>(hotUsage.coldBytes) / numObjects, static_cast<double>(hotUsage.componentBytes) / numObjects, hotLoadTime.count());
+	fprintf(stderr, "After, cold read:   %7.1f bytes per object (%.2f MB), cold read in %.3fs\n",
+		static_cast<double>(fullUsage.GetTotal()) / numObjects, fullUsage.GetTotal() / 1048576.0, coldLoadTime.count());
+	fprintf(stderr, "Asset path table:   %d paths in %.1f KB, shared by every object\n", AssetPathTable::GetInstance().GetSize(), assetBytes / 1024.0);
+	fprintf(stderr, "Tracked:            %.2f MB over every category\n", report.GetTotal() / 1048576.0);
+	fprintf(stderr, "Transform pass:     %.3fms over SceneObjects, %.3fms over hot records (%.1fx)%s\n",
+		fatPassTime.count() * 1000.0, hotPassTime.count() * 1000.0, fatPassTime.count() / hotPassTime.count(), fatSum == hotSum ? "" : " - sums differ");
+
+	database.Close();
+	std::remove(path.c_str());
+	return fatSum == hotSum ? 0 : 1;
+}//End MemoryReport
+
+static int BenchTextures(const int numObjects)
+{
+	const int NUM_TEXTURES = 64;
+	const int NUM_MISSING = 8;						//Paths with no file behind them
+	const int MISSING_SPACING = 16;					//Every 16th object has a missing texture
+	const size_t TEXTURE_BYTES = 64 * 1024;
+
+	//Stands in for reading a DDS file - the error texture and the first NUM_TEXTURES paths exist, the rest don't
+	AssetPathTable& assetPaths = AssetPathTable::GetInstance();
+	const AssetID errorPath = assetPaths.Intern(std::string("database/data/Error.dds"));
+	std::vector<AssetID> texturePaths(NUM_TEXTURES + NUM_MISSING);
+	for (int i = 0; i < NUM_TEXTURES + NUM_MISSING; i++) texturePaths[i] = assetPaths.Intern("database/data/texture" + std::to_string(i) + ".dds");
+
+	int numLoads = 0;
+	const auto load = [&](const AssetID path, std::vector<unsigned char>& texture)
+	{
+		numLoads++;
+		if (path != errorPath && std::find(texturePaths.begin(), texturePaths.begin() + NUM_TEXTURES, path) == texturePaths.begin() + NUM_TEXTURES) return false;
+
+		texture.assign(TEXTURE_BYTES, static_cast<unsigned char>(path));
+		return true;
+	};
+	ResourceCache<std::vector<unsigned char>> cache(load, [](const std::vector<unsigned char>& texture) { return texture.size(); }, errorPath);
+
+	std::vector<AssetID> objectTextures(numObjects);
+	std::unordered_set<AssetID> usedTextures, usedMissing;
+	int numMissingObjects = 0;
+	for (int i = 0; i < numObjects; i++)
+	{
+		const bool missing = i % MISSING_SPACING == 0;
+		objectTextures[i] = missing ? texturePaths[NUM_TEXTURES + (i / MISSING_SPACING) % NUM_MISSING] : texturePaths[i % NUM_TEXTURES];
+		(missing ? usedMissing : usedTextures).insert(objectTextures[i]);
+		if (missing) numMissingObjects++;
+	}//End for
+
+	//Before - every object loads its own copy, and every failure loads the error texture again on top
+	const long long uncachedLoads = static_cast<long long>(numObjects) + numMissingObjects;
+	const double uncachedMB = static_cast<double>(numObjects) * TEXTURE_BYTES / 1048576.0;
+
+	//After - one load per path, and one error texture shared by every failure
+	std::vector<ResourceCache<std::vector<unsigned char>>::Handle> handles(numObjects);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < numObjects; i++) handles[i] = cache.Acquire(objectTextures[i]);
+	const std::chrono::duration<double> acquireTime = std::chrono::steady_clock::now() - start;
+	const ResourceCache<std::vector<unsigned char>>::Stats loaded = cache.GetStats();
+
+	const int numUsed = static_cast<int>(usedTextures.size());
+	const int numUsedMissing = static_cast<int>(usedMissing.size());
+	const int expectedLoads = numUsed + numUsedMissing + (numUsedMissing > 0 ? 1 : 0);
+	if (numLoads != expectedLoads || loaded.misses != numUsed + numUsedMissing || loaded.failures != numUsedMissing ||
+		loaded.numResident != numUsed + (numUsedMissing > 0 ? 1 : 0) || loaded.residentBytes != static_cast<size_t>(loaded.numResident) * TEXTURE_BYTES)
+	{
+		fprintf(stderr, "Cache loaded %d times for %d resident textures, expected %d loads\n", numLoads, loaded.numResident, expectedLoads);
+		return 1;
+	}//End if
+
+	//Every object sees its own texture, or the shared error texture if its own is missing
+	for (int i = 0; i < numObjects; i++)
+	{
+		const bool missing = i % MISSING_SPACING == 0;
+		const AssetID expected = missing ? errorPath : objectTextures[i];
+		if (handles[i].GetPath() != expected || handles[i].GetResource().size() != TEXTURE_BYTES || handles[i].GetResource()[0] != static_cast<unsigned char>(expected))
+		{
+			fprintf(stderr, "Object %d has the wrong texture\n", i);
+			return 1;
+		}//End if
+	}//End for
+
+	//One count per object, plus the cache's own hold on the error texture
+	long long totalRefs = 0;
+	for (const AssetID path : usedTextures) totalRefs += cache.GetRefCount(path);
+	if (numUsedMissing > 0) totalRefs += cache.GetRefCount(errorPath) - 1;
+	if (totalRefs != numObjects)
+	{
+		fprintf(stderr, "Reference counts add up to %lld for %d objects\n", totalRefs, numObjects);
+		return 1;
+	}//End if
+
+	//Dropping every user of a texture evicts it, and the next user loads it again - texture 0 is on no object, as every
+	//16th object's texture is missing
+	start = std::chrono::steady_clock::now();
+	ResourceCache<std::vector<unsigned char>>::Handle first = cache.Acquire(texturePaths[0]);
+	ResourceCache<std::vector<unsigned char>>::Handle second = first;
+	first.Reset();
+	second.Reset();
+	if (cache.GetRefCount(texturePaths[0]) != 0 || cache.GetStats().evictions != 1 || cache.GetStats().numResident != loaded.numResident)
+	{
+		fprintf(stderr, "Texture is still resident after its last user went\n");
+		return 1;
+	}//End if
+	first = cache.Acquire(texturePaths[0]);
+	if (numLoads != expectedLoads + 2 || first.GetRefCount() != 1)
+	{
+		fprintf(stderr, "Evicted texture wasn't loaded again\n");
+		return 1;
+	}//End if
+
+	//Once every object has gone only the error texture, and the texture still held here, are left
+	for (ResourceCache<std::vector<unsigned char>>::Handle& handle : handles) handle.Reset();
+	const ResourceCache<std::vector<unsigned char>>::Stats released = cache.GetStats();
+	if (released.numResident != 1 + (numUsedMissing > 0 ? 1 : 0) || released.residentBytes != static_cast<size_t>(released.numResident) * TEXTURE_BYTES)
+	{
+		fprintf(stderr, "%d textures still resident after every object went\n", released.numResident);
+		return 1;
+	}//End if
+
+	//Clearing forgets every path, but textures still held stay valid until their last handle goes
+	cache.Clear();
+	if (first.GetResource().size() != TEXTURE_BYTES || first.GetRefCount() != 1 || cache.GetStats().numResident != 0)
+	{
+		fprintf(stderr, "Clear released a texture still in use\n");
+		return 1;
+	}//End if
+	first.Reset();
+	const std::chrono::duration<double> releaseTime = std::chrono::steady_clock::now() - start;
+
+	fprintf(stderr, "%d objects using %d textures, %d objects with one of %d missing textures\n", numObjects, numUsed, numMissingObjects, numUsedMissing);
+	fprintf(stderr, "Per object:   %lld loads, %.1f MB resident\n", uncachedLoads, uncachedMB);
+	fprintf(stderr, "Cached:       %d loads, %.1f MB resident in %d textures, %.1f%% hits\n", expectedLoads, loaded.residentBytes / 1048576.0, loaded.numResident, loaded.GetHitRate() * 100.0);
+	fprintf(stderr, "Acquire:      %.3fms for every object, release %.3fms\n", acquireTime.count() * 1000.0, releaseTime.count() * 1000.0);
+	return 0;
+}//End BenchTextures
+
+//One level load for bench-streaming - objects refer to assets by path, as display objects do
+struct StreamedLevelTimes
+{
+	double	firstFrame;								//Until every object is in the list, placeholders included
+	double	allResident;							//Until no object is a placeholder
+	int		numFrames;
+	int		numLoads;
+	int		numThreads;								//Loader threads
+};
+
+static bool LoadStreamedLevel(const int numObjects, const std::vector<AssetID>& assetPaths, const bool streamed, StreamedLevelTimes& times)
+{
+	using AssetCache = ResourceCache<std::vector<unsigned char>>;
+	const std::chrono::milliseconds LOAD_TIME(2);	//Reading and parsing one mesh
+	const size_t ASSET_BYTES = 64 * 1024;
+
+	//Stands in for a CMO load - safe on any thread
+	std::atomic<int> numLoads(0);
+	const auto load = [&](const AssetID path, std::vector<unsigned char>& asset)
+	{
+		std::this_thread::sleep_for(LOAD_TIME);
+		asset.assign(ASSET_BYTES, static_cast<unsigned char>(path));
+		numLoads++;
+		return true;
+	};
+	AssetCache cache(load, [](const std::vector<unsigned char>& asset) { return asset.size(); }, AssetPathTable::NO_ASSET);
+
+	struct Object
+	{
+		AssetID				path;
+		AssetCache::Handle	asset;					//Null while a placeholder
+	};
+	std::vector<Object> objects(numObjects);
+
+	//Placeholders take what is resident and request the rest, each path once - as Game::ResolveStreamedAssets does
+	AssetStreamer streamer;
+	std::unordered_set<AssetID> inFlight;
+	std::vector<AssetCache::Handle> arrived;		//Held until the placeholders waiting on them have picked them up
+	const auto resolve = [&](Object& object)
+	{
+		object.asset = cache.Find(object.path);
+		if (object.asset || !inFlight.insert(object.path).second) return;
+
+		const AssetID path = object.path;
+		streamer.Submit([&load, &inFlight, &arrived, &cache, path]()
+		{
+			std::vector<unsigned char> asset;
+			load(path, asset);
+			return AssetStreamer::Completion([&inFlight, &arrived, &cache, path, asset]()
+			{
+				inFlight.erase(path);
+				arrived.push_back(cache.Insert(path, asset));
+			});
+		});
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < numObjects; i++)
+	{
+		objects[i].path = assetPaths[i % assetPaths.size()];
+		if (streamed) resolve(objects[i]);
+		else objects[i].asset = cache.Acquire(objects[i].path);
+	}//End for
+	times.firstFrame = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	//Frames - completions applied at the boundary, then placeholders swapped for what has arrived
+	times.numFrames = 0;
+	for (int numPlaceholders = streamed ? numObjects : 0; numPlaceholders > 0; times.numFrames++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		streamer.ApplyCompletions();
+
+		numPlaceholders = 0;
+		for (Object& object : objects)
+		{
+			if (object.asset) continue;
+
+			resolve(object);
+			if (!object.asset) numPlaceholders++;
+		}//End for
+		arrived.clear();
+	}//End for
+	times.allResident = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	times.numLoads = numLoads;
+	times.numThreads = streamer.GetNumThreads();
+
+	//Every object ends up with its own asset, each loaded once
+	for (const Object& object : objects)
+	{
+		if (object.asset.GetPath() != object.path || object.asset.GetResource().size() != ASSET_BYTES || object.asset.GetResource()[0] != static_cast<unsigned char>(object.path)) return false;
+	}//End for
+
+	const int numUsed = std::min(numObjects, static_cast<int>(assetPaths.size()));
+	return times.numLoads == numUsed && cache.GetStats().numResident == numUsed;
+}//End LoadStreamedLevel
+
+static int BenchStreaming(const int numObjects)
+{
+	const int NUM_ASSETS = 200;
+
+	std::vector<AssetID> assetPaths(NUM_ASSETS);
+	for (int i = 0; i < NUM_ASSETS; i++) assetPaths[i] = AssetPathTable::GetInstance().Intern("database/data/mesh" + std::to_string(i) + ".cmo");
+
+	//A small level and the full one, so the first frame's dependence on level size shows
+	const int levelSizes[] = { std::max(numObjects / 10, 1), numObjects };
+	for (const int levelSize : levelSizes)
+	{
+		StreamedLevelTimes blocking, streamed;
+		if (!LoadStreamedLevel(levelSize, assetPaths, false, blocking) || !LoadStreamedLevel(levelSize, assetPaths, true, streamed))
+		{
+			fprintf(stderr, "%d objects - an object is missing its asset, or an asset was loaded more than once\n", levelSize);
+			return 1;
+		}//End if
+
+		fprintf(stderr, "%d objects, %d meshes:\n", levelSize, streamed.numLoads);
+		fprintf(stderr, "  Blocking:  first frame after %.1fms\n", blocking.firstFrame * 1000.0);
+		fprintf(stderr, "  Streamed:  first frame after %.1fms, every mesh resident after %.1fms and %d frames on %d loader threads\n",
+			streamed.firstFrame * 1000.0, streamed.allResident * 1000.0, streamed.numFrames, streamed.numThreads);
+	}//End for
+
+	return 0;
+}//End BenchStreaming
+
+//Resident memory from /proc/self/status - zeros where there is no /proc
+struct ResidentMemory
+{
+	size_t	peakBytes;								//Since the peak was last reset
+	size_t	anonymousBytes;							//Heap and other private memory
+	size_t	fileBytes;								//Mapped file pages - clean, so the kernel can drop them and read them back
+};
+
+static ResidentMemory GetResidentMemory()
+{
+	ResidentMemory memory = {};
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		const size_t bytes = static_cast<size_t>(atoll(line.c_str() + line.find(':') + 1)) * 1024;
+		if (line.compare(0, 6, "VmHWM:") == 0) memory.peakBytes = bytes;
+		else if (line.compare(0, 8, "RssAnon:") == 0) memory.anonymousBytes = bytes;
+		else if (line.compare(0, 8, "RssFile:") == 0) memory.fileBytes = bytes;
+	}//End while
+
+	return memory;
+}//End GetResidentMemory
+
+//Starts the peak over from what is resident now
+static void ResetPeakResidentMemory()
+{
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+}//End ResetPeakResidentMemory
+
+//Model files directly in the directory - none if it can't be listed
+static std::vector<std::string> ListModelFiles(const std::string& directory)
+{
+	std::vector<std::string> names;
+#ifdef _WIN32
+	WIN32_FIND_DATAA found;
+	const HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+	if (search != INVALID_HANDLE_VALUE)
+	{
+		do names.push_back(found.cFileName); while (FindNextFileA(search, &found));
+		FindClose(search);
+	}//End if
+#else
+	if (DIR* const listing = opendir(directory.c_str()))
+	{
+		while (const dirent* const entry = readdir(listing)) names.push_back(entry->d_name);
+		closedir(listing);
+	}//End if
+#endif
+
+	std::vector<std::string> paths;
+	for (const std::string& name : names)
+	{
+		const size_t dot = name.rfind('.');
+		const std::string extension = dot == std::string::npos ? "" : name.substr(dot);
+		if (extension == ".cmo" || extension == ".sdkmesh" || extension == ".vbo") paths.push_back(directory + "/" + name);
+	}//End for
+
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}//End ListModelFiles
+
+//A one-mesh CMO file of the layout Model::CreateFromCMO parses - names are UTF-16, as Visual Studio writes them
+static bool WriteSyntheticCMO(const std::string& path, const int numVertices, const unsigned seed, const bool skinned = false)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	const auto put = [&file](const void* bytes, const size_t size) { file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size)); };
+	const auto putUInt = [&put](const uint32_t value) { put(&value, sizeof(value)); };
+	const auto putName = [&put, &putUInt](const char* name)
+	{
+		putUInt(static_cast<uint32_t>(strlen(name)));
+		for (const char* c = name; *c; c++)
+		{
+			const uint16_t character = static_cast<uint16_t>(*c);
+			put(&character, sizeof(character));
+		}//End for
+	};
+
+	putUInt(1);										//Meshes
+	putName("mesh");
+
+	putUInt(1);										//Materials
+	putName("material");
+	float material[33] = {};						//Ambient, diffuse, specular, specular power, emissive, then the UV transform
+	for (int i = 4; i < 8; i++) material[i] = 1.0f;
+	material[12] = 16.0f;
+	for (int i = 0; i < 4; i++) material[17 + i * 5] = 1.0f;
+	put(material, sizeof(material));
+	putName("");									//Pixel shader
+	for (int i = 0; i < 8; i++) putName("");		//Textures
+
+	const unsigned char hasSkeleton = 0;
+	put(&hasSkeleton, sizeof(hasSkeleton));
+
+	const uint32_t numIndices = static_cast<uint32_t>(numVertices - 2) * 3;
+	const uint32_t subMesh[5] = { 0, 0, 0, 0, numIndices / 3 };
+	putUInt(1);
+	put(subMesh, sizeof(subMesh));
+
+	putUInt(1);										//Index buffers
+	putUInt(numIndices);
+	for (uint32_t i = 0; i < numIndices; i++)
+	{
+		const uint16_t index = static_cast<uint16_t>(i / 3 + i % 3);
+		put(&index, sizeof(index));
+	}//End for
+
+	//Position, normal, tangent, colour and texture coordinate - 52 bytes a vertex
+	std::minstd_rand random(seed);
+	std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+	putUInt(1);										//Vertex buffers
+	putUInt(static_cast<uint32_t>(numVertices));
+	for (int i = 0; i < numVertices; i++)
+	{
+		const float position[3] = { coordinate(random), coordinate(random), coordinate(random) };
+		const float normalAndTangent[7] = { 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f };
+		const uint32_t colour = 0xffffffff;
+		const float textureCoordinate[2] = { (position[0] + 1.0f) * 0.5f, (position[2] + 1.0f) * 0.5f };
+		put(position, sizeof(position));
+		put(normalAndTangent, sizeof(normalAndTangent));
+		put(&colour, sizeof(colour));
+		put(textureCoordinate, sizeof(textureCoordinate));
+	}//End for
+
+	//Each vertex bound to one or two bones
+	putUInt(skinned ? 1 : 0);						//Skinning vertex buffers
+	if (skinned) putUInt(static_cast<uint32_t>(numVertices));
+	for (int i = 0; i < numVertices && skinned; i++)
+	{
+		const uint32_t bones[4] = { static_cast<uint32_t>(i % 32), static_cast<uint32_t>((i + 1) % 32), 0, 0 };
+		const float weights[4] = { 0.75f, 0.25f, 0.0f, 0.0f };
+		put(bones, sizeof(bones));
+		put(weights, sizeof(weights));
+	}//End for
+
+	const float extents[10] = { 0.0f, 0.0f, 0.0f, 1.7321f, -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+	put(extents, sizeof(extents));
+	return static_cast<bool>(file);
+}//End WriteSyntheticCMO
+
+//Stands in for BinaryReader::ReadEntireFile - the whole file read into a heap copy before anything is parsed
+static bool ReadEntireFile(const std::string& path, std::unique_ptr<unsigned char[]>& data, size_t& size)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) return false;
+
+	size = static_cast<size_t>(file.tellg());
+	file.seekg(0);
+	data.reset(new unsigned char[size]);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(data.get()), static_cast<std::streamsize>(size)));
+}//End ReadEntireFile
+
+//Stands in for a loader's parse and buffer creation, which between them read every byte of the file once
+static uint64_t ConsumeModelData(const unsigned char* data, const size_t size)
+{
+	uint64_t sum = 0;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		sum += word;
+	}//End for
+	for (; i < size; i++) sum += data[i];
+
+	return sum;
+}//End ConsumeModelData
+
+//One pass over every file - resident memory is sampled while each file is held if measure is set, as sampling costs time
+static bool LoadModelFiles(const std::vector<std::string>& paths, const bool mapped, const bool measure, uint64_t& checksum, ResidentMemory& largest)
+{
+	checksum = 0;
+	for (const std::string& path : paths)
+	{
+		MappedFile mapping;
+		std::unique_ptr<unsigned char[]> copy;
+		size_t size = 0;
+		if (mapped ? !mapping.Open(path.c_str()) : !ReadEntireFile(path, copy, size)) return false;
+
+		checksum += mapped ? ConsumeModelData(mapping.GetData(), mapping.GetSize()) : ConsumeModelData(copy.get(), size);
+		if (!measure) continue;
+
+		const ResidentMemory during = GetResidentMemory();
+		largest.anonymousBytes = std::max(largest.anonymousBytes, during.anonymousBytes);
+		largest.fileBytes = std::max(largest.fileBytes, during.fileBytes);
+	}//End for
+
+	return true;
+}//End LoadModelFiles
+
+static int BenchModelReads(const int corpusSize)
+{
+	const int NUM_PASSES = 5;
+	const std::string DATA_DIRECTORY = "database/data";
+
+	std::vector<std::string> paths = ListModelFiles(DATA_DIRECTORY);
+	const size_t numShipped = paths.size();
+
+	//Meshes from a thousand vertices to sixteen thousand, all within the 16-bit indices CMO uses - written straight to disk,
+	//so nothing large has been allocated before memory is measured
+	std::vector<std::string> corpus;
+	for (int i = 0; i < corpusSize; i++)
+	{
+		corpus.push_back("bench_mesh_" + std::to_string(i) + ".cmo");
+		if (!WriteSyntheticCMO(corpus.back(), 1024 << (i % 5), static_cast<unsigned>(i)))
+		{
+			fprintf(stderr, "Can't write %s\n", corpus.back().c_str());
+			for (const std::string& path : corpus) std::remove(path.c_str());
+			return 1;
+		}//End if
+	}//End for
+	paths.insert(paths.end(), corpus.begin(), corpus.end());
+
+	size_t totalBytes = 0, largestBytes = 0;
+	for (const std::string& path : paths)
+	{
+		MappedFile mapping;
+		if (!mapping.Open(path.c_str())) continue;
+		totalBytes += mapping.GetSize();
+		largestBytes = std::max(largestBytes, mapping.GetSize());
+	}//End for
+
+	//Memory first, mapped then copied - the heap keeps what the copies freed, so the mapped pass must not follow them
+	//Both ways go through the page cache, which is warm for the copies after the mapped pass but isn't counted against either
+	const ResidentMemory baseline = GetResidentMemory();
+	uint64_t heapChecksum = 0, mappedChecksum = 0;
+	ResidentMemory heapLargest = baseline, mappedLargest = baseline;
+
+	ResetPeakResidentMemory();
+	const size_t mappedBaseline = GetResidentMemory().peakBytes;
+	bool loaded = LoadModelFiles(paths, true, true, mappedChecksum, mappedLargest);
+	const size_t mappedPeak = GetResidentMemory().peakBytes;
+
+	ResetPeakResidentMemory();
+	const size_t heapBaseline = GetResidentMemory().peakBytes;
+	loaded = loaded && LoadModelFiles(paths, false, true, heapChecksum, heapLargest);
+	const size_t heapPeak = GetResidentMemory().peakBytes;
+
+	//Then time, alternating and keeping each way's fastest pass
+	double heapTime = 1e30, mappedTime = 1e30;
+	for (int pass = 0; pass < NUM_PASSES && loaded; pass++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		loaded = LoadModelFiles(paths, false, false, heapChecksum, heapLargest);
+		heapTime = std::min(heapTime, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+		start = std::chrono::steady_clock::now();
+		loaded = loaded && LoadModelFiles(paths, true, false, mappedChecksum, mappedLargest);
+		mappedTime = std::min(mappedTime, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}//End for
+
+	for (const std::string& path : corpus) std::remove(path.c_str());
+	if (!loaded || heapChecksum != mappedChecksum)
+	{
+		fprintf(stderr, loaded ? "The mapped files don't match the heap copies\n" : "A model file couldn't be read\n");
+		return 1;
+	}//End if
+
+	const auto growth = [](const size_t bytes, const size_t before) { return (bytes - std::min(bytes, before)) / 1048576.0; };
+	if (numShipped == 0) fprintf(stderr, "No models in %s - run from the editor's directory to include them\n", DATA_DIRECTORY.c_str());
+	fprintf(stderr, "%zu models from %s and %d generated CMO files - %.1f MB, the largest %.2f MB\n",
+		numShipped, DATA_DIRECTORY.c_str(), corpusSize, totalBytes / 1048576.0, largestBytes / 1048576.0);
+	fprintf(stderr, "Heap copy:  %.2fms a pass, peak resident +%.2f MB - at most +%.2f MB anonymous, +%.2f MB file-backed\n",
+		heapTime * 1000.0, growth(heapPeak, heapBaseline), growth(heapLargest.anonymousBytes, baseline.anonymousBytes), growth(heapLargest.fileBytes, baseline.fileBytes));
+	fprintf(stderr, "Mapped:     %.2fms a pass, peak resident +%.2f MB - at most +%.2f MB anonymous, +%.2f MB file-backed\n",
+		mappedTime * 1000.0, growth(mappedPeak, mappedBaseline), growth(mappedLargest.anonymousBytes, baseline.anonymousBytes), growth(mappedLargest.fileBytes, baseline.fileBytes));
+	fprintf(stderr, "File-backed pages are the page cache's own, clean and droppable - anonymous ones are a second copy the heap may keep\n");
+	return 0;
+}//End BenchModelReads
+
+//Maps and parses a CMO file, as the editor's loader threads do
+static bool ParseCMOFile(const std::string& path, CMOModel& model)
+{
+	MappedFile file;
+	return file.Open(path.c_str()) && model.Parse(file.GetData(), file.GetSize());
+}//End ParseCMOFile
+
+static int ModelBounds(const char* databasePath)
+{
+	SceneDatabase database;
+	if (!OpenDatabase(database, databasePath)) return 1;
+
+	//Every model the objects use, each parsed once - paths are as the editor stores them, relative to its directory
+	std::set<std::string> modelPaths;
+	if (!database.ForEachObjectWithoutCold(SceneDatabase::ALL_CHUNKS, [&modelPaths](const SceneObject& object) { modelPaths.insert(object.model_path); return true; }))
+	{
+		fprintf(stderr, "Can't read objects from '%s'\n", databasePath);
+		return 1;
+	}//End if
+
+	const auto start = std::chrono::steady_clock::now();
+	int numRecorded = 0;
+	for (const std::string& modelPath : modelPaths)
+	{
+		CMOModel model;
+		if (!ParseCMOFile(modelPath, model))
+		{
+			fprintf(stderr, "Can't load '%s' - its objects keep the unit radius\n", modelPath.c_str());
+			continue;
+		}//End if
+
+		const float radius = model.GetBoundingRadius();
+		if (!database.SetModelRadius(modelPath, radius))
+		{
+			fprintf(stderr, "Can't record the radius of '%s'\n", modelPath.c_str());
+			return 1;
+		}//End if
+
+		fprintf(stderr, "%s: radius %.3f\n", modelPath.c_str(), radius);
+		numRecorded++;
+	}//End for
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	fprintf(stderr, "Recorded %d of %zu models and re-bounded their objects in %.3fs\n", numRecorded, modelPaths.size(), elapsed.count());
+	return 0;
+}//End ModelBounds
+
+static int BenchCMOParse(const int numFiles)
+{
+	const int NUM_PASSES = 3;
+	const std::string DATA_DIRECTORY = "database/data";
+
+	std::vector<std::string> paths;
+	for (const std::string& path : ListModelFiles(DATA_DIRECTORY))
+	{
+		if (path.size() > 4 && path.compare(path.size() - 4, 4, ".cmo") == 0) paths.push_back(path);
+	}//End for
+	const size_t numShipped = paths.size();
+
+	//Meshes from a thousand vertices to sixteen thousand, one in four skinned
+	std::vector<std::string> corpus;
+	for (int i = 0; i < numFiles; i++)
+	{
+		corpus.push_back("bench_parse_" + std::to_string(i) + ".cmo");
+		if (!WriteSyntheticCMO(corpus.back(), 1024 << (i % 5), static_cast<unsigned>(i), i % 4 == 3))
+		{
+			fprintf(stderr, "Can't write %s\n", corpus.back().c_str());
+			for (const std::string& path : corpus) std::remove(path.c_str());
+			return 1;
+		}//End if
+	}//End for
+	paths.insert(paths.end(), corpus.begin(), corpus.end());
+
+	//One thread first, which every other run must match file for file
+	const int count = static_cast<int>(paths.size());
+	std::vector<size_t> expectedBytes(count);
+	size_t totalBytes = 0;
+	bool parsed = true;
+	for (int i = 0; i < count && parsed; i++)
+	{
+		CMOModel model;
+		parsed = ParseCMOFile(paths[i], model);
+		expectedBytes[i] = model.GetBufferBytes();
+		totalBytes += expectedBytes[i];
+	}//End for
+
+	//Doubling the threads up to the hardware's count, and at least to four so the pool is exercised on small machines
+	const int hardwareThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads < std::max(hardwareThreads, 4); threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(std::max(hardwareThreads, 4));
+
+	std::vector<double> times;
+	for (size_t t = 0; t < threadCounts.size() && parsed; t++)
+	{
+		//Files are taken from a shared counter a few at a time, so threads that draw small meshes take more of them
+		WorkerPool pool(threadCounts[t] - 1);
+		std::atomic<int> numMismatched(0);
+		double best = 1e30;
+		for (int pass = 0; pass < NUM_PASSES; pass++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			pool.ParallelFor(count, 1, [&](const int begin, const int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					CMOModel model;
+					if (!ParseCMOFile(paths[i], model) || model.GetBufferBytes() != expectedBytes[i]) numMismatched++;
+				}//End for
+			});
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}//End for
+
+		parsed = numMismatched == 0;
+		times.push_back(best);
+	}//End for
+
+	for (const std::string& path : corpus) std::remove(path.c_str());
+	if (!parsed)
+	{
+		fprintf(stderr, "A CMO file failed to parse, or parsed differently on more threads\n");
+		return 1;
+	}//End if
+
+	if (numShipped == 0) fprintf(stderr, "No models in %s - run from the editor's directory to include them\n", DATA_DIRECTORY.c_str());
+	fprintf(stderr, "%zu models from %s and %d generated CMO files - %.1f MB of buffers, %d hardware threads\n",
+		numShipped, DATA_DIRECTORY.c_str(), numFiles, totalBytes / 1048576.0, hardwareThreads);
+	for (size_t t = 0; t < threadCounts.size(); t++)
+	{
+		fprintf(stderr, "%2d threads:  %.2fms, %.0f files/s, %.2fx one thread%s\n", threadCounts[t], times[t] * 1000.0, count / times[t],
+			times[0] / times[t], threadCounts[t] > hardwareThreads ? " - more threads than the hardware has" : "");
+	}//End for
+
+	return 0;
+}//End BenchCMOParse
+
+int main(int argc, char* argv[])
+{
+	//Large reads and writes go straight through rather than being synced with C stdio
+	std::ios::sync_with_stdio(false);
+
+	if (argc == 4 && strcmp(argv[1], "import") == 0)
+	{
+		return Import(argv[2], argv[3]);
+	}//End if
+
+	if (argc >= 4 && strcmp(argv[1], "export") == 0)
+	{
+		int chunkID = SceneDatabase::ALL_CHUNKS;
+		ObjectBounds box;
+		bool hasBox = false;
+		bool valid = true;
+		for (int i = 4; i < argc && valid; i++)
+		{
+			if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) chunkID = atoi(argv[++i]);
+			else if (strcmp(argv[i], "--box") == 0 && i + 6 < argc)
+			{
+				box = { strtof(argv[i + 1], nullptr), strtof(argv[i + 2], nullptr), strtof(argv[i + 3], nullptr),
+					strtof(argv[i + 4], nullptr), strtof(argv[i + 5], nullptr), strtof(argv[i + 6], nullptr) };
+				hasBox = true;
+				i += 6;
+			}//End else if
+			else valid = false;
+		}//End for
+
+		if (!valid || (hasBox && chunkID == SceneDatabase::ALL_CHUNKS))
+		{
+			PrintUsage();
+			return 1;
+		}//End if
+
+		return Export(argv[2], argv[3], chunkID, hasBox ? &box : nullptr);
+	}//End if
+
+	if (argc == 10 && strcmp(argv[1], "query") == 0 && strcmp(argv[3], "--box") == 0)
+	{
+		const ObjectBounds box = { strtof(argv[4], nullptr), strtof(argv[5], nullptr), strtof(argv[6], nullptr),
+			strtof(argv[7], nullptr), strtof(argv[8], nullptr), strtof(argv[9], nullptr) };
+		return Query(argv[2], &box, nullptr);
+	}//End if
+
+	if (argc == 8 && strcmp(argv[1], "query") == 0 && strcmp(argv[3], "--sphere") == 0)
+	{
+		const float sphere[4] = { strtof(argv[4], nullptr), strtof(argv[5], nullptr), strtof(argv[6], nullptr), strtof(argv[7], nullptr) };
+		return Query(argv[2], nullptr, sphere);
+	}//End if
+
+	if (argc == 4 && strcmp(argv[1], "diff") == 0)
+	{
+		return Diff(argv[2], argv[3]);
+	}//End if
+
+	if ((argc == 5 || (argc == 6 && strcmp(argv[5], "--dry-run") == 0)) && strcmp(argv[1], "merge") == 0)
+	{
+		return Merge(argv[2], argv[3], argv[4], argc == 6);
+	}//End if
+
+	if (argc == 3 && strcmp(argv[1], "model-bounds") == 0)
+	{
+		return ModelBounds(argv[2]);
+	}//End if
+
+	if (argc == 3 && strcmp(argv[1], "compact-ids") == 0)
+	{
+		return CompactIDs(argv[2]);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-merge") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 1000000;
+		if (numObjects >= 100) return BenchMerge(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-save") == 0)
+	{
+		int numObjects = 10000;
+		bool inMemory = false;
+		bool valid = true;
+		for (int i = 2; i < argc && valid; i++)
+		{
+			if (strcmp(argv[i], "--memory") == 0) inMemory = true;
+			else if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc) numObjects = atoi(argv[++i]);
+			else valid = false;
+		}//End for
+		if (valid && numObjects >= 1) return BenchSave(numObjects, inMemory);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-startup") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return BenchStartup(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "test-autosave") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return TestAutosave(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-transforms") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return BenchTransforms(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-hierarchy") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 2) return BenchHierarchy(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-components") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return BenchComponents(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-textures") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return BenchTextures(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-streaming") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--objects") == 0)))
+	{
+		const int numObjects = argc == 4 ? atoi(argv[3]) : 100000;
+		if (numObjects >= 1) return BenchStreaming(numObjects);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-model-reads") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--corpus") == 0)))
+	{
+		const int corpusSize = argc == 4 ? atoi(argv[3]) : 100;
+		if (corpusSize >= 0) return BenchModelReads(corpusSize);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "bench-cmo-parse") == 0 && (argc == 2 || (argc == 4 && strcmp(argv[2], "--files") == 0)))
+	{
+		const int numFiles = argc == 4 ? atoi(argv[3]) : 400;
+		if (numFiles >= 1) return BenchCMOParse(numFiles);
+	}//End if
+
+	if (strcmp(argc > 1 ? argv[1] : "", "memory-report") == 0)
+	{
+		int numObjects = 100000;
+		bool printJSON = false;
+		bool valid = true;
+		for (int i = 2; i < argc && valid; i++)
+		{
+			if (strcmp(argv[i], "--json") == 0) printJSON = true;
+			else if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc) numObjects = atoi(argv[++i]);
+			else valid = false;
+		}//End for
+		if (valid && numObjects >= 1) return MemoryReport(numObjects, printJSON);
+	}//End if
+
+	PrintUsage();
+	return 1;
+}//End main
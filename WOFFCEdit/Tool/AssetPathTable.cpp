@@ -0,0 +1,175 @@
+#include "AssetPathTable.h"
+
+namespace
+{
+	const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+	//Appends one code point in whatever wchar_t holds - UTF-16 on Windows, UTF-32 elsewhere
+	void AppendWide(std::wstring& wide, const char32_t codePoint)
+	{
+		if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF)
+		{
+			wide += static_cast<wchar_t>(0xD800 + ((codePoint - 0x10000) >> 10));
+			wide += static_cast<wchar_t>(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+		}//End if
+		else
+		{
+			wide += static_cast<wchar_t>(codePoint);
+		}//End else
+	}//End AppendWide
+
+	void AppendUtf8(std::string& utf8, const char32_t codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			utf8 += static_cast<char>(codePoint);
+		}//End if
+		else if (codePoint < 0x800)
+		{
+			utf8 += static_cast<char>(0xC0 | codePoint >> 6);
+			utf8 += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}//End else if
+		else if (codePoint < 0x10000)
+		{
+			utf8 += static_cast<char>(0xE0 | codePoint >> 12);
+			utf8 += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}//End else if
+		else
+		{
+			utf8 += static_cast<char>(0xF0 | codePoint >> 18);
+			utf8 += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}//End else
+	}//End AppendUtf8
+}
+
+const AssetID AssetPathTable::NO_ASSET;
+
+AssetPathTable::AssetPathTable()
+{
+	//ID 0 is always the empty path, so zeroed records and defaults mean "no asset"
+	m_entries.push_back(Entry());
+	m_lookup.emplace(std::string(), NO_ASSET);
+
+	m_memoryRegistration = MemoryTracker::GetInstance().Register(MemoryCategory::STRINGS, "asset paths", [this]() { return GetMemoryUsage(); });
+}//End AssetPathTable
+
+AssetPathTable& AssetPathTable::GetInstance()
+{
+	static AssetPathTable table;
+	return table;
+}//End GetInstance
+
+AssetID AssetPathTable::Intern(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto existing = m_lookup.find(path);
+	if (existing != m_lookup.end()) return existing->second;
+
+	const AssetID asset = static_cast<AssetID>(m_entries.size());
+	m_entries.push_back({ path, Utf8ToWide(path) });
+	m_lookup.emplace(path, asset);
+	return asset;
+}//End Intern
+
+AssetID AssetPathTable::Intern(const std::wstring& path)
+{
+	return Intern(WideToUtf8(path));
+}//End Intern
+
+const std::string& AssetPathTable::GetPath(const AssetID asset) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return asset < m_entries.size() ? m_entries[asset].path : m_entries[NO_ASSET].path;
+}//End GetPath
+
+const std::wstring& AssetPathTable::GetWidePath(const AssetID asset) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return asset < m_entries.size() ? m_entries[asset].widePath : m_entries[NO_ASSET].widePath;
+}//End GetWidePath
+
+int AssetPathTable::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<int>(m_entries.size());
+}//End GetSize
+
+size_t AssetPathTable::GetMemoryUsage() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	//Both copies of each path, plus the index's own copy and a node and bucket per entry
+	size_t bytes = m_entries.size() * sizeof(Entry) + m_lookup.bucket_count() * sizeof(void*);
+	for (const Entry& entry : m_entries)
+	{
+		bytes += (entry.path.capacity() + 1) * 2 + (entry.widePath.capacity() + 1) * sizeof(wchar_t);
+		bytes += sizeof(std::pair<const std::string, AssetID>) + sizeof(void*);
+	}//End for
+
+	return bytes;
+}//End GetMemoryUsage
+
+std::wstring AssetPathTable::Utf8ToWide(const std::string& utf8)
+{
+	std::wstring wide;
+	wide.reserve(utf8.size());
+
+	size_t i = 0;
+	while (i < utf8.size())
+	{
+		const unsigned char lead = static_cast<unsigned char>(utf8[i]);
+		int length;
+		char32_t codePoint;
+		if (lead < 0x80)				{ length = 1; codePoint = lead; }
+		else if ((lead & 0xE0) == 0xC0)	{ length = 2; codePoint = lead & 0x1F; }
+		else if ((lead & 0xF0) == 0xE0)	{ length = 3; codePoint = lead & 0x0F; }
+		else if ((lead & 0xF8) == 0xF0)	{ length = 4; codePoint = lead & 0x07; }
+		else							{ length = 0; codePoint = 0; }
+
+		//Check every continuation byte is there before using any of them
+		bool valid = length > 0 && i + length <= utf8.size();
+		for (int j = 1; valid && j < length; j++)
+		{
+			const unsigned char continuation = static_cast<unsigned char>(utf8[i + j]);
+			valid = (continuation & 0xC0) == 0x80;
+			codePoint = codePoint << 6 | (continuation & 0x3F);
+		}//End for
+
+		//Overlong encodings, surrogates and anything past Unicode's range are as bad as a broken sequence
+		static const char32_t MIN_CODE_POINT[] = { 0, 0, 0x80, 0x800, 0x10000 };
+		valid = valid && codePoint >= MIN_CODE_POINT[length] && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+
+		AppendWide(wide, valid ? codePoint : REPLACEMENT_CHARACTER);
+		i += valid ? length : 1;
+	}//End while
+
+	return wide;
+}//End Utf8ToWide
+
+std::string AssetPathTable::WideToUtf8(const std::wstring& wide)
+{
+	std::string utf8;
+	utf8.reserve(wide.size());
+
+	for (size_t i = 0; i < wide.size(); i++)
+	{
+		char32_t codePoint = static_cast<char32_t>(wide[i]);
+		if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < wide.size() &&
+			static_cast<char32_t>(wide[i + 1]) >= 0xDC00 && static_cast<char32_t>(wide[i + 1]) <= 0xDFFF)
+		{
+			codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<char32_t>(wide[++i]) - 0xDC00);
+		}//End if
+		else if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+		{
+			codePoint = REPLACEMENT_CHARACTER;
+		}//End else if
+
+		AppendUtf8(utf8, codePoint);
+	}//End for
+
+	return utf8;
+}//End WideToUtf8
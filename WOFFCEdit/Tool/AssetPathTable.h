@@ -0,0 +1,50 @@
+#pragma once
+#include "MemoryTracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//Stands in for an asset path - equal paths always get the same ID, so comparing and copying paths is comparing and copying integers
+using AssetID = uint32_t;
+
+//Every asset path the editor has seen, each stored once in UTF-8 (as the database has it) and once in UTF-16 (as Windows and DirectX want it)
+//The conversion happens when a path is first interned, never again. IDs are only meaningful within one run of the program
+//Shared by every thread - interning and lookups are safe from the autosave worker as well as the main thread
+//Counted as strings in memory reports
+class AssetPathTable
+{
+public:
+	static const AssetID NO_ASSET = 0;						//The empty path
+
+	static AssetPathTable& GetInstance();
+
+	AssetID				Intern(const std::string& path);	//UTF-8
+	AssetID				Intern(const std::wstring& path);
+	const std::string&	GetPath(AssetID asset) const;		//References stay valid for the life of the table
+	const std::wstring&	GetWidePath(AssetID asset) const;
+
+	int		GetSize() const;
+	size_t	GetMemoryUsage() const;							//Records, both encodings and the lookup index
+
+	static std::wstring	Utf8ToWide(const std::string& utf8);	//Malformed sequences become U+FFFD
+	static std::string	WideToUtf8(const std::wstring& wide);
+
+private:
+	AssetPathTable();
+	AssetPathTable(const AssetPathTable&) = delete;
+	AssetPathTable& operator=(const AssetPathTable&) = delete;
+
+	struct Entry
+	{
+		std::string		path;
+		std::wstring	widePath;
+	};
+
+	mutable std::mutex							m_mutex;
+	std::deque<Entry>							m_entries;		//Indexed by ID - a deque so entries never move once added
+	std::unordered_map<std::string, AssetID>	m_lookup;
+	MemoryTracker::Registration					m_memoryRegistration;
+};
@@ -0,0 +1,105 @@
+#include "AssetStreamer.h"
+#include <algorithm>
+
+const int AssetStreamer::DEFAULT_THREADS;
+const int AssetStreamer::ALL_COMPLETIONS;
+
+AssetStreamer::AssetStreamer(const int numThreads) : m_numRunning(0), m_generation(0), m_stopping(false)
+{
+	//Loads are mostly CMO parsing, which scales with cores - they only run while assets stream in, so they may have every core
+	//the UI thread leaves
+	const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+	const int threads = numThreads == DEFAULT_THREADS ? std::max(hardwareThreads - 1, 1) : std::max(numThreads, 1);
+
+	m_threads.reserve(threads);
+	for (int i = 0; i < threads; i++) m_threads.emplace_back(&AssetStreamer::LoaderLoop, this);
+}//End constructor
+
+AssetStreamer::~AssetStreamer()
+{
+	Cancel();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wakeLoader.notify_all();
+
+	for (std::thread& thread : m_threads) thread.join();
+}//End destructor
+
+void AssetStreamer::Submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(std::move(job));
+	}
+	m_wakeLoader.notify_one();
+}//End Submit
+
+int AssetStreamer::ApplyCompletions(const int maxCompletions)
+{
+	//Taken out in one go so completions run without the lock, free to submit more jobs
+	std::deque<Completion> completions;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (maxCompletions == ALL_COMPLETIONS || maxCompletions >= static_cast<int>(m_completions.size()))
+		{
+			completions.swap(m_completions);
+		}//End if
+		else
+		{
+			completions.assign(std::make_move_iterator(m_completions.begin()), std::make_move_iterator(m_completions.begin() + maxCompletions));
+			m_completions.erase(m_completions.begin(), m_completions.begin() + maxCompletions);
+		}//End else
+	}
+
+	for (Completion& completion : completions) completion();
+	return static_cast<int>(completions.size());
+}//End ApplyCompletions
+
+void AssetStreamer::Cancel()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobs.clear();
+	m_completions.clear();
+	m_generation++;
+	m_jobsDone.wait(lock, [this] { return m_numRunning == 0; });
+}//End Cancel
+
+void AssetStreamer::WaitForJobs()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobsDone.wait(lock, [this] { return m_jobs.empty() && m_numRunning == 0; });
+}//End WaitForJobs
+
+int AssetStreamer::GetNumPending() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<int>(m_jobs.size() + m_completions.size()) + m_numRunning;
+}//End GetNumPending
+
+void AssetStreamer::LoaderLoop()
+{
+	for (;;)
+	{
+		Job job;
+		uint64_t generation;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeLoader.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+			if (m_stopping) return;
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			generation = m_generation;
+			m_numRunning++;
+		}
+
+		Completion completion = job();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (completion && generation == m_generation) m_completions.push_back(std::move(completion));
+		if (--m_numRunning == 0 && m_jobs.empty()) m_jobsDone.notify_all();
+	}//End for
+}//End LoaderLoop
@@ -0,0 +1,56 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Loads assets on a pool of loader threads and hands the results back to the UI thread at a frame boundary
+//A job runs on a loader thread - reading and parsing files - and returns a completion, which ApplyCompletions later runs on
+//the UI thread, so a frame never waits on a load and nothing the renderer draws from changes mid-frame
+//Jobs start in the order they were submitted. Jobs may only touch thread-safe state; completions may touch anything
+class AssetStreamer
+{
+public:
+	using Completion = std::function<void()>;
+	using Job = std::function<Completion()>;			//An empty completion means there is nothing to apply
+
+	static const int DEFAULT_THREADS = -1;				//One per hardware thread beyond the UI thread
+	static const int ALL_COMPLETIONS = -1;
+
+	explicit AssetStreamer(int numThreads = DEFAULT_THREADS);
+	~AssetStreamer();									//Cancels, then joins the loader threads
+
+	int		GetNumThreads() const { return static_cast<int>(m_threads.size()); }
+
+	void	Submit(Job job);
+
+	//Run finished jobs' completions on the calling thread, oldest first - returns how many ran
+	int		ApplyCompletions(int maxCompletions = ALL_COMPLETIONS);
+
+	//Drop every queued job and wait for running ones, whose completions are dropped too - for when what jobs refer to,
+	//such as the device, is about to go
+	void	Cancel();
+
+	void	WaitForJobs();								//Block until every submitted job has run - completions are left to apply
+	int		GetNumPending() const;						//Jobs queued or running, and completions not yet applied
+
+private:
+	AssetStreamer(const AssetStreamer&) = delete;
+	AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+	void	LoaderLoop();
+
+	std::vector<std::thread>	m_threads;
+
+	mutable std::mutex			m_mutex;				//Guards everything below
+	std::condition_variable		m_wakeLoader;
+	std::condition_variable		m_jobsDone;
+	std::deque<Job>				m_jobs;
+	std::deque<Completion>		m_completions;
+	int							m_numRunning;
+	uint64_t					m_generation;			//Bumped by Cancel, so running jobs know their completions are stale
+	bool						m_stopping;
+};
@@ -0,0 +1,176 @@
+#include "AutosaveService.h"
+#include "SceneSnapshot.h"
+#include <unordered_map>
+
+AutosaveService::AutosaveService() :
+m_snapshotChunkID(-1), m_snapshotRevision(0), m_hasPendingJob(false), m_jobInFlight(false), m_hasCompletion(false), m_stopRequested(false),
+m_completionStatus(Status::IDLE), m_completionRows(0)
+{
+}//End default constructor
+
+AutosaveService::~AutosaveService()
+{
+	Stop();
+}//End destructor
+
+bool AutosaveService::Start(const std::string& databasePath)
+{
+	Stop();
+
+	m_databasePath = databasePath;
+	m_snapshotChunkID = -1;
+	m_snapshotObjects.Clear();
+	if (!m_database.Open(databasePath.c_str(), SQLITE_OPEN_READWRITE) || !m_database.EnableWriteAheadLog()) return false;
+
+	m_stopRequested = false;
+	m_worker = std::thread(&AutosaveService::WorkerLoop, this);
+	return true;
+}//End Start
+
+void AutosaveService::Stop()
+{
+	if (m_worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopRequested = true;
+		}
+		m_wakeWorker.notify_one();
+		m_worker.join();
+	}//End if
+
+	m_database.Close();
+}//End Stop
+
+bool AutosaveService::IsBusy()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hasPendingJob || m_jobInFlight;
+}//End IsBusy
+
+bool AutosaveService::Submit(SaveJob&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_worker.joinable() || m_hasPendingJob || m_jobInFlight) return false;
+
+		m_pendingJob = std::move(job);
+		m_hasPendingJob = true;
+	}
+	m_wakeWorker.notify_one();
+	return true;
+}//End Submit
+
+void AutosaveService::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobFinished.wait(lock, [this] { return !m_hasPendingJob && !m_jobInFlight; });
+}//End Flush
+
+bool AutosaveService::PollCompletion(Status& status, int& rowsWritten, SaveJob& failedJob)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_hasCompletion) return false;
+
+	status = m_completionStatus;
+	rowsWritten = m_completionRows;
+	failedJob = std::move(m_failedJob);
+	m_failedJob = SaveJob();
+	m_hasCompletion = false;
+	return true;
+}//End PollCompletion
+
+void AutosaveService::WorkerLoop()
+{
+	for (;;)
+	{
+		SaveJob job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeWorker.wait(lock, [this] { return m_stopRequested || m_hasPendingJob; });
+
+			//A queued job is still written before stopping so closing the editor can't drop a save
+			if (!m_hasPendingJob) return;
+
+			job = std::move(m_pendingJob);
+			m_hasPendingJob = false;
+			m_jobInFlight = true;
+		}
+
+		std::vector<const SceneObject*> modifiedObjects;
+		modifiedObjects.reserve(job.modifiedObjects.size());
+		for (const SceneObject& object : job.modifiedObjects)
+		{
+			modifiedObjects.push_back(&object);
+		}//End for
+
+		const int rowsWritten = m_database.SaveObjectChanges(modifiedObjects, job.removedObjectIDs);
+
+		//Refresh the startup snapshot from what was just committed, still off the UI thread
+		if (rowsWritten > 0) RefreshSnapshot(job);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobInFlight = false;
+			m_hasCompletion = true;
+			m_completionRows = rowsWritten < 0 ? 0 : rowsWritten;
+			m_completionStatus = rowsWritten < 0 ? Status::FAILED : Status::SAVED;
+			if (rowsWritten < 0) m_failedJob = std::move(job);
+		}
+		m_jobFinished.notify_all();
+	}//End for
+}//End WorkerLoop
+
+void AutosaveService::RefreshSnapshot(const SaveJob& job)
+{
+	const int64_t revision = m_database.GetRevision();
+
+	//If this save is the only write since the copy was taken, the job's rows are all that changed - anything else, such as
+	//another chunk or another writer, means reading the chunk back from the database
+	if (m_snapshotChunkID == job.chunkID && revision == m_snapshotRevision + 1)
+	{
+		std::unordered_map<int, const SceneObject*> modifiedRows;
+		modifiedRows.reserve(job.modifiedObjects.size());
+		for (const SceneObject& object : job.modifiedObjects) modifiedRows.emplace(object.ID, &object);
+
+		//One pass over the copy, keeping the table's order - updated rows stay where they were and new ones follow the rest
+		SceneGraph objects;
+		objects.Reserve(m_snapshotObjects.GetSize() + static_cast<int>(job.modifiedObjects.size()));
+		for (int i = 0; i < m_snapshotObjects.GetSize(); i++)
+		{
+			const int objectID = m_snapshotObjects.GetHot(i).ID;
+			if (job.removedObjectIDs.count(objectID)) continue;
+
+			const auto modifiedRow = modifiedRows.find(objectID);
+			if (modifiedRow == modifiedRows.end())
+			{
+				objects.Append(m_snapshotObjects.MoveOut(i));
+				continue;
+			}//End if
+
+			objects.Append(SceneGraph::Split(*modifiedRow->second, false));
+			modifiedRows.erase(modifiedRow);
+		}//End for
+
+		for (const SceneObject& object : job.modifiedObjects)
+		{
+			if (modifiedRows.count(object.ID)) objects.Append(SceneGraph::Split(object, false));
+		}//End for
+
+		m_snapshotObjects.Swap(objects);
+	}//End if
+	else
+	{
+		m_snapshotObjects.Clear();
+		if (!m_database.LoadChunk(job.chunkID, m_snapshotChunk) ||
+			!m_database.ForEachObjectWithoutCold(job.chunkID, [this](const SceneObject& object) { m_snapshotObjects.AddHot(object); return true; }))
+		{
+			m_snapshotChunkID = -1;
+			return;
+		}//End if
+	}//End else
+
+	m_snapshotChunkID = job.chunkID;
+	m_snapshotRevision = revision;
+	SceneSnapshot::Write(SceneSnapshot::GetPath(m_databasePath, job.chunkID), revision, m_snapshotChunk, m_snapshotObjects);
+}//End RefreshSnapshot
@@ -0,0 +1,67 @@
+#pragma once
+#include "SceneDatabase.h"
+#include "SceneGraph.h"
+#include "SceneObject.h"
+#include "ChunkObject.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+//A consistent set of changes taken at a frame boundary - only the edited rows are copied, everything else is already on disk
+struct SaveJob
+{
+	std::vector<SceneObject>	modifiedObjects;
+	std::unordered_set<int>		removedObjectIDs;
+	int							chunkID = 0;
+};
+
+//Writes save jobs to the database on a worker thread so the UI thread never waits on SQLite
+//The worker has its own connection and the database runs in WAL mode, so the editor can keep reading while a save commits
+class AutosaveService
+{
+public:
+	enum class Status { IDLE, SAVING, SAVED, FAILED };
+
+	AutosaveService();
+	~AutosaveService();
+
+	bool		Start(const std::string& databasePath);		//Open the worker's connection and start the thread
+	void		Stop();										//Finish any save in flight, then join the worker
+
+	bool		IsBusy();									//A job is queued or being written
+	bool		Submit(SaveJob&& job);						//Hand a job to the worker - fails if one is already in flight
+	void		Flush();									//Block until the worker has finished any queued job
+
+	//Collect the outcome of the last job on the UI thread - returns false if nothing has finished since the last call
+	//On failure the job is handed back so its changes can be re-flagged for the next save
+	bool		PollCompletion(Status& status, int& rowsWritten, SaveJob& failedJob);
+
+private:
+	void		WorkerLoop();
+	void		RefreshSnapshot(const SaveJob& job);			//Bring the startup snapshot up to date with a job that has just committed
+
+	std::string					m_databasePath;
+	SceneDatabase				m_database;					//Only ever touched by the worker once started
+
+	//The chunk as last written to its snapshot, kept by the worker so a save only patches in the job's rows
+	SceneGraph					m_snapshotObjects;
+	ChunkObject					m_snapshotChunk;
+	int							m_snapshotChunkID;			//-1 until the first save reads a chunk in
+	int64_t						m_snapshotRevision;			//The database revision the copy matches
+	std::thread					m_worker;
+
+	std::mutex					m_mutex;					//Guards everything below
+	std::condition_variable		m_wakeWorker;
+	std::condition_variable		m_jobFinished;
+	SaveJob						m_pendingJob;
+	bool						m_hasPendingJob;
+	bool						m_jobInFlight;
+	bool						m_hasCompletion;
+	bool						m_stopRequested;
+	Status						m_completionStatus;
+	int							m_completionRows;
+	SaveJob						m_failedJob;
+};
@@ -0,0 +1,292 @@
+#include "CMOModel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const int MATERIAL_FLOATS = 33;						//Ambient, diffuse, specular, specular power, emissive, then the UV transform
+	const int UV_TRANSFORM_OFFSET = 17;
+	const int SUBMESH_BYTES = 20;						//Material, index buffer, vertex buffer, start index and triangle count
+	const int SKINNING_VERTEX_BYTES = 32;				//Four bone indices then four weights
+	const int TEXTURE_COORDINATE_OFFSET = 44;			//Within a vertex
+	const uint32_t NOT_VISITED = 0xffffffff;
+
+	//Reads a CMO file front to back, failing rather than running past the end - values are copied out, as nothing in the file
+	//is aligned
+	class CMOReader
+	{
+	public:
+		CMOReader(const uint8_t* data, const size_t size) : m_data(data), m_size(size), m_offset(0) {}
+
+		bool Read(void* value, const size_t bytes)
+		{
+			if (bytes > m_size - m_offset) return false;
+
+			memcpy(value, m_data + m_offset, bytes);
+			m_offset += bytes;
+			return true;
+		}//End Read
+
+		bool ReadUInt(uint32_t& value) { return Read(&value, sizeof(value)); }
+
+		//Names are stored as a length then that many UTF-16 code units
+		bool ReadName(std::wstring& name)
+		{
+			uint32_t length;
+			const uint8_t* characters;
+			if (!ReadUInt(length) || !(characters = Skip(length, sizeof(uint16_t)))) return false;
+
+			name.resize(length);
+			for (uint32_t i = 0; i < length; i++)
+			{
+				uint16_t character;
+				memcpy(&character, characters + i * sizeof(uint16_t), sizeof(character));
+				name[i] = static_cast<wchar_t>(character);
+			}//End for
+
+			return true;
+		}//End ReadName
+
+		//The start of an array to be read in place - nullptr if the file is too short to hold it
+		const uint8_t* Skip(const uint32_t count, const size_t elementBytes)
+		{
+			if (count > (m_size - m_offset) / elementBytes) return nullptr;
+
+			const uint8_t* const start = m_data + m_offset;
+			m_offset += count * elementBytes;
+			return start;
+		}//End Skip
+
+	private:
+		const uint8_t*	m_data;
+		size_t			m_size;
+		size_t			m_offset;
+	};
+
+	uint32_t ReadUIntAt(const uint8_t* data, const size_t offset)
+	{
+		uint32_t value;
+		memcpy(&value, data + offset, sizeof(value));
+		return value;
+	}//End ReadUIntAt
+
+	//Bone indices and weights in the four bytes each the skinned vertex layout has for them
+	void PackSkinning(const uint8_t* skinningVertex, uint8_t* vertex)
+	{
+		uint32_t indices = 0, weights = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			float weight;
+			memcpy(&weight, skinningVertex + 16 + i * sizeof(float), sizeof(weight));
+			const float scaled = std::min(std::max(weight, 0.0f), 1.0f) * 255.0f + 0.5f;
+
+			indices |= (ReadUIntAt(skinningVertex, i * sizeof(uint32_t)) & 0xff) << (i * 8);
+			weights |= static_cast<uint32_t>(scaled) << (i * 8);
+		}//End for
+
+		memcpy(vertex + CMOModel::VERTEX_STRIDE, &indices, sizeof(indices));
+		memcpy(vertex + CMOModel::VERTEX_STRIDE + sizeof(indices), &weights, sizeof(weights));
+	}//End PackSkinning
+
+	bool ParseMesh(CMOReader& reader, CMOModel::Mesh& mesh)
+	{
+		//Materials - the UV transforms are applied to the vertices below, as the renderer's effects have no UV transform
+		uint32_t numMaterials;
+		if (!reader.ReadName(mesh.name) || !reader.ReadUInt(numMaterials)) return false;
+
+		std::vector<float> uvTransforms;
+		for (uint32_t i = 0; i < numMaterials; i++)
+		{
+			CMOModel::Material material;
+			float values[MATERIAL_FLOATS];
+			if (!reader.ReadName(material.name) || !reader.Read(values, sizeof(values)) || !reader.ReadName(material.pixelShader)) return false;
+			for (std::wstring& texture : material.textures)
+			{
+				if (!reader.ReadName(texture)) return false;
+			}//End for
+
+			memcpy(material.ambient, values, sizeof(material.ambient));
+			memcpy(material.diffuse, values + 4, sizeof(material.diffuse));
+			memcpy(material.specular, values + 8, sizeof(material.specular));
+			material.specularPower = values[12];
+			memcpy(material.emissive, values + 13, sizeof(material.emissive));
+			uvTransforms.insert(uvTransforms.end(), values + UV_TRANSFORM_OFFSET, values + MATERIAL_FLOATS);
+			mesh.materials.push_back(std::move(material));
+		}//End for
+
+		//Skeletons are skipped, as DirectXTK skips them
+		uint8_t hasSkeleton;
+		uint32_t numSubMeshes;
+		const uint8_t* subMeshes;
+		if (!reader.Read(&hasSkeleton, sizeof(hasSkeleton)) || !reader.ReadUInt(numSubMeshes) || numSubMeshes == 0 ||
+			!(subMeshes = reader.Skip(numSubMeshes, SUBMESH_BYTES))) return false;
+
+		uint32_t numIndexBuffers;
+		if (!reader.ReadUInt(numIndexBuffers) || numIndexBuffers == 0) return false;
+		for (uint32_t i = 0; i < numIndexBuffers; i++)
+		{
+			uint32_t numIndices;
+			const uint8_t* indices;
+			if (!reader.ReadUInt(numIndices) || numIndices == 0 || !(indices = reader.Skip(numIndices, sizeof(uint16_t)))) return false;
+
+			mesh.indexBuffers.emplace_back(numIndices);
+			memcpy(mesh.indexBuffers.back().data(), indices, numIndices * sizeof(uint16_t));
+		}//End for
+
+		//Vertex buffers are read in place, then copied out once the skinning data has been found
+		uint32_t numVertexBuffers;
+		if (!reader.ReadUInt(numVertexBuffers) || numVertexBuffers == 0) return false;
+
+		std::vector<const uint8_t*> vertices;
+		std::vector<uint32_t> numVertices;
+		for (uint32_t i = 0; i < numVertexBuffers; i++)
+		{
+			uint32_t count;
+			const uint8_t* start;
+			if (!reader.ReadUInt(count) || count == 0 || !(start = reader.Skip(count, CMOModel::VERTEX_STRIDE))) return false;
+
+			vertices.push_back(start);
+			numVertices.push_back(count);
+		}//End for
+
+		//A skinned mesh has a skinning buffer for every vertex buffer, vertex for vertex
+		uint32_t numSkinningBuffers;
+		if (!reader.ReadUInt(numSkinningBuffers) || (numSkinningBuffers != 0 && numSkinningBuffers != numVertexBuffers)) return false;
+
+		std::vector<const uint8_t*> skinningVertices;
+		for (uint32_t i = 0; i < numSkinningBuffers; i++)
+		{
+			uint32_t count;
+			const uint8_t* start;
+			if (!reader.ReadUInt(count) || count != numVertices[i] || !(start = reader.Skip(count, SKINNING_VERTEX_BYTES))) return false;
+
+			skinningVertices.push_back(start);
+		}//End for
+
+		float extents[10];								//Sphere centre and radius, then the box's corners
+		if (!reader.Read(extents, sizeof(extents))) return false;
+
+		memcpy(mesh.sphereCenter, extents, sizeof(mesh.sphereCenter));
+		mesh.sphereRadius = extents[3];
+		memcpy(mesh.boxMin, extents + 4, sizeof(mesh.boxMin));
+		memcpy(mesh.boxMax, extents + 7, sizeof(mesh.boxMax));
+
+		mesh.skinned = numSkinningBuffers != 0;
+		const size_t stride = mesh.GetVertexStride();
+		for (uint32_t i = 0; i < numVertexBuffers; i++)
+		{
+			mesh.vertexBuffers.emplace_back(numVertices[i] * stride);
+			uint8_t* const buffer = mesh.vertexBuffers.back().data();
+			if (mesh.skinned)
+			{
+				for (uint32_t v = 0; v < numVertices[i]; v++)
+				{
+					memcpy(buffer + v * stride, vertices[i] + v * CMOModel::VERTEX_STRIDE, CMOModel::VERTEX_STRIDE);
+					PackSkinning(skinningVertices[i] + v * SKINNING_VERTEX_BYTES, buffer + v * stride);
+				}//End for
+			}//End if
+			else
+			{
+				memcpy(buffer, vertices[i], numVertices[i] * stride);
+			}//End else
+
+			//Each vertex takes the UV transform of the first material whose submesh uses it
+			std::vector<uint32_t> visited(numVertices[i], NOT_VISITED);
+			for (uint32_t s = 0; s < numSubMeshes; s++)
+			{
+				const uint8_t* const subMesh = subMeshes + s * SUBMESH_BYTES;
+				if (ReadUIntAt(subMesh, 8) != i) continue;
+
+				const uint32_t materialIndex = ReadUIntAt(subMesh, 0);
+				const uint32_t indexBufferIndex = ReadUIntAt(subMesh, 4);
+				if (materialIndex >= numMaterials || indexBufferIndex >= numIndexBuffers) return false;
+
+				const float* const uv = &uvTransforms[materialIndex * 16];
+				for (const uint16_t index : mesh.indexBuffers[indexBufferIndex])
+				{
+					if (index >= numVertices[i]) return false;
+					if (visited[index] != NOT_VISITED) continue;
+					visited[index] = materialIndex;
+
+					float coordinate[2];
+					uint8_t* const texture = buffer + index * stride + TEXTURE_COORDINATE_OFFSET;
+					memcpy(coordinate, texture, sizeof(coordinate));
+					const float transformed[2] = {
+						coordinate[0] * uv[0] + coordinate[1] * uv[4] + uv[12],
+						coordinate[0] * uv[1] + coordinate[1] * uv[5] + uv[13] };
+					memcpy(texture, transformed, sizeof(transformed));
+				}//End for
+			}//End for
+		}//End for
+
+		for (uint32_t s = 0; s < numSubMeshes; s++)
+		{
+			const uint8_t* const subMesh = subMeshes + s * SUBMESH_BYTES;
+			CMOModel::Part part;
+			part.materialIndex = static_cast<int>(ReadUIntAt(subMesh, 0));
+			part.indexBufferIndex = static_cast<int>(ReadUIntAt(subMesh, 4));
+			part.vertexBufferIndex = static_cast<int>(ReadUIntAt(subMesh, 8));
+			part.startIndex = ReadUIntAt(subMesh, 12);
+			part.indexCount = ReadUIntAt(subMesh, 16) * 3;
+			if (ReadUIntAt(subMesh, 0) >= numMaterials || ReadUIntAt(subMesh, 4) >= numIndexBuffers || ReadUIntAt(subMesh, 8) >= numVertexBuffers) return false;
+
+			mesh.parts.push_back(part);
+		}//End for
+
+		return true;
+	}//End ParseMesh
+}
+
+bool CMOModel::Parse(const uint8_t* data, const size_t size)
+{
+	meshes.clear();
+
+	CMOReader reader(data, size);
+	uint32_t numMeshes;
+	if (!reader.ReadUInt(numMeshes) || numMeshes == 0) return false;
+
+	for (uint32_t i = 0; i < numMeshes; i++)
+	{
+		meshes.emplace_back();
+		if (!ParseMesh(reader, meshes.back()))
+		{
+			meshes.clear();
+			return false;
+		}//End if
+	}//End for
+
+	return true;
+}//End Parse
+
+size_t CMOModel::GetBufferBytes() const
+{
+	size_t bytes = 0;
+	for (const Mesh& mesh : meshes)
+	{
+		for (const std::vector<uint16_t>& indices : mesh.indexBuffers) bytes += indices.size() * sizeof(uint16_t);
+		for (const std::vector<uint8_t>& vertices : mesh.vertexBuffers) bytes += vertices.size();
+	}//End for
+
+	return bytes;
+}//End GetBufferBytes
+
+float CMOModel::GetBoundingRadius() const
+{
+	//Each mesh is held by both its sphere and its box, so whichever reaches less far from the origin is used
+	float radius = 0.0f;
+	for (const Mesh& mesh : meshes)
+	{
+		float centreDistance = 0.0f, cornerDistance = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float corner = std::max(std::fabs(mesh.boxMin[axis]), std::fabs(mesh.boxMax[axis]));
+			centreDistance += mesh.sphereCenter[axis] * mesh.sphereCenter[axis];
+			cornerDistance += corner * corner;
+		}//End for
+
+		radius = std::max(radius, std::min(std::sqrt(centreDistance) + mesh.sphereRadius, std::sqrt(cornerDistance)));
+	}//End for
+
+	return radius;
+}//End GetBoundingRadius
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//A CMO model parsed on the CPU - everything Model::CreateFromCMO works out from the file before it touches the device
+//Parsing reads the whole file, builds the vertex buffers and applies the materials' UV transforms, so it is most of a model
+//load - and it needs nothing but the file, so any number of models can be parsed at once on loader or worker threads
+//Making buffers, effects and input layouts from the result is left to the renderer, one model at a time
+//Parsing follows DirectXTK's loader with a plain effect factory, so a model made from this draws the same as one it loads
+struct CMOModel
+{
+	static const int	MAX_TEXTURES = 8;
+	static const int	VERTEX_STRIDE = 52;			//Position, normal, tangent, colour and texture coordinate
+	static const int	SKINNED_VERTEX_STRIDE = 60;	//Then bone indices and weights packed into four bytes each
+
+	struct Material
+	{
+		std::wstring	name;
+		float			ambient[4];
+		float			diffuse[4];					//Alpha in w - parts using a material with alpha below 1 are drawn as transparent
+		float			specular[4];
+		float			specularPower;
+		float			emissive[4];
+		std::wstring	pixelShader;
+		std::wstring	textures[MAX_TEXTURES];		//Diffuse first - empty where the material has none
+	};
+
+	struct Part
+	{
+		int			materialIndex;
+		int			indexBufferIndex;
+		int			vertexBufferIndex;
+		uint32_t	startIndex;
+		uint32_t	indexCount;
+	};
+
+	struct Mesh
+	{
+		std::wstring						name;
+		std::vector<Material>				materials;
+		std::vector<Part>					parts;
+		std::vector<std::vector<uint16_t>>	indexBuffers;
+		std::vector<std::vector<uint8_t>>	vertexBuffers;		//Ready to upload, at the mesh's vertex stride
+		bool								skinned;
+		float								sphereCenter[3];
+		float								sphereRadius;
+		float								boxMin[3];
+		float								boxMax[3];
+
+		int	GetVertexStride() const { return skinned ? SKINNED_VERTEX_STRIDE : VERTEX_STRIDE; }
+	};
+
+	std::vector<Mesh>	meshes;
+
+	//False if the data isn't a complete CMO model - the model is left empty
+	bool	Parse(const uint8_t* data, size_t size);
+
+	size_t	GetBufferBytes() const;						//Vertex and index data, as it will be uploaded
+	float	GetBoundingRadius() const;					//Of a sphere about the model's origin holding every mesh - 0 for no meshes
+};
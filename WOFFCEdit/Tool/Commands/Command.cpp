@@ -1 +1,32 @@
 #include "Command.h"
+#include "../EditJournal.h"
+#include "../SceneGraph.h"
+
+void* Command::operator new(const size_t bytes)
+{
+	void* memory = ::operator new(bytes);
+	MemoryTracker::GetInstance().OnAllocate(MemoryCategory::UNDO_HISTORY, bytes);
+	return memory;
+}//End operator new
+
+void Command::operator delete(void* memory, const size_t bytes)
+{
+	MemoryTracker::GetInstance().OnFree(MemoryCategory::UNDO_HISTORY, bytes);
+	::operator delete(memory);
+}//End operator delete
+
+void JournalObjectAdded(EditJournal& journal, const SceneGraph::Entry& entry, const int index)
+{
+	journal.ObjectAdded(index, SceneGraph::Join(entry), entry.cold != nullptr);
+}//End JournalObjectAdded
+
+void SetScenePosition(SceneGraph& sceneGraph, const int objectID, const float position[3])
+{
+	const int index = sceneGraph.Find(objectID);
+	if (index == -1) return;
+
+	SceneObjectHot& object = sceneGraph.GetHot(index);
+	object.posX = position[0];
+	object.posY = position[1];
+	object.posZ = position[2];
+}//End SetScenePosition
\ No newline at end of file
@@ -1,4 +1,10 @@
 #pragma once
+#include "../MemoryTracker.h"
+#include "../SceneGraph.h"
+#include <deque>
+#include <stack>
+
+class EditJournal;
 
 class Command
 {
@@ -6,4 +12,18 @@ public:
 	virtual ~Command() = default;
 	virtual void Execute() = 0;
 	virtual void Undo() = 0;
-};
\ No newline at end of file
+
+	//Commands are counted as undo history in memory reports, each at the size of its own class
+	static void* operator new(size_t bytes);
+	static void operator delete(void* memory, size_t bytes);
+};
+
+//An undo or redo stack - its storage is counted as undo history alongside the commands
+using CommandStack = std::stack<Command*, std::deque<Command*, TrackedAllocator<Command*, MemoryCategory::UNDO_HISTORY>>>;
+
+//Record an object about to be put into the scene graph at index, with its whole row so replay can rebuild it - shared by paste
+//and the undo of delete/cut
+void JournalObjectAdded(EditJournal& journal, const SceneGraph::Entry& entry, int index);
+
+//Write a position into the object's scene graph record - shared by the move command and the end of a drag
+void SetScenePosition(SceneGraph& sceneGraph, int objectID, const float position[3]);
\ No newline at end of file
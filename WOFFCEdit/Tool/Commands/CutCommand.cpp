@@ -1,29 +1,31 @@
 #include "CutCommand.h"
 
-CutCommand::CutCommand(std::vector<DisplayObject>& displayList, int& selectedObjectID, const DisplayObject& objectToCopy)
-	: m_displayList(displayList), m_selectedObjectID(selectedObjectID), m_cutObjectID(selectedObjectID), m_objectToCopy(objectToCopy)
+CutCommand::CutCommand(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms, ObjectHandle& selectedObject, const ObjectHandle cutObject)
+	: m_selectedObject(selectedObject), m_cutObject(cutObject), m_removal(changeTracker, journal, sceneGraph, displayList, transforms)
 {
 }//End constructor
 
-void CutCommand::Execute()
+CutCommand::~CutCommand()
 {
-	//Can't cut if nothing is selected
-    if(m_selectedObjectID == -1) return;
-
-    m_objectToCopy = m_displayList[m_selectedObjectID];
+	//Dropped from the history while cut, so the objects can never come back - free their slots
+	m_removal.Release();
+}//End destructor
 
-    //Remove the object from the display list as part of cut
-    m_displayList.erase(m_displayList.begin() + m_selectedObjectID);
+void CutCommand::Execute()
+{
+    //Remove the object and everything parented below it as part of cut - fails if it's already gone
+    //Only the object itself is on the clipboard, so its children go the way of a delete
+    if(!m_removal.Remove(m_cutObject)) return;
 
-    //Set ID to -1 because we just cut the object that was selected
-    m_selectedObjectID = -1;
+    //Clear the selection if we just cut the object that was selected
+    if(m_removal.Contains(m_selectedObject)) m_selectedObject = ObjectHandle();
 }//End Cut Execute
 
 void CutCommand::Undo()
 {
-    //Get the ID of the selected object back
-    m_selectedObjectID = m_cutObjectID;
+    //Re-add the objects to the display list under their old handles
+    m_removal.Restore();
 
-    //Re-add the object to the display list in its previous location
-    m_displayList.insert(m_displayList.begin() + m_selectedObjectID, m_objectToCopy);
-}//End Cut Undo
\ No newline at end of file
+    //Get the selection back
+    m_selectedObject = m_cutObject;
+}//End Cut Undo
@@ -1,19 +1,17 @@
 #pragma once
-#include <vector>
 #include "Command.h"
-#include "../../Renderer/DisplayObject.h"
+#include "ObjectRemoval.h"
 
 class CutCommand : public Command
 {
 public:
-	CutCommand(std::vector<DisplayObject>& displayList, int& selectedObjectID, const DisplayObject& objectToCopy);
-	~CutCommand() override = default;
+	CutCommand(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms, ObjectHandle& selectedObject, ObjectHandle cutObject);
+	~CutCommand() override;
 	void Execute() override;
 	void Undo() override;
 
 private:
-	std::vector<DisplayObject>& m_displayList;
-	int& m_selectedObjectID;
-	int m_cutObjectID;
-	DisplayObject m_objectToCopy;
-};
\ No newline at end of file
+	ObjectHandle& m_selectedObject;
+	const ObjectHandle m_cutObject;
+	ObjectRemoval m_removal;				//The object and its children while cut
+};
@@ -1,27 +1,30 @@
 #include "DeleteCommand.h"
 
-DeleteCommand::DeleteCommand(std::vector<DisplayObject>& displayList, int& selectedObjectID, const DisplayObject& objectDeleted)
-	: m_displayList(displayList), m_selectedObjectID(selectedObjectID), m_objectDeleted(objectDeleted), m_deletedObjectID(selectedObjectID)
+DeleteCommand::DeleteCommand(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms, ObjectHandle& selectedObject, const ObjectHandle deletedObject)
+	: m_selectedObject(selectedObject), m_deletedObject(deletedObject), m_removal(changeTracker, journal, sceneGraph, displayList, transforms)
 {
 }//End constructor
 
-void DeleteCommand::Execute()
+DeleteCommand::~DeleteCommand()
 {
-	//Can't delete if nothing is selected
-    if(m_selectedObjectID == -1) return;
+	//Dropped from the history while deleted, so the objects can never come back - free their slots
+	m_removal.Release();
+}//End destructor
 
-    //Remove the object from the display list
-    m_displayList.erase(m_displayList.begin() + m_selectedObjectID);
+void DeleteCommand::Execute()
+{
+	//Remove the object and everything parented below it - fails if it's already gone
+    if(!m_removal.Remove(m_deletedObject)) return;
 
-    //Set ID to -1 because we just deleted the object that was selected
-    m_selectedObjectID = -1;
+    //Clear the selection if we just deleted the object that was selected
+    if(m_removal.Contains(m_selectedObject)) m_selectedObject = ObjectHandle();
 }//End Delete Execute
 
 void DeleteCommand::Undo()
 {
-    //Re-set the ID of the selected object
-    m_selectedObjectID = m_deletedObjectID;
+	//Re-add the objects to the display list under their old handles
+    m_removal.Restore();
 
-	//Re-add the object to the display list
-    m_displayList.insert(m_displayList.begin() + m_selectedObjectID, m_objectDeleted);
-}//End Delete Undo
\ No newline at end of file
+    //Re-select the restored object
+    m_selectedObject = m_deletedObject;
+}//End Delete Undo
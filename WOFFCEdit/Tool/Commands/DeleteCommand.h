@@ -1,19 +1,17 @@
 #pragma once
 #include "Command.h"
-#include <vector>
-#include "../../Renderer/DisplayObject.h"
+#include "ObjectRemoval.h"
 
 class DeleteCommand : public Command
 {
 	public:
-	DeleteCommand(std::vector<DisplayObject>& displayList, int& selectedObjectID, const DisplayObject& objectDeleted);
-	~DeleteCommand() override = default;
+	DeleteCommand(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms, ObjectHandle& selectedObject, ObjectHandle deletedObject);
+	~DeleteCommand() override;
 	void Execute() override;
 	void Undo() override;
 
 private:
-	std::vector<DisplayObject>& m_displayList;
-	int& m_selectedObjectID;
-	int m_deletedObjectID;
-	DisplayObject m_objectDeleted;
-};
\ No newline at end of file
+	ObjectHandle& m_selectedObject;
+	const ObjectHandle m_deletedObject;
+	ObjectRemoval m_removal;				//The object and its children while deleted
+};
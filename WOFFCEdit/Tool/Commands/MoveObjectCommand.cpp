@@ -1,24 +1,30 @@
 #include "MoveObjectCommand.h"
 
-MoveObjectCommand::MoveObjectCommand(int& selectedObjectID, const int movedObjectID, DirectX::SimpleMath::Vector3& objectPosition, DirectX::SimpleMath::Vector3 previousPosition, DirectX::SimpleMath::Vector3 newPosition)
-	: m_selectedObjectID(selectedObjectID), m_movedObjectID(movedObjectID), m_objectPositionPointer(&objectPosition), m_previousPosition(previousPosition), m_newPosition(newPosition)
+MoveObjectCommand::MoveObjectCommand(SceneChangeTracker& changeTracker, EditJournal& journal, ObjectHandle& selectedObject, const ObjectHandle movedObject, const int movedObjectDatabaseID, SceneGraph& sceneGraph, TransformStore& transforms, const int transformSlot, DirectX::SimpleMath::Vector3 previousPosition, DirectX::SimpleMath::Vector3 newPosition)
+	: m_changeTracker(changeTracker), m_journal(journal), m_selectedObject(selectedObject), m_movedObject(movedObject), m_movedObjectDatabaseID(movedObjectDatabaseID), m_sceneGraph(sceneGraph), m_transforms(transforms), m_transformSlot(transformSlot), m_previousPosition(previousPosition), m_newPosition(newPosition)
 {
 }//End constructor
 
 void MoveObjectCommand::Execute()
 {
 	//Set the selected ID to be the moved object (done here in case of Redo)
-	m_selectedObjectID = m_movedObjectID;
+	m_selectedObject = m_movedObject;
 
-	//Set the position to the new position post-drag
-	*m_objectPositionPointer = m_newPosition;
+	//Set the position to the new position post-drag, in the record and in the renderer's transforms
+	m_transforms.SetPosition(m_transformSlot, &m_newPosition.x);
+	SetScenePosition(m_sceneGraph, m_movedObjectDatabaseID, &m_newPosition.x);
+	m_changeTracker.ObjectModified(m_movedObjectDatabaseID);
+	m_journal.ObjectMoved(m_movedObjectDatabaseID, &m_newPosition.x);
 }//End MoveObject Execute
 
 void MoveObjectCommand::Undo()
 {
 	//Set the position to the old position pre-drag
-	*m_objectPositionPointer = m_previousPosition;
+	m_transforms.SetPosition(m_transformSlot, &m_previousPosition.x);
+	SetScenePosition(m_sceneGraph, m_movedObjectDatabaseID, &m_previousPosition.x);
+	m_changeTracker.ObjectModified(m_movedObjectDatabaseID);
+	m_journal.ObjectMoved(m_movedObjectDatabaseID, &m_previousPosition.x);
 
 	//Set the ID to be the object just moved
-	m_selectedObjectID = m_movedObjectID;
+	m_selectedObject = m_movedObject;
 }//End MoveObject Undo
\ No newline at end of file
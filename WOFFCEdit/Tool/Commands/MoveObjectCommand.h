@@ -1,18 +1,28 @@
 #pragma once
 #include "Command.h"
+#include "../SceneChangeTracker.h"
+#include "../EditJournal.h"
+#include "../TransformStore.h"
+#include "../SceneGraph.h"
+#include "../SlotMap.h"
 #include "../../Renderer/DisplayObject.h"
 
 class MoveObjectCommand : public Command
 {
 public:
-	MoveObjectCommand(int& selectedObjectID, int movedObjectID, DirectX::SimpleMath::Vector3& objectPosition, DirectX::SimpleMath::Vector3 previousPosition, DirectX::SimpleMath::Vector3 newPosition);
+	MoveObjectCommand(SceneChangeTracker& changeTracker, EditJournal& journal, ObjectHandle& selectedObject, ObjectHandle movedObject, int movedObjectDatabaseID, SceneGraph& sceneGraph, TransformStore& transforms, int transformSlot, DirectX::SimpleMath::Vector3 previousPosition, DirectX::SimpleMath::Vector3 newPosition);
 	void Execute() override;
 	void Undo() override;
 
 private:
-	int& m_selectedObjectID;
-	const int m_movedObjectID;
-	DirectX::SimpleMath::Vector3* m_objectPositionPointer;
+	SceneChangeTracker& m_changeTracker;
+	EditJournal& m_journal;
+	ObjectHandle& m_selectedObject;
+	const ObjectHandle m_movedObject;
+	const int m_movedObjectDatabaseID;
+	SceneGraph& m_sceneGraph;
+	TransformStore& m_transforms;
+	const int m_transformSlot;
 	DirectX::SimpleMath::Vector3 m_previousPosition;
 	DirectX::SimpleMath::Vector3 m_newPosition;
 };
\ No newline at end of file
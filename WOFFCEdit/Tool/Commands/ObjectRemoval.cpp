@@ -0,0 +1,102 @@
+#include "ObjectRemoval.h"
+#include "Command.h"
+#include <algorithm>
+#include <unordered_map>
+
+ObjectRemoval::ObjectRemoval(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms)
+	: m_changeTracker(changeTracker), m_journal(journal), m_sceneGraph(sceneGraph), m_displayList(displayList), m_transforms(transforms)
+{
+}//End constructor
+
+bool ObjectRemoval::Remove(const ObjectHandle root)
+{
+	if (!m_displayList.Get(root)) return false;
+
+	//Each transform slot's children, from one pass over the display list, then the subtree breadth first from the root
+	std::unordered_map<int, std::vector<ObjectHandle>> children;
+	for (uint32_t i = 0; i < m_displayList.GetNumSlots(); i++)
+	{
+		const DisplayObject* object = m_displayList.GetAt(i);
+		if (!object) continue;
+
+		const int parent = m_transforms.GetParent(object->m_transform);
+		if (parent != TransformStore::NO_PARENT) children[parent].push_back(m_displayList.GetHandleAt(i));
+	}//End for
+
+	std::vector<ObjectHandle> subtree(1, root);
+	for (size_t i = 0; i < subtree.size(); i++)
+	{
+		const auto found = children.find(m_displayList.Get(subtree[i])->m_transform);
+		if (found != children.end()) subtree.insert(subtree.end(), found->second.begin(), found->second.end());
+	}//End for
+
+	//Find every record in one pass over the scene graph rather than a search per object
+	std::unordered_map<int, size_t> byID;
+	m_removed.clear();
+	m_removed.resize(subtree.size());
+	for (size_t i = 0; i < subtree.size(); i++)
+	{
+		m_removed[i].handle = subtree[i];
+		m_removed[i].sceneIndex = -1;
+		byID[m_displayList.Get(subtree[i])->m_ID] = i;
+	}//End for
+
+	for (int index = 0; index < m_sceneGraph.GetSize(); index++)
+	{
+		const auto found = byID.find(m_sceneGraph.GetHot(index).ID);
+		if (found != byID.end()) m_removed[found->second].sceneIndex = index;
+	}//End for
+
+	//Extracting from the last index down leaves the earlier indices valid, and undo puts them back from the first up
+	std::sort(m_removed.begin(), m_removed.end(), [](const Removed& a, const Removed& b) { return a.sceneIndex > b.sceneIndex; });
+	for (Removed& removed : m_removed)
+	{
+		m_displayList.Remove(removed.handle, removed.object);
+		m_changeTracker.ObjectRemoved(removed.object.m_ID);
+		m_journal.ObjectRemoved(removed.object.m_ID);
+
+		//Take the records out of the scene graph too, so saving and the select dialogue see the object gone
+		if (removed.sceneIndex != -1) removed.entry = m_sceneGraph.Extract(removed.sceneIndex);
+	}//End for
+
+	return true;
+}//End Remove
+
+void ObjectRemoval::Restore()
+{
+	//Undo runs against the graph as Remove left it, so the records go straight back where they came from
+	for (auto removed = m_removed.rbegin(); removed != m_removed.rend(); ++removed)
+	{
+		const int objectID = removed->object.m_ID;
+		if (!m_displayList.Restore(removed->handle, std::move(removed->object))) continue;
+		m_changeTracker.ObjectModified(objectID);
+
+		if (removed->sceneIndex != -1)
+		{
+			JournalObjectAdded(m_journal, removed->entry, removed->sceneIndex);
+			m_sceneGraph.Insert(removed->sceneIndex, std::move(removed->entry));
+		}//End if
+	}//End for
+
+	m_removed.clear();
+}//End Restore
+
+void ObjectRemoval::Release()
+{
+	//Dropped from the history while removed, so the objects can never come back
+	for (const Removed& removed : m_removed)
+	{
+		if (m_displayList.Release(removed.handle)) m_transforms.Release(removed.object.m_transform);
+	}//End for
+	m_removed.clear();
+}//End Release
+
+bool ObjectRemoval::Contains(const ObjectHandle handle) const
+{
+	for (const Removed& removed : m_removed)
+	{
+		if (removed.handle == handle) return true;
+	}//End for
+
+	return false;
+}//End Contains
@@ -0,0 +1,38 @@
+#pragma once
+#include "../SceneChangeTracker.h"
+#include "../EditJournal.h"
+#include "../SceneGraph.h"
+#include "../SlotMap.h"
+#include "../TransformStore.h"
+#include "../../Renderer/DisplayObject.h"
+#include <vector>
+
+//An object taken out of the scene along with everything parented below it - shared by delete and cut
+//Children can't stay behind: in the editor they would keep following a hidden parent, and once saved they would load as roots
+//with their parent-relative transforms read as world ones
+class ObjectRemoval
+{
+public:
+	ObjectRemoval(SceneChangeTracker& changeTracker, EditJournal& journal, SceneGraph& sceneGraph, SlotMap<DisplayObject>& displayList, TransformStore& transforms);
+
+	bool	Remove(ObjectHandle root);				//Fails, removing nothing, if the root is already gone
+	void	Restore();								//Every removed object back under its old handle and where it sat in the scene graph
+	void	Release();								//Free the display list and transform slots of objects still removed, for a command dropped from the history
+	bool	Contains(ObjectHandle handle) const;	//Whether the object is one of those removed
+
+private:
+	struct Removed
+	{
+		ObjectHandle		handle;
+		DisplayObject		object;				//Held here while removed - its slot stays reserved so undo restores the same handle
+		SceneGraph::Entry	entry;				//The object's records, held alongside it so undo puts every column back
+		int					sceneIndex;			//Where the records sat in the scene graph, -1 if they weren't there
+	};
+
+	SceneChangeTracker&		m_changeTracker;
+	EditJournal&			m_journal;
+	SceneGraph&				m_sceneGraph;
+	SlotMap<DisplayObject>&	m_displayList;
+	TransformStore&		m_transforms;
+	std::vector<Removed>	m_removed;			//In the order they came out of the scene graph, last index first
+};
@@ -1,71 +1,75 @@
 #include "PasteCommand.h"
-#include "../../Renderer/DeviceResources.h"
 
-PasteCommand::PasteCommand(std::vector<DisplayObject>& displayList, const DisplayObject& objectToPaste, const std::shared_ptr<DX::DeviceResources>& deviceResources)
-	: m_displayList(displayList), m_objectToPaste(objectToPaste), m_deviceResources(deviceResources)
+PasteCommand::PasteCommand(SceneChangeTracker& changeTracker, EditJournal& journal, TransformStore& transforms, SlotMap<DisplayObject>& displayList, SceneGraph& sceneGraph, ModelCache& modelCache, TextureCache& textureCache, SceneGraph::Entry objectToPaste, const int parentTransform, const int pastedObjectID)
+	: m_changeTracker(changeTracker), m_journal(journal), m_transforms(transforms), m_displayList(displayList), m_sceneGraph(sceneGraph), m_modelCache(modelCache), m_textureCache(textureCache), m_entryPasted(std::move(objectToPaste)), m_pastedObjectID(pastedObjectID)
 {
-    m_fxFactory = new DirectX::EffectFactory(deviceResources->GetD3DDevice());
+    //The copy keeps every column of the original - only its ID and position change
+    SceneObjectHot& pastedObject = m_entryPasted.hot;
+    pastedObject.ID = m_pastedObjectID;
+
+    //Slightly offset the position to prevent overlapping
+    pastedObject.posX += 0.25f;
+    pastedObject.posY += 0.25f;
+    pastedObject.posZ += 0.25f;
+
+    //Take the transform now, so redo puts the object back where it was
+    m_pastedTransform = m_transforms.Allocate();
+    m_transforms.SetPosition(m_pastedTransform, &pastedObject.posX);
+    m_transforms.SetOrientation(m_pastedTransform, &pastedObject.rotX);
+    m_transforms.SetScale(m_pastedTransform, &pastedObject.scaX);
+    if (parentTransform != TransformStore::NO_PARENT) m_transforms.SetParent(m_pastedTransform, parentTransform);
 }//End constructor
 
+PasteCommand::~PasteCommand()
+{
+	//Dropped from the history while undone, or never run, so the object can never come back - free its slots
+	//In the scene, or held by a later delete that frees it, the object keeps its transform
+	if (m_pastedObject.IsNull() || m_displayList.Release(m_pastedObject)) m_transforms.Release(m_pastedTransform);
+}//End destructor
+
 void PasteCommand::Execute()
 {
-	//Can't paste if we don't have anything to paste
-    if(m_objectToPaste.m_model == nullptr) return;
+    //Redo puts back the object built the first time, under the same handle
+    if(!m_pastedObject.IsNull())
+    {
+        if(!m_displayList.Restore(m_pastedObject, std::move(m_objectPasted))) return;
+        AddToSceneGraph();
+        return;
+    }//End if
 
     //Create a temporary display object that we will populate then append to the display list
 	DisplayObject newDisplayObject;
+	newDisplayObject.m_ID = m_pastedObjectID;
+	newDisplayObject.m_transform = m_pastedTransform;
 	
-    //Get DXSDK to load model
-    //Set final boolean to "false" for left-handed coordinate system (Maya)
-	newDisplayObject.m_model = DirectX::Model::CreateFromCMO(m_deviceResources->GetD3DDevice(), m_objectToPaste.m_model_path.c_str(), *m_fxFactory, true);	
-
-    //Save the model path for completeness
-	newDisplayObject.m_model_path = m_objectToPaste.m_model_path;
-
-    //Load diffuse texture into shader resource
-	const HRESULT rs = DirectX::CreateDDSTextureFromFile(m_deviceResources->GetD3DDevice(), m_objectToPaste.m_texture_diffuse_path.c_str(), nullptr, &newDisplayObject.m_texture_diffuse);	
-
-    //Save the texture path for completeness
-	newDisplayObject.m_texture_diffuse_path = m_objectToPaste.m_texture_diffuse_path;
-
-	//If texture loading fails, load error default
-	if (rs)
-	{
-        //Load texture into shader resource
-        DirectX::CreateDDSTextureFromFile(m_deviceResources->GetD3DDevice(), L"database/data/Error.dds", nullptr, &newDisplayObject.m_texture_diffuse);
-	}//End if
-
-	//Apply new texture to model's effect
-    //Handled using an in-line function via Lambda
-	newDisplayObject.m_model->UpdateEffects([&](DirectX::IEffect* effect)
-	{
-		const auto lights = dynamic_cast<DirectX::BasicEffect*>(effect);
-		if (lights)
-		{
-			lights->SetTexture(newDisplayObject.m_texture_diffuse);			
-		}//End if
-	});
-
-    //Slightly offset the position to prevent overlapping
-    newDisplayObject.m_position = DirectX::SimpleMath::Vector3
-    (
-		m_objectToPaste.m_position.x + 0.25f,
-        m_objectToPaste.m_position.y + 0.25f,
-        m_objectToPaste.m_position.z + 0.25f
-    );
-
-    //Set equivalent scale
-    newDisplayObject.m_scale = m_objectToPaste.m_scale;
-
-    //Set equivalent orientation
-    newDisplayObject.m_orientation = m_objectToPaste.m_orientation;
+    //The original's model and texture are normally still in their caches, so pasting loads neither again
+    //If either is still streaming in, the copy is a placeholder until it arrives just as the original is
+	newDisplayObject.m_modelPath = m_entryPasted.hot.model_path;
+	newDisplayObject.m_texturePath = m_entryPasted.hot.tex_diffuse_path;
+	newDisplayObject.m_model = m_modelCache.Find(newDisplayObject.m_modelPath);
+	newDisplayObject.m_texture_diffuse = m_textureCache.Find(newDisplayObject.m_texturePath);
 
     //Create the new object in the display list
-    m_displayList.push_back(newDisplayObject);
+    m_pastedObject = m_displayList.Insert(std::move(newDisplayObject));
+    AddToSceneGraph();
 }//End Paste Execute
 
 void PasteCommand::Undo()
 {
-    //Remove the object from the back of the display list
-    m_displayList.pop_back();
-}//End Paste Undo
\ No newline at end of file
+    //Take the object back out of the display list and the scene graph, keeping both for redo
+    if(!m_displayList.Remove(m_pastedObject, m_objectPasted)) return;
+
+    const int sceneIndex = m_sceneGraph.Find(m_pastedObjectID);
+    if(sceneIndex != -1) m_entryPasted = m_sceneGraph.Extract(sceneIndex);
+
+    m_changeTracker.ObjectRemoved(m_pastedObjectID);
+    m_journal.ObjectRemoved(m_pastedObjectID);
+}//End Paste Undo
+
+void PasteCommand::AddToSceneGraph()
+{
+    //New objects go on the end of the scene graph, which is where undo left it on redo
+    JournalObjectAdded(m_journal, m_entryPasted, m_sceneGraph.GetSize());
+    m_sceneGraph.Append(std::move(m_entryPasted));
+    m_changeTracker.ObjectModified(m_pastedObjectID);
+}//End AddToSceneGraph
\ No newline at end of file
@@ -1,24 +1,35 @@
 #pragma once
 #include "Command.h"
-#include <vector>
+#include "../SceneChangeTracker.h"
+#include "../EditJournal.h"
+#include "../TransformStore.h"
+#include "../SceneGraph.h"
+#include "../SlotMap.h"
 #include "../../Renderer/DisplayObject.h"
-
-namespace DX
-{
-	class DeviceResources;
-}
+#include "../../Renderer/ModelCache.h"
+#include "../../Renderer/TextureCache.h"
 
 class PasteCommand : public Command
 {
 public:
-	PasteCommand(std::vector<DisplayObject>& displayList, const DisplayObject& objectToPaste, const std::shared_ptr<DX::DeviceResources>& deviceResources);
-	~PasteCommand() override = default;
+	PasteCommand(SceneChangeTracker& changeTracker, EditJournal& journal, TransformStore& transforms, SlotMap<DisplayObject>& displayList, SceneGraph& sceneGraph, ModelCache& modelCache, TextureCache& textureCache, SceneGraph::Entry objectToPaste, int parentTransform, int pastedObjectID);
+	~PasteCommand() override;
 	void Execute() override;
 	void Undo() override;
 
 private:
-	std::vector<DisplayObject>& m_displayList;
-	DisplayObject m_objectToPaste;
-	std::shared_ptr<DX::DeviceResources> m_deviceResources;
-	DirectX::EffectFactory* m_fxFactory{};
+	void AddToSceneGraph();
+
+	SceneChangeTracker& m_changeTracker;
+	EditJournal& m_journal;
+	TransformStore& m_transforms;
+	SlotMap<DisplayObject>& m_displayList;
+	SceneGraph& m_sceneGraph;
+	ModelCache& m_modelCache;
+	TextureCache& m_textureCache;
+	SceneGraph::Entry m_entryPasted;		//The new object's records, held here until executed and while undone
+	const int m_pastedObjectID;
+	int m_pastedTransform;					//Kept for the command's lifetime so redo puts the object back where it was
+	ObjectHandle m_pastedObject;			//Null until first executed - redo restores the object under the same handle
+	DisplayObject m_objectPasted;			//Held here while undone
 };
@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//Components only some objects have, keyed by object ID
+//Components sit packed in one array with a parallel array of their owners, so a system visits only the objects that have one
+//and never strides over the ones that don't. A paged index maps IDs to positions, so lookups are O(1) and objects
+//without the component cost nothing beyond their share of an index page
+//Removal moves the last component into the gap, so positions - and pointers from Get - are only good until the next Add or Remove
+template <typename T>
+class ComponentPool
+{
+public:
+	//Add or replace the object's component
+	T& Add(const int objectID, T component)
+	{
+		if (T* existing = Get(objectID))
+		{
+			*existing = std::move(component);
+			return *existing;
+		}//End if
+
+		IndexSlot(objectID) = static_cast<int>(m_components.size());
+		m_components.push_back(std::move(component));
+		m_owners.push_back(objectID);
+		return m_components.back();
+	}//End Add
+
+	//Take the object's component out - false if it doesn't have one
+	bool Remove(const int objectID, T* removed = nullptr)
+	{
+		const int position = Find(objectID);
+		if (position == NONE) return false;
+
+		if (removed) *removed = std::move(m_components[position]);
+
+		//Fill the gap with the last component so the array stays packed
+		const int last = static_cast<int>(m_components.size()) - 1;
+		if (position != last)
+		{
+			m_components[position] = std::move(m_components[last]);
+			m_owners[position] = m_owners[last];
+			IndexSlot(m_owners[position]) = position;
+		}//End if
+
+		IndexSlot(objectID) = NONE;
+		m_components.pop_back();
+		m_owners.pop_back();
+		return true;
+	}//End Remove
+
+	void Clear()
+	{
+		m_components.clear();
+		m_owners.clear();
+		m_pages.clear();
+	}//End Clear
+
+	void Swap(ComponentPool& other)
+	{
+		m_components.swap(other.m_components);
+		m_owners.swap(other.m_owners);
+		m_pages.swap(other.m_pages);
+	}//End Swap
+
+	T* Get(const int objectID)
+	{
+		const int position = Find(objectID);
+		return position == NONE ? nullptr : &m_components[position];
+	}//End Get
+
+	const T* Get(const int objectID) const
+	{
+		return const_cast<ComponentPool*>(this)->Get(objectID);
+	}//End Get
+
+	bool Has(const int objectID) const { return Find(objectID) != NONE; }
+
+	//Packed iteration - component i belongs to GetOwner(i)
+	int			GetSize() const				{ return static_cast<int>(m_components.size()); }
+	bool		IsEmpty() const				{ return m_components.empty(); }
+	T&			GetAt(const int i)			{ return m_components[i]; }
+	const T&	GetAt(const int i) const	{ return m_components[i]; }
+	int			GetOwner(const int i) const	{ return m_owners[i]; }
+
+	//Components, owners and index pages
+	size_t GetMemoryUsage() const
+	{
+		size_t bytes = m_components.capacity() * sizeof(T) + m_owners.capacity() * sizeof(int) + m_pages.capacity() * sizeof(std::unique_ptr<int[]>);
+		for (const std::unique_ptr<int[]>& page : m_pages)
+		{
+			if (page) bytes += PAGE_SIZE * sizeof(int);
+		}//End for
+
+		return bytes;
+	}//End GetMemoryUsage
+
+private:
+	static const int NONE = -1;
+	static const int PAGE_BITS = 10;
+	static const int PAGE_SIZE = 1 << PAGE_BITS;
+
+	int Find(const int objectID) const
+	{
+		if (objectID < 0) return NONE;
+
+		const size_t page = static_cast<size_t>(objectID) >> PAGE_BITS;
+		if (page >= m_pages.size() || !m_pages[page]) return NONE;
+		return m_pages[page][objectID & (PAGE_SIZE - 1)];
+	}//End Find
+
+	//The object's entry in the index, adding its page if need be - IDs are never negative
+	int& IndexSlot(const int objectID)
+	{
+		const size_t page = static_cast<size_t>(objectID) >> PAGE_BITS;
+		if (page >= m_pages.size()) m_pages.resize(page + 1);
+		if (!m_pages[page])
+		{
+			m_pages[page].reset(new int[PAGE_SIZE]);
+			for (int i = 0; i < PAGE_SIZE; i++) m_pages[page][i] = NONE;
+		}//End if
+
+		return m_pages[page][objectID & (PAGE_SIZE - 1)];
+	}//End IndexSlot
+
+	std::vector<T>						m_components;
+	std::vector<int>					m_owners;
+	std::vector<std::unique_ptr<int[]>>	m_pages;				//Position of each ID's component, NONE if it has none
+};
@@ -0,0 +1,338 @@
+#include "EditJournal.h"
+#include "SceneSchema.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const char JOURNAL_MAGIC[4] = { 'W', 'F', 'E', 'J' };
+	const uint32_t FORMAT_VERSION = 2;				//Version 1 files are skipped - their ADDED records led with a copy of the hot fields
+
+	//Each record is a type byte and a payload length, so a reader can tell where a torn final record begins
+	const size_t RECORD_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t);
+	const size_t FILE_HEADER_SIZE = sizeof(JOURNAL_MAGIC) + sizeof(FORMAT_VERSION);
+
+	//Bounds-checked reads over a loaded file
+	struct JournalReader
+	{
+		const char* position;
+		const char* end;
+
+		bool ReadBytes(void* out, const size_t size)
+		{
+			if (static_cast<size_t>(end - position) < size) return false;
+			memcpy(out, position, size);
+			position += size;
+			return true;
+		}//End ReadBytes
+
+		bool ReadString(std::string& text)
+		{
+			uint32_t length;
+			if (!ReadBytes(&length, sizeof(length)) || static_cast<size_t>(end - position) < length) return false;
+
+			text.assign(position, length);
+			position += length;
+			return true;
+		}//End ReadString
+
+		//A whole row, column by column in table order - fails on a row written with a different set of columns
+		bool ReadObject(SceneObject& object)
+		{
+			const SceneSchema::Table<SceneObject>& table = SceneSchema::OBJECTS;
+			uint32_t numColumns;
+			if (!ReadBytes(&numColumns, sizeof(numColumns)) || numColumns != static_cast<uint32_t>(table.numColumns)) return false;
+
+			for (int i = 0; i < table.numColumns; i++)
+			{
+				const SceneSchema::Column<SceneObject>& column = table.columns[i];
+				bool valid = false;
+				switch (column.type)
+				{
+					case SceneSchema::FieldType::INTEGER:
+					{
+						int32_t value;
+						valid = ReadBytes(&value, sizeof(value));
+						object.*column.intField = value;
+						break;
+					}
+					case SceneSchema::FieldType::REAL:
+						valid = ReadBytes(&(object.*column.floatField), sizeof(float));
+						break;
+					case SceneSchema::FieldType::BOOLEAN:
+					{
+						uint8_t value;
+						valid = ReadBytes(&value, sizeof(value));
+						object.*column.boolField = value != 0;
+						break;
+					}
+					case SceneSchema::FieldType::TEXT:
+						valid = ReadString(object.*column.textField);
+						break;
+				}//End switch
+
+				if (!valid) return false;
+			}//End for
+
+			return true;
+		}//End ReadObject
+	};
+
+	bool ReadFile(const std::string& path, std::vector<char>& contents)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) return false;
+
+		contents.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		return contents.empty() || static_cast<bool>(file.read(contents.data(), contents.size()));
+	}//End ReadFile
+
+	//Append one file's records - stops quietly at the first incomplete record
+	void ReadEntries(const std::vector<char>& contents, std::vector<JournalEntry>& entries)
+	{
+		if (contents.size() < FILE_HEADER_SIZE || memcmp(contents.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) return;
+
+		uint32_t formatVersion;
+		memcpy(&formatVersion, contents.data() + sizeof(JOURNAL_MAGIC), sizeof(formatVersion));
+		if (formatVersion != FORMAT_VERSION) return;
+
+		JournalReader reader = { contents.data() + FILE_HEADER_SIZE, contents.data() + contents.size() };
+		while (static_cast<size_t>(reader.end - reader.position) >= RECORD_HEADER_SIZE)
+		{
+			uint8_t type;
+			uint32_t payloadSize;
+			reader.ReadBytes(&type, sizeof(type));
+			reader.ReadBytes(&payloadSize, sizeof(payloadSize));
+			if (static_cast<size_t>(reader.end - reader.position) < payloadSize) return;
+
+			//Parse the payload on its own so a malformed record can't read into the next one
+			JournalReader payload = { reader.position, reader.position + payloadSize };
+			reader.position += payloadSize;
+
+			JournalEntry entry;
+			entry.type = static_cast<JournalEntry::Type>(type);
+			entry.index = -1;
+			entry.objectHasCold = false;
+			if (!payload.ReadBytes(&entry.objectID, sizeof(entry.objectID))) return;
+
+			bool valid = true;
+			switch (entry.type)
+			{
+				case JournalEntry::Type::MOVED:
+					valid = payload.ReadBytes(entry.position, sizeof(entry.position));
+					break;
+				case JournalEntry::Type::REMOVED:
+					break;
+				case JournalEntry::Type::ADDED:
+				{
+					uint8_t withCold = 0;
+					valid = payload.ReadBytes(&entry.index, sizeof(entry.index)) &&
+						payload.ReadBytes(&withCold, sizeof(withCold)) &&
+						payload.ReadObject(entry.object);
+					entry.objectHasCold = withCold != 0;
+					break;
+				}
+				default:
+					//Unknown record from a newer editor - its length lets it be skipped
+					continue;
+			}//End switch
+
+			if (!valid) return;
+			entries.push_back(std::move(entry));
+		}//End while
+	}//End ReadEntries
+}
+
+EditJournal::EditJournal() : m_recordStart(0)
+{
+}//End default constructor
+
+EditJournal::~EditJournal()
+{
+	Close();
+}//End destructor
+
+std::string EditJournal::GetPath(const std::string& databasePath, const int chunkID)
+{
+	return databasePath + ".chunk" + std::to_string(chunkID) + ".journal";
+}//End GetPath
+
+std::string EditJournal::GetPendingPath(const std::string& journalPath)
+{
+	return journalPath + ".pending";
+}//End GetPendingPath
+
+bool EditJournal::Open(const std::string& path)
+{
+	Close();
+
+	m_path = path;
+	m_file.open(path, std::ios::binary | std::ios::app);
+	if (!m_file) return false;
+
+	//A new file starts with the header
+	m_file.seekp(0, std::ios::end);
+	if (m_file.tellp() == std::streampos(0))
+	{
+		m_file.write(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+		m_file.write(reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+		m_file.flush();
+	}//End if
+
+	return static_cast<bool>(m_file);
+}//End Open
+
+void EditJournal::Close()
+{
+	if (!m_file.is_open()) return;
+
+	Flush();
+	m_file.close();
+	m_file.clear();
+}//End Close
+
+void EditJournal::ObjectMoved(const int objectID, const float position[3])
+{
+	BeginRecord(JournalEntry::Type::MOVED, objectID);
+	AppendBytes(position, sizeof(float) * 3);
+	EndRecord();
+}//End ObjectMoved
+
+void EditJournal::ObjectRemoved(const int objectID)
+{
+	BeginRecord(JournalEntry::Type::REMOVED, objectID);
+	EndRecord();
+}//End ObjectRemoved
+
+void EditJournal::ObjectAdded(const int index, const SceneObject& object, const bool withCold)
+{
+	const int32_t storedIndex = index;
+	const uint8_t storedWithCold = withCold ? 1 : 0;
+
+	//Where it goes in the scene graph, then the whole row
+	BeginRecord(JournalEntry::Type::ADDED, object.ID);
+	AppendBytes(&storedIndex, sizeof(storedIndex));
+	AppendBytes(&storedWithCold, sizeof(storedWithCold));
+
+	const SceneSchema::Table<SceneObject>& table = SceneSchema::OBJECTS;
+	const uint32_t numColumns = static_cast<uint32_t>(table.numColumns);
+	AppendBytes(&numColumns, sizeof(numColumns));
+	for (int i = 0; i < table.numColumns; i++)
+	{
+		const SceneSchema::Column<SceneObject>& column = table.columns[i];
+		switch (column.type)
+		{
+			case SceneSchema::FieldType::INTEGER:
+			{
+				const int32_t value = object.*column.intField;
+				AppendBytes(&value, sizeof(value));
+				break;
+			}
+			case SceneSchema::FieldType::REAL:
+				AppendBytes(&(object.*column.floatField), sizeof(float));
+				break;
+			case SceneSchema::FieldType::BOOLEAN:
+			{
+				const uint8_t value = object.*column.boolField ? 1 : 0;
+				AppendBytes(&value, sizeof(value));
+				break;
+			}
+			case SceneSchema::FieldType::TEXT:
+				AppendString(object.*column.textField);
+				break;
+		}//End switch
+	}//End for
+	EndRecord();
+}//End ObjectAdded
+
+bool EditJournal::Flush()
+{
+	if (m_buffer.empty() || !m_file.is_open()) return true;
+
+	//One write per frame however many edits it made - flushing hands it to the OS, which outlives an editor crash
+	m_file.write(m_buffer.data(), m_buffer.size());
+	m_file.flush();
+	m_buffer.clear();
+
+	return static_cast<bool>(m_file);
+}//End Flush
+
+bool EditJournal::Rotate()
+{
+	if (!m_file.is_open()) return false;
+
+	const std::string path = m_path;
+	const std::string pendingPath = GetPendingPath(path);
+	Close();
+
+	std::vector<char> contents;
+	std::ifstream pendingFile(pendingPath, std::ios::binary);
+	const bool hasPending = static_cast<bool>(pendingFile);
+	pendingFile.close();
+
+	if (!hasPending)
+	{
+		std::rename(path.c_str(), pendingPath.c_str());
+	}//End if
+	else if (ReadFile(path, contents) && contents.size() > FILE_HEADER_SIZE)
+	{
+		//An earlier save failed, so its edits are still pending - these go after them
+		std::ofstream pending(pendingPath, std::ios::binary | std::ios::app);
+		pending.write(contents.data() + FILE_HEADER_SIZE, contents.size() - FILE_HEADER_SIZE);
+		pending.close();
+		if (!pending) return Open(path);
+		std::remove(path.c_str());
+	}//End else if
+	else
+	{
+		std::remove(path.c_str());
+	}//End else
+
+	return Open(path);
+}//End Rotate
+
+void EditJournal::DiscardPending()
+{
+	if (!m_path.empty()) std::remove(GetPendingPath(m_path).c_str());
+}//End DiscardPending
+
+bool EditJournal::Read(const std::string& path, std::vector<JournalEntry>& entries)
+{
+	std::vector<char> contents;
+	if (ReadFile(GetPendingPath(path), contents)) ReadEntries(contents, entries);
+	if (ReadFile(path, contents)) ReadEntries(contents, entries);
+	return true;
+}//End Read
+
+void EditJournal::BeginRecord(const JournalEntry::Type type, const int objectID)
+{
+	const int32_t storedID = objectID;
+	const uint32_t payloadSize = 0;
+
+	m_recordStart = m_buffer.size();
+	m_buffer.push_back(static_cast<char>(type));
+	AppendBytes(&payloadSize, sizeof(payloadSize));
+	AppendBytes(&storedID, sizeof(storedID));
+}//End BeginRecord
+
+void EditJournal::EndRecord()
+{
+	//Patch the payload length now the payload is known
+	const uint32_t payloadSize = static_cast<uint32_t>(m_buffer.size() - m_recordStart - RECORD_HEADER_SIZE);
+	memcpy(m_buffer.data() + m_recordStart + sizeof(uint8_t), &payloadSize, sizeof(payloadSize));
+}//End EndRecord
+
+void EditJournal::AppendBytes(const void* data, const size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}//End AppendBytes
+
+void EditJournal::AppendString(const std::string& text)
+{
+	//Text columns are stored as the bytes the database holds
+	const uint32_t length = static_cast<uint32_t>(text.size());
+	AppendBytes(&length, sizeof(length));
+	AppendBytes(text.data(), text.size());
+}//End AppendString
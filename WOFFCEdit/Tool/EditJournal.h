@@ -0,0 +1,64 @@
+#pragma once
+#include "SceneObject.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//One change to an object, recorded as the state the object was left in rather than the edit that produced it
+//That makes replay idempotent - applying a record the database already reflects changes nothing
+struct JournalEntry
+{
+	enum class Type : uint8_t { MOVED = 1, REMOVED = 2, ADDED = 3 };
+
+	Type			type;
+	int32_t			objectID;
+	int32_t			index;					//ADDED: position in the scene graph, -1 to append
+	float			position[3];			//MOVED only
+	bool			objectHasCold;			//ADDED: whether the row's cold fields are real - false if they were never loaded, and the database still has them
+	SceneObject		object;					//ADDED: every column, components included
+};
+
+//Append-only binary log of every edit made since the last save, kept next to the database for crash recovery
+//Appends only encode into memory - Flush writes everything gathered in one go, once per frame
+//Saving rotates the log: the active file becomes the pending file, which is discarded once the save commits
+class EditJournal
+{
+public:
+	EditJournal();
+	~EditJournal();
+
+	static std::string GetPath(const std::string& databasePath, int chunkID);
+	static std::string GetPendingPath(const std::string& journalPath);
+
+	bool	Open(const std::string& path);				//Start appending to the journal at path, creating it if needed
+	void	Close();									//Flush and close
+	bool	IsOpen() const { return m_file.is_open(); }
+
+	//Record edits - cheap enough to call from inside a command
+	void	ObjectMoved(int objectID, const float position[3]);
+	void	ObjectRemoved(int objectID);
+	void	ObjectAdded(int index, const SceneObject& object, bool withCold);
+
+	bool	Flush();									//Write out everything recorded since the last flush
+
+	//Saving - Rotate when a save is handed off, DiscardPending once it has committed
+	//A failed save leaves the pending file alone, and the next rotation appends to it
+	bool	Rotate();
+	void	DiscardPending();
+
+	//Everything still to be saved for the journal at path - the pending file's entries, then the active file's
+	//A record cut short by a crash ends the read without failing it
+	static bool Read(const std::string& path, std::vector<JournalEntry>& entries);
+
+private:
+	void	BeginRecord(JournalEntry::Type type, int objectID);
+	void	EndRecord();
+	void	AppendBytes(const void* data, size_t size);
+	void	AppendString(const std::string& text);
+
+	std::string			m_path;
+	std::ofstream		m_file;
+	std::vector<char>	m_buffer;						//Records waiting for the next flush
+	size_t				m_recordStart;					//Where the record being built starts in the buffer
+};
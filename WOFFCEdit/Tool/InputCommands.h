@@ -36,4 +36,7 @@ struct InputCommands
 	//Keyboard shortcuts for MFC buttons
 	bool save;
 	bool wireframeMode;
+
+	//Diagnostics
+	bool dumpMemory;
 };
\ No newline at end of file
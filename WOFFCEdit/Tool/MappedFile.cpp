@@ -0,0 +1,122 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_fileHandle(INVALID_HANDLE_VALUE), m_mappingHandle(nullptr)
+{
+}//End default constructor
+#else
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_fileDescriptor(-1)
+{
+}//End default constructor
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}//End destructor
+
+#ifdef _WIN32
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	m_fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	return MapOpenedFile();
+}//End Open
+
+bool MappedFile::Open(const wchar_t* path)
+{
+	Close();
+
+	m_fileHandle = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	return MapOpenedFile();
+}//End Open
+
+bool MappedFile::MapOpenedFile()
+{
+	if (m_fileHandle == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}//End if
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mappingHandle)
+	{
+		Close();
+		return false;
+	}//End if
+
+	m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}//End if
+
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}//End MapOpenedFile
+
+void MappedFile::Close()
+{
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_mappingHandle) CloseHandle(m_mappingHandle);
+	if (m_fileHandle != INVALID_HANDLE_VALUE) CloseHandle(m_fileHandle);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mappingHandle = nullptr;
+	m_fileHandle = INVALID_HANDLE_VALUE;
+}//End Close
+#else
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	m_fileDescriptor = open(path, O_RDONLY);
+	if (m_fileDescriptor < 0) return false;
+
+	struct stat fileStatus;
+	if (fstat(m_fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		Close();
+		return false;
+	}//End if
+
+	void* mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}//End if
+
+	m_data = static_cast<const uint8_t*>(mapping);
+	m_size = static_cast<size_t>(fileStatus.st_size);
+	return true;
+}//End Open
+
+void MappedFile::Close()
+{
+	if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+	if (m_fileDescriptor >= 0) close(m_fileDescriptor);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_fileDescriptor = -1;
+}//End Close
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//Read-only memory mapping of a whole file
+//Uses file mapping objects on Windows and mmap everywhere else, so callers can parse data in place with no staging copy
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool			Open(const char* path);		//Map the file at the given path - fails for missing or empty files
+#ifdef _WIN32
+	bool			Open(const wchar_t* path);	//For the wide asset paths the renderer's loaders are given
+#endif
+	void			Close();
+
+	bool			IsOpen() const	{ return m_data != nullptr; }
+	const uint8_t*	GetData() const	{ return m_data; }
+	size_t			GetSize() const	{ return m_size; }
+
+private:
+	const uint8_t*	m_data;
+	size_t			m_size;
+
+#ifdef _WIN32
+	bool			MapOpenedFile();
+
+	void*			m_fileHandle;				//HANDLE, kept opaque so this header doesn't pull in windows.h
+	void*			m_mappingHandle;
+#else
+	int				m_fileDescriptor;
+#endif
+};
@@ -0,0 +1,175 @@
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	const int NUM_CATEGORIES = static_cast<int>(MemoryCategory::COUNT);
+
+	const char* const CATEGORY_NAMES[NUM_CATEGORIES] = { "scene_records", "meshes", "textures", "undo_history", "strings" };
+
+	void AppendJSONString(std::string& json, const std::string& value)
+	{
+		json += '"';
+		for (const char c : value)
+		{
+			if (c == '"' || c == '\\')
+			{
+				json += '\\';
+				json += c;
+			}//End if
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+				json += escaped;
+			}//End else if
+			else
+			{
+				json += c;
+			}//End else
+		}//End for
+		json += '"';
+	}//End AppendJSONString
+}
+
+MemoryTracker::Registration& MemoryTracker::Registration::operator=(Registration&& other)
+{
+	if (this != &other)
+	{
+		Reset();
+		m_id = other.m_id;
+		other.m_id = 0;
+	}//End if
+
+	return *this;
+}//End move assignment
+
+void MemoryTracker::Registration::Reset()
+{
+	if (m_id == 0) return;
+
+	MemoryTracker::GetInstance().Unregister(m_id);
+	m_id = 0;
+}//End Reset
+
+size_t MemoryTracker::CategoryReport::GetTotal() const
+{
+	size_t total = allocatedBytes;
+	for (const Source& source : sources) total += source.bytes;
+	return total;
+}//End GetTotal
+
+size_t MemoryTracker::Report::GetTotal() const
+{
+	size_t total = 0;
+	for (const CategoryReport& category : categories) total += category.GetTotal();
+	return total;
+}//End GetTotal
+
+std::string MemoryTracker::Report::ToJSON() const
+{
+	std::string json = "{\n\t\"total_bytes\": " + std::to_string(GetTotal()) + ",\n\t\"categories\": {";
+	for (int i = 0; i < NUM_CATEGORIES; i++)
+	{
+		const CategoryReport& category = categories[i];
+		json += i == 0 ? "\n\t\t" : ",\n\t\t";
+		AppendJSONString(json, CATEGORY_NAMES[i]);
+		json += ": {\n\t\t\t\"total_bytes\": " + std::to_string(category.GetTotal()) +
+			",\n\t\t\t\"allocated_bytes\": " + std::to_string(category.allocatedBytes) +
+			",\n\t\t\t\"allocations\": " + std::to_string(category.numAllocations) +
+			",\n\t\t\t\"sources\": [";
+
+		for (size_t s = 0; s < category.sources.size(); s++)
+		{
+			json += s == 0 ? "\n\t\t\t\t{ \"name\": " : ",\n\t\t\t\t{ \"name\": ";
+			AppendJSONString(json, category.sources[s].name);
+			json += ", \"bytes\": " + std::to_string(category.sources[s].bytes) + " }";
+		}//End for
+
+		json += category.sources.empty() ? "]\n\t\t}" : "\n\t\t\t]\n\t\t}";
+	}//End for
+
+	json += "\n\t}\n}\n";
+	return json;
+}//End ToJSON
+
+MemoryTracker::MemoryTracker() : m_nextID(1)
+{
+	for (int i = 0; i < NUM_CATEGORIES; i++)
+	{
+		m_allocatedBytes[i] = 0;
+		m_numAllocations[i] = 0;
+	}//End for
+}//End MemoryTracker
+
+MemoryTracker& MemoryTracker::GetInstance()
+{
+	static MemoryTracker tracker;
+	return tracker;
+}//End GetInstance
+
+void MemoryTracker::OnAllocate(const MemoryCategory category, const size_t bytes)
+{
+	m_allocatedBytes[static_cast<int>(category)].fetch_add(bytes, std::memory_order_relaxed);
+	m_numAllocations[static_cast<int>(category)].fetch_add(1, std::memory_order_relaxed);
+}//End OnAllocate
+
+void MemoryTracker::OnFree(const MemoryCategory category, const size_t bytes)
+{
+	m_allocatedBytes[static_cast<int>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+	m_numAllocations[static_cast<int>(category)].fetch_sub(1, std::memory_order_relaxed);
+}//End OnFree
+
+size_t MemoryTracker::GetAllocatedBytes(const MemoryCategory category) const
+{
+	return m_allocatedBytes[static_cast<int>(category)].load(std::memory_order_relaxed);
+}//End GetAllocatedBytes
+
+MemoryTracker::Registration MemoryTracker::Register(const MemoryCategory category, const std::string& name, SizeFunction getSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const int id = m_nextID++;
+	m_sources.push_back({ id, category, name, std::move(getSize) });
+	return Registration(id);
+}//End Register
+
+void MemoryTracker::Unregister(const int id)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_sources.erase(std::remove_if(m_sources.begin(), m_sources.end(), [id](const RegisteredSource& source) { return source.id == id; }), m_sources.end());
+}//End Unregister
+
+MemoryTracker::Report MemoryTracker::GetReport() const
+{
+	Report report;
+	for (int i = 0; i < NUM_CATEGORIES; i++)
+	{
+		report.categories[i].allocatedBytes = m_allocatedBytes[i].load(std::memory_order_relaxed);
+		report.categories[i].numAllocations = m_numAllocations[i].load(std::memory_order_relaxed);
+	}//End for
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const RegisteredSource& source : m_sources)
+	{
+		report.categories[static_cast<int>(source.category)].sources.push_back({ source.name, source.getSize() });
+	}//End for
+
+	return report;
+}//End GetReport
+
+bool MemoryTracker::WriteJSON(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	const std::string json = GetReport().ToJSON();
+	file.write(json.data(), static_cast<std::streamsize>(json.size()));
+	return static_cast<bool>(file);
+}//End WriteJSON
+
+const char* MemoryTracker::GetCategoryName(const MemoryCategory category)
+{
+	return CATEGORY_NAMES[static_cast<int>(category)];
+}//End GetCategoryName
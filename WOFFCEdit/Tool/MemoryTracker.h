@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+//What memory is for - reports are broken down by these
+enum class MemoryCategory
+{
+	SCENE_RECORDS,		//Scene graph records and components, the display list and transforms
+	MESHES,				//Vertex and index buffers
+	TEXTURES,
+	UNDO_HISTORY,		//Commands on the undo and redo stacks
+	STRINGS,			//Interned asset paths
+	COUNT
+};
+
+//Where the editor's memory goes, by category
+//Memory is counted two ways. Allocation hooks add and remove bytes as they are allocated and freed, for things made piecemeal
+//such as commands. Registered sources are asked for their size whenever a report is made, for containers and GPU resources
+//that can already measure themselves, so nothing has to be kept in step as they grow
+//Hook counts are atomic and sources are guarded by a lock, so any thread may allocate, register or report
+//Nothing here depends on the renderer, so headless tools report the same way the editor does
+class MemoryTracker
+{
+public:
+	using SizeFunction = std::function<size_t()>;
+
+	//A registered source - unregisters itself when destroyed, so an owner keeps one as a member and forgets about it
+	//The size function is called under the tracker's lock, so it must not register or unregister sources itself
+	class Registration
+	{
+	public:
+		Registration() : m_id(0) {}
+		~Registration() { Reset(); }
+		Registration(Registration&& other) : m_id(other.m_id) { other.m_id = 0; }
+		Registration& operator=(Registration&& other);
+		Registration(const Registration&) = delete;
+		Registration& operator=(const Registration&) = delete;
+
+		void Reset();								//Unregister now
+
+	private:
+		friend class MemoryTracker;
+		explicit Registration(const int id) : m_id(id) {}
+
+		int	m_id;									//0 when not registered
+	};
+
+	struct Source
+	{
+		std::string	name;
+		size_t		bytes;
+	};
+
+	struct CategoryReport
+	{
+		size_t				allocatedBytes;			//Live bytes from the allocation hooks
+		size_t				numAllocations;
+		std::vector<Source>	sources;				//Registered sources, in registration order
+
+		size_t GetTotal() const;
+	};
+
+	struct Report
+	{
+		CategoryReport	categories[static_cast<int>(MemoryCategory::COUNT)];
+
+		const CategoryReport&	Get(const MemoryCategory category) const { return categories[static_cast<int>(category)]; }
+		size_t					GetTotal() const;
+		std::string				ToJSON() const;
+	};
+
+	static MemoryTracker& GetInstance();
+
+	//Allocation hooks
+	void	OnAllocate(MemoryCategory category, size_t bytes);
+	void	OnFree(MemoryCategory category, size_t bytes);
+	size_t	GetAllocatedBytes(MemoryCategory category) const;
+
+	Registration	Register(MemoryCategory category, const std::string& name, SizeFunction getSize);
+
+	Report	GetReport() const;							//Measures every registered source
+	bool	WriteJSON(const std::string& path) const;	//Report written to a file - false if it can't be written
+
+	static const char*	GetCategoryName(MemoryCategory category);	//Also the category's key in the JSON
+
+private:
+	MemoryTracker();
+	MemoryTracker(const MemoryTracker&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+	void	Unregister(int id);
+
+	struct RegisteredSource
+	{
+		int				id;
+		MemoryCategory	category;
+		std::string		name;
+		SizeFunction	getSize;
+	};
+
+	mutable std::mutex				m_mutex;
+	std::vector<RegisteredSource>	m_sources;
+	int								m_nextID;
+
+	std::atomic<size_t>				m_allocatedBytes[static_cast<int>(MemoryCategory::COUNT)];
+	std::atomic<size_t>				m_numAllocations[static_cast<int>(MemoryCategory::COUNT)];
+};
+
+//Standard allocator that counts what a container allocates under a category
+template <typename T, MemoryCategory CATEGORY>
+class TrackedAllocator
+{
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind { using other = TrackedAllocator<U, CATEGORY>; };
+
+	TrackedAllocator() = default;
+	template <typename U>
+	TrackedAllocator(const TrackedAllocator<U, CATEGORY>&) {}
+
+	T* allocate(const size_t count)
+	{
+		T* memory = static_cast<T*>(::operator new(count * sizeof(T)));
+		MemoryTracker::GetInstance().OnAllocate(CATEGORY, count * sizeof(T));
+		return memory;
+	}//End allocate
+
+	void deallocate(T* memory, const size_t count)
+	{
+		MemoryTracker::GetInstance().OnFree(CATEGORY, count * sizeof(T));
+		::operator delete(memory);
+	}//End deallocate
+
+	template <typename U>
+	bool operator==(const TrackedAllocator<U, CATEGORY>&) const { return true; }
+	template <typename U>
+	bool operator!=(const TrackedAllocator<U, CATEGORY>&) const { return false; }
+};
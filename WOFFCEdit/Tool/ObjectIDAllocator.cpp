@@ -0,0 +1,25 @@
+#include "ObjectIDAllocator.h"
+#include "SceneDatabase.h"
+#include <algorithm>
+#include <functional>
+
+const int ObjectIDAllocator::BLOCK_SIZE;
+
+void ObjectIDAllocator::SetDatabase(SceneDatabase* database)
+{
+	m_database = database;
+	m_reserved.clear();
+}//End SetDatabase
+
+int ObjectIDAllocator::Allocate()
+{
+	if (m_reserved.empty())
+	{
+		if (!m_database || !m_database->AllocateObjectIDs(BLOCK_SIZE, m_reserved)) return -1;
+		std::sort(m_reserved.begin(), m_reserved.end(), std::greater<int>());
+	}//End if
+
+	const int objectID = m_reserved.back();
+	m_reserved.pop_back();
+	return objectID;
+}//End Allocate
@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+
+class SceneDatabase;
+
+//Hands out IDs for new objects that are unique across the whole level database, not just the loaded chunk
+//IDs are reserved from the database a block at a time, so most allocations don't touch it - IDs left in a block
+//when the editor closes are simply never used, leaving gaps that SceneTool compact-ids closes up
+class ObjectIDAllocator
+{
+public:
+	static const int BLOCK_SIZE = 16;
+
+	ObjectIDAllocator() : m_database(nullptr) {}
+
+	void	SetDatabase(SceneDatabase* database);	//Also forgets the IDs reserved from the previous one
+	int		Allocate();								//-1 if no database is set or it can't reserve more
+
+private:
+	SceneDatabase*		m_database;
+	std::vector<int>	m_reserved;					//Handed out lowest first, from the back
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include "AssetPathTable.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//Resources loaded from asset paths, one resident copy per path, shared through reference-counted handles
+//The cache knows nothing about what a resource is - a loader makes one from a path and a measure says how big it is - so the
+//lookup, counting and eviction work the same headless as they do with the renderer's textures behind them
+//A resource is evicted, and destroyed, as soon as the last handle to it goes. A path that can't be loaded is remembered and
+//given the fallback resource, which is loaded once on the first failure and stays resident until the cache is cleared
+//Handles keep the cache's bookkeeping alive, so they may outlive a Clear or the cache itself. Not thread safe - one thread
+//acquires and releases, and resources loaded on other threads are handed to it to Insert
+template <typename Resource>
+class ResourceCache
+{
+	struct State;
+
+public:
+	using Loader = std::function<bool(AssetID path, Resource& resource)>;	//False if the path can't be loaded
+	using Measure = std::function<size_t(const Resource& resource)>;
+
+	struct Stats
+	{
+		int		hits;
+		int		misses;								//Each one a load attempt
+		int		failures;							//Misses given the fallback
+		int		evictions;
+		int		numResident;						//The fallback included, once loaded
+		size_t	residentBytes;
+
+		double	GetHitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+	};
+
+	//One user's share of a resource - copying adds a user, destroying or resetting removes one
+	class Handle
+	{
+	public:
+		Handle() : m_entry(NONE) {}
+		Handle(const Handle& other) : m_state(other.m_state), m_entry(other.m_entry) { if (m_state) m_state->entries[m_entry].refCount++; }
+		Handle(Handle&& other) : m_state(std::move(other.m_state)), m_entry(other.m_entry) { other.m_entry = NONE; }
+		~Handle() { Reset(); }
+
+		Handle& operator=(Handle other)
+		{
+			std::swap(m_state, other.m_state);
+			std::swap(m_entry, other.m_entry);
+			return *this;
+		}//End assignment
+
+		void Reset()
+		{
+			if (!m_state) return;
+
+			m_state->Release(m_entry);
+			m_state.reset();
+			m_entry = NONE;
+		}//End Reset
+
+		bool		IsNull() const		{ return !m_state; }
+		explicit	operator bool() const	{ return static_cast<bool>(m_state); }
+
+		//A default resource for a null handle
+		const Resource&	GetResource() const	{ return m_state ? m_state->entries[m_entry].resource : GetEmpty(); }
+		AssetID			GetPath() const		{ return m_state ? m_state->entries[m_entry].path : AssetPathTable::NO_ASSET; }	//The fallback's path if the resource is the fallback
+		int				GetRefCount() const	{ return m_state ? m_state->entries[m_entry].refCount : 0; }
+
+	private:
+		friend class ResourceCache;
+		Handle(const std::shared_ptr<State>& state, const int entry) : m_state(state), m_entry(entry) { m_state->entries[m_entry].refCount++; }
+
+		static const Resource& GetEmpty()
+		{
+			static const Resource empty{};
+			return empty;
+		}//End GetEmpty
+
+		std::shared_ptr<State>	m_state;			//Null for a null handle
+		int						m_entry;
+	};
+
+	ResourceCache(Loader loader, Measure measure, const AssetID fallbackPath)
+		: m_loader(std::move(loader)), m_measure(std::move(measure)), m_fallbackPath(fallbackPath), m_fallbackTried(false), m_state(std::make_shared<State>())
+	{
+	}//End constructor
+
+	ResourceCache(const ResourceCache&) = delete;
+	ResourceCache& operator=(const ResourceCache&) = delete;
+
+	//The path's resource, loading it if no one holds it - the fallback if it can't be loaded, and a null handle if neither can
+	Handle Acquire(const AssetID path)
+	{
+		if (Contains(path)) return Find(path);
+
+		Resource resource{};
+		if (path != AssetPathTable::NO_ASSET && m_loader(path, resource)) return Insert(path, std::move(resource));
+		return InsertMissing(path);
+	}//End Acquire
+
+	//The path's resource if it has been loaded, or the fallback if it failed to - a null handle, counting nothing, if it has
+	//been neither
+	Handle Find(const AssetID path)
+	{
+		const auto found = m_state->lookup.find(path);
+		if (found == m_state->lookup.end()) return Handle();
+
+		m_state->stats.hits++;
+		return found->second == NONE ? m_fallback : Handle(m_state, found->second);
+	}//End Find
+
+	bool	Contains(const AssetID path) const { return m_state->lookup.count(path) != 0; }		//Resident, or known to be missing
+
+	//A resource loaded elsewhere, such as on a loader thread - if the path is already resident that copy is kept and returned
+	Handle Insert(const AssetID path, Resource resource)
+	{
+		m_state->stats.misses++;
+		const auto found = m_state->lookup.find(path);
+		if (found != m_state->lookup.end() && found->second != NONE) return Handle(m_state, found->second);
+
+		return Handle(m_state, AddEntry(path, std::move(resource)));
+	}//End Insert
+
+	//Remembers a path that failed to load elsewhere, so it isn't tried again - returns the fallback
+	Handle InsertMissing(const AssetID path)
+	{
+		m_state->stats.misses++;
+		if (Contains(path)) return Find(path);
+
+		m_state->stats.failures++;
+		m_state->lookup[path] = NONE;
+		return GetFallback();
+	}//End InsertMissing
+
+	//Forgets every path, so the next Acquire of each loads it afresh - resources still held are released by their last handle
+	void Clear()
+	{
+		m_fallback.Reset();
+		m_fallbackTried = false;
+		m_state = std::make_shared<State>();
+	}//End Clear
+
+	Stats	GetStats() const { return m_state->stats; }
+
+	//Handles to the path's resource - 0 if it isn't resident
+	int GetRefCount(const AssetID path) const
+	{
+		const auto found = m_state->lookup.find(path);
+		if (found == m_state->lookup.end()) return 0;
+		return found->second == NONE ? m_fallback.GetRefCount() : m_state->entries[found->second].refCount;
+	}//End GetRefCount
+
+private:
+	static const int NONE = -1;
+
+	struct Entry
+	{
+		AssetID		path;
+		Resource	resource;
+		size_t		bytes;
+		int			refCount;
+	};
+
+	struct State
+	{
+		std::vector<Entry>					entries;
+		std::vector<int>					freeEntries;	//Evicted entries, reused before the vector grows
+		std::unordered_map<AssetID, int>	lookup;			//Path to entry, NONE for paths that failed to load
+		Stats								stats{};
+
+		//A handle went - the last one takes the resource with it
+		void Release(const int index)
+		{
+			Entry& entry = entries[index];
+			if (--entry.refCount > 0) return;
+
+			const auto found = lookup.find(entry.path);
+			if (found != lookup.end() && found->second == index) lookup.erase(found);
+
+			stats.evictions++;
+			stats.numResident--;
+			stats.residentBytes -= entry.bytes;
+			entry.resource = Resource();
+			entry.bytes = 0;
+			freeEntries.push_back(index);
+		}//End Release
+	};
+
+	int AddEntry(const AssetID path, Resource resource)
+	{
+		State& state = *m_state;
+		int index;
+		if (!state.freeEntries.empty())
+		{
+			index = state.freeEntries.back();
+			state.freeEntries.pop_back();
+		}//End if
+		else
+		{
+			index = static_cast<int>(state.entries.size());
+			state.entries.emplace_back();
+		}//End else
+
+		Entry& entry = state.entries[index];
+		entry.path = path;
+		entry.bytes = m_measure ? m_measure(resource) : 0;
+		entry.resource = std::move(resource);
+		entry.refCount = 0;
+
+		state.lookup[path] = index;
+		state.stats.numResident++;
+		state.stats.residentBytes += entry.bytes;
+		return index;
+	}//End AddEntry
+
+	//Loaded on the first failure - if the fallback is also in use as an ordinary resource, that copy is shared
+	const Handle& GetFallback()
+	{
+		if (m_fallback || m_fallbackTried) return m_fallback;
+
+		m_fallbackTried = true;
+		const auto found = m_state->lookup.find(m_fallbackPath);
+		if (found != m_state->lookup.end())
+		{
+			if (found->second != NONE) m_fallback = Handle(m_state, found->second);
+			return m_fallback;
+		}//End if
+
+		Resource resource{};
+		if (m_fallbackPath != AssetPathTable::NO_ASSET && m_loader(m_fallbackPath, resource)) m_fallback = Handle(m_state, AddEntry(m_fallbackPath, std::move(resource)));
+		return m_fallback;
+	}//End GetFallback
+
+	Loader					m_loader;
+	Measure					m_measure;
+	const AssetID			m_fallbackPath;
+	bool					m_fallbackTried;		//So a missing fallback is only looked for once
+	std::shared_ptr<State>	m_state;
+	Handle					m_fallback;				//Keeps the fallback resident - declared after the state it refers to
+};
@@ -0,0 +1,20 @@
+#include "SceneChangeTracker.h"
+
+void SceneChangeTracker::ObjectModified(const int objectID)
+{
+	//An object can only be in one state - the latest edit wins
+	m_removedObjects.erase(objectID);
+	m_modifiedObjects.insert(objectID);
+}//End ObjectModified
+
+void SceneChangeTracker::ObjectRemoved(const int objectID)
+{
+	m_modifiedObjects.erase(objectID);
+	m_removedObjects.insert(objectID);
+}//End ObjectRemoved
+
+void SceneChangeTracker::Clear()
+{
+	m_modifiedObjects.clear();
+	m_removedObjects.clear();
+}//End Clear
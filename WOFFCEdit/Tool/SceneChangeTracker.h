@@ -0,0 +1,23 @@
+#pragma once
+#include <unordered_set>
+
+//Records which objects have been modified or removed since the last save, keyed by database ID
+//Fed by the edit commands so a save only has to write the rows that actually changed
+class SceneChangeTracker
+{
+public:
+	void	ObjectModified(int objectID);		//Object was added, moved, or restored - needs an upsert
+	void	ObjectRemoved(int objectID);		//Object no longer exists in the scene - needs a delete
+	void	Clear();
+
+	bool	HasChanges() const { return !m_modifiedObjects.empty() || !m_removedObjects.empty(); }
+	bool	IsModified(const int objectID) const { return m_modifiedObjects.count(objectID) != 0; }
+	bool	IsRemoved(const int objectID) const { return m_removedObjects.count(objectID) != 0; }
+
+	const std::unordered_set<int>& GetModifiedObjects() const { return m_modifiedObjects; }
+	const std::unordered_set<int>& GetRemovedObjects() const { return m_removedObjects; }
+
+private:
+	std::unordered_set<int> m_modifiedObjects;
+	std::unordered_set<int> m_removedObjects;
+};
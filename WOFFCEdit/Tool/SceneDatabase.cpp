@@ -0,0 +1,820 @@
+#include "SceneDatabase.h"
+#include "SceneSchema.h"
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+//Generated from the schema descriptor - the update's numbered parameters line up with the insert so both share one bind
+//The bundled SQLite predates UPSERT, so an update that touches no rows falls back to the insert
+static const std::string INSERT_OBJECT_SQL = SceneSchema::InsertSQL(SceneSchema::OBJECTS);
+static const std::string UPDATE_OBJECT_SQL = SceneSchema::UpdateSQL(SceneSchema::OBJECTS);
+
+//Spatial index - R*Tree column order is min/max per axis
+static const char* INSERT_BOUNDS_SQL = "INSERT INTO ObjectBounds VALUES(?,?,?,?,?,?,?)";
+static const char* DELETE_BOUNDS_SQL = "DELETE FROM ObjectBounds WHERE id=?";
+static const char* QUERY_BOX_SQL =
+	"SELECT id, min_x, max_x, min_y, max_y, min_z, max_z FROM ObjectBounds "
+	"WHERE max_x>=?1 AND min_x<=?2 AND max_y>=?3 AND min_y<=?4 AND max_z>=?5 AND min_z<=?6";
+static const char* SELECT_OBJECTS_IN_BOX_SQL =
+	"SELECT Objects.* FROM ObjectBounds JOIN Objects ON Objects.ID=ObjectBounds.id "
+	"WHERE max_x>=?1 AND min_x<=?2 AND max_y>=?3 AND min_y<=?4 AND max_z>=?5 AND min_z<=?6 AND Objects.chunk_ID=?7";
+
+//Each object is bounded by a sphere about its position - its model's radius from ModelBounds times its largest scale
+//Models with no radius recorded yet are assumed to fit this one, which must match the value baked into migration 3
+static const float OBJECT_BOUNDS_RADIUS = 1.0f;
+static const char* SELECT_MODEL_RADIUS_SQL = "SELECT radius FROM ModelBounds WHERE mesh=?";
+//Recording a radius - each statement takes the model as ?1 and, where it needs it, the radius as ?2
+static const char* INSERT_MODEL_RADIUS_SQL = "INSERT OR REPLACE INTO ModelBounds VALUES(?1,?2)";
+static const char* DELETE_MODEL_BOUNDS_SQL = "DELETE FROM ObjectBounds WHERE id IN (SELECT ID FROM Objects WHERE mesh=?1)";
+static const char* INSERT_MODEL_BOUNDS_SQL =
+	"INSERT INTO ObjectBounds SELECT ID, position_x - r, position_x + r, position_y - r, position_y + r, position_z - r, position_z + r FROM "
+	"(SELECT ID, position_x, position_y, position_z, max(abs(scale_x), abs(scale_y), abs(scale_z)) * ?2 AS r FROM Objects WHERE mesh=?1 AND ID IS NOT NULL GROUP BY ID)";
+
+static const char* DELETE_OBJECT_SQL = "DELETE FROM Objects WHERE ID=?";
+static const char* SELECT_CHUNK_SQL = "SELECT * FROM Chunks WHERE ID=?";
+static const char* SELECT_OBJECTS_SQL = "SELECT * FROM Objects WHERE chunk_ID=?";
+static const char* SELECT_OBJECT_SQL = "SELECT * FROM Objects WHERE ID=?";
+
+//Object ID allocation - freed IDs are stamped with the session that freed them, and only handed out again in a later one
+//A freed ID some row still names as its parent is held back too, or the object given it would adopt that row
+static const char* FREE_OBJECT_ID_SQL = "INSERT OR REPLACE INTO FreeObjectIDs SELECT ?, value FROM EditorMeta WHERE key='id_session'";
+static const char* SELECT_FREE_OBJECT_IDS_SQL =
+	"SELECT ID FROM FreeObjectIDs WHERE session < (SELECT value FROM EditorMeta WHERE key='id_session') "
+	"AND NOT EXISTS (SELECT 1 FROM Objects WHERE parent_ID = FreeObjectIDs.ID) ORDER BY ID LIMIT ?";
+static const char* DELETE_FREE_OBJECT_IDS_SQL =
+	"DELETE FROM FreeObjectIDs WHERE ID <= ? AND session < (SELECT value FROM EditorMeta WHERE key='id_session') "
+	"AND NOT EXISTS (SELECT 1 FROM Objects WHERE parent_ID = FreeObjectIDs.ID)";
+static const char* SELECT_NEXT_OBJECT_ID_SQL = "SELECT value FROM EditorMeta WHERE key='next_object_id'";
+static const char* ADVANCE_NEXT_OBJECT_ID_SQL = "UPDATE EditorMeta SET value = value + ? WHERE key='next_object_id'";
+
+//Whatever wrote the rows, IDs they use come off the free list and the high-water mark moves above them
+//Both are served by the ID index, so the cost is the size of the free list rather than the table
+static const char* RESERVE_SAVED_OBJECT_IDS_SQL =
+	"DELETE FROM FreeObjectIDs WHERE EXISTS (SELECT 1 FROM Objects WHERE Objects.ID = FreeObjectIDs.ID);"
+	"UPDATE EditorMeta SET value = max(value, (SELECT coalesce(max(ID), 0) + 1 FROM Objects)) WHERE key='next_object_id';";
+
+//Compaction - the map numbers the distinct IDs from 1 in their existing order, through its rowid
+static const char* BUILD_OBJECT_ID_MAP_SQL =
+	"CREATE TEMP TABLE ObjectIDMap (new INTEGER PRIMARY KEY, old INTEGER UNIQUE);"
+	"INSERT INTO ObjectIDMap (old) SELECT DISTINCT ID FROM Objects WHERE ID IS NOT NULL ORDER BY ID;";
+static const char* RENUMBER_OBJECTS_SQL =
+	"UPDATE Objects SET parent_ID = coalesce((SELECT new FROM ObjectIDMap WHERE old = Objects.parent_ID), 0) WHERE parent_ID <> 0;"
+	"UPDATE Objects SET ID = (SELECT new FROM ObjectIDMap WHERE old = Objects.ID) WHERE ID IS NOT NULL;";
+static const char* RENUMBER_BOUNDS_SQL =
+	"CREATE TEMP TABLE OldObjectBounds AS SELECT * FROM ObjectBounds;"
+	"DELETE FROM ObjectBounds;"
+	"INSERT INTO ObjectBounds SELECT ObjectIDMap.new, min_x, max_x, min_y, max_y, min_z, max_z FROM OldObjectBounds JOIN ObjectIDMap ON ObjectIDMap.old = OldObjectBounds.id;"
+	"DROP TABLE OldObjectBounds;";
+static const char* RESET_OBJECT_ID_ALLOCATION_SQL =
+	"DELETE FROM FreeObjectIDs;"
+	"UPDATE EditorMeta SET value = (SELECT count(*) FROM ObjectIDMap) + 1 WHERE key='next_object_id';";
+
+//Schema migrations, applied in order - entry N takes the database from user_version N to N + 1
+//Only ever append to this list, never edit an entry that has shipped
+static const char* SCHEMA_MIGRATIONS[] =
+{
+	//1: Index the columns that loading and incremental saving filter on
+	"CREATE INDEX IF NOT EXISTS Objects_chunk_ID ON Objects(chunk_ID);"
+	"CREATE INDEX IF NOT EXISTS Objects_ID ON Objects(ID);",
+
+	//2: Key/value table for editor bookkeeping, starting with the revision counter snapshots are validated against
+	"CREATE TABLE IF NOT EXISTS EditorMeta (key TEXT PRIMARY KEY, value INTEGER);"
+	"INSERT OR IGNORE INTO EditorMeta VALUES ('revision', 0);",
+
+	//3: R*Tree over every object's world-space bounds, filled from the existing rows
+	"CREATE VIRTUAL TABLE IF NOT EXISTS ObjectBounds USING rtree(id, min_x, max_x, min_y, max_y, min_z, max_z);"
+	"DELETE FROM ObjectBounds;"
+	"INSERT INTO ObjectBounds SELECT ID, position_x - r, position_x + r, position_y - r, position_y + r, position_z - r, position_z + r FROM "
+	"(SELECT ID, position_x, position_y, position_z, max(abs(scale_x), abs(scale_y), abs(scale_z)) * 1.0 AS r FROM Objects "
+	"WHERE rowid IN (SELECT max(rowid) FROM Objects WHERE ID IS NOT NULL GROUP BY ID));",
+
+	//4: Object ID allocation across every chunk - the high-water mark, the IDs deletes have freed, and the session counter
+	"CREATE TABLE IF NOT EXISTS FreeObjectIDs (ID INTEGER PRIMARY KEY, session INTEGER);"
+	"INSERT OR IGNORE INTO EditorMeta SELECT 'next_object_id', coalesce(max(ID), 0) + 1 FROM Objects;"
+	"INSERT OR IGNORE INTO EditorMeta VALUES ('id_session', 0);",
+
+	//5: Index parent IDs, so ID allocation can skip freed IDs that rows still name as their parent
+	"CREATE INDEX IF NOT EXISTS Objects_parent_ID ON Objects(parent_ID);",
+
+	//6: The first editor saved every object with its own ID as its chunk_ID, and loaded every row whatever its chunk, so levels it
+	//saved load empty once loading is chunk-scoped. It only ever had one chunk, so in a single-chunk level every row naming a chunk
+	//that doesn't exist is moved into the one that does. The revision moves on so snapshots taken of the empty chunk are dropped
+	"UPDATE Objects SET chunk_ID = (SELECT ID FROM Chunks) "
+	"WHERE (SELECT count(*) FROM Chunks) = 1 AND chunk_ID NOT IN (SELECT ID FROM Chunks);"
+	"UPDATE EditorMeta SET value = value + 1 WHERE key='revision';",
+
+	//7: Each model's bounding radius about its origin, recorded as models are loaded - until then its objects keep the unit radius
+	"CREATE TABLE IF NOT EXISTS ModelBounds (mesh TEXT PRIMARY KEY, radius REAL);",
+};
+
+//Run a one-off query for a single integer
+static bool SelectInt(sqlite3* connection, const char* sql, int& value)
+{
+	sqlite3_stmt* statement = nullptr;
+	if (sqlite3_prepare_v2(connection, sql, -1, &statement, nullptr) != SQLITE_OK) return false;
+
+	const bool found = sqlite3_step(statement) == SQLITE_ROW;
+	if (found) value = sqlite3_column_int(statement, 0);
+	sqlite3_finalize(statement);
+	return found;
+}//End SelectInt
+
+SceneDatabase::SceneDatabase() :
+m_connection(nullptr), m_insertObjectStatement(nullptr), m_updateObjectStatement(nullptr), m_deleteObjectStatement(nullptr),
+m_selectChunkStatement(nullptr), m_selectObjectsStatement(nullptr), m_insertBoundsStatement(nullptr), m_deleteBoundsStatement(nullptr),
+m_queryBoxStatement(nullptr), m_selectObjectsInBoxStatement(nullptr), m_freeObjectIDStatement(nullptr), m_selectObjectStatement(nullptr),
+m_selectModelRadiusStatement(nullptr)
+{
+}//End default constructor
+
+SceneDatabase::~SceneDatabase()
+{
+	Close();
+}//End destructor
+
+bool SceneDatabase::Open(const char* path, const int flags)
+{
+	Close();
+
+	if (sqlite3_open_v2(path, &m_connection, flags, nullptr) != SQLITE_OK)
+	{
+		//A handle is still allocated on failure, so it must be closed
+		Close();
+		return false;
+	}//End if
+
+	//The editor and the autosave worker use separate connections - wait briefly on a lock rather than failing outright
+	sqlite3_busy_timeout(m_connection, 5000);
+
+	return true;
+}//End Open
+
+void SceneDatabase::Close()
+{
+	//Finalizing a null statement is a harmless no-op
+	sqlite3_finalize(m_insertObjectStatement);
+	sqlite3_finalize(m_updateObjectStatement);
+	sqlite3_finalize(m_deleteObjectStatement);
+	sqlite3_finalize(m_selectChunkStatement);
+	sqlite3_finalize(m_selectObjectsStatement);
+	sqlite3_finalize(m_insertBoundsStatement);
+	sqlite3_finalize(m_deleteBoundsStatement);
+	sqlite3_finalize(m_queryBoxStatement);
+	sqlite3_finalize(m_selectObjectsInBoxStatement);
+	sqlite3_finalize(m_freeObjectIDStatement);
+	sqlite3_finalize(m_selectObjectStatement);
+	sqlite3_finalize(m_selectModelRadiusStatement);
+	m_insertObjectStatement = nullptr;
+	m_updateObjectStatement = nullptr;
+	m_deleteObjectStatement = nullptr;
+	m_selectChunkStatement = nullptr;
+	m_selectObjectsStatement = nullptr;
+	m_insertBoundsStatement = nullptr;
+	m_deleteBoundsStatement = nullptr;
+	m_queryBoxStatement = nullptr;
+	m_selectObjectsInBoxStatement = nullptr;
+	m_freeObjectIDStatement = nullptr;
+	m_selectObjectStatement = nullptr;
+	m_selectModelRadiusStatement = nullptr;
+	m_selectChunkColumns.clear();
+	m_selectObjectsColumns.clear();
+	m_selectObjectsInBoxColumns.clear();
+	m_selectObjectColumns.clear();
+	m_modelRadii.clear();
+
+	if (m_connection)
+	{
+		sqlite3_close(m_connection);
+		m_connection = nullptr;
+	}//End if
+}//End Close
+
+bool SceneDatabase::Migrate()
+{
+	if (!m_connection) return false;
+
+	const int numMigrations = sizeof(SCHEMA_MIGRATIONS) / sizeof(SCHEMA_MIGRATIONS[0]);
+	for (int version = GetSchemaVersion(); version < numMigrations; version++)
+	{
+		//Each step and its version bump commit together, so a failed step can simply be retried next time
+		if (!BeginTransaction()) return false;
+
+		const std::string bumpVersion = "PRAGMA user_version = " + std::to_string(version + 1);
+		if (!Execute(SCHEMA_MIGRATIONS[version]) || !Execute(bumpVersion.c_str()) || !CommitTransaction())
+		{
+			RollbackTransaction();
+			return false;
+		}//End if
+	}//End for
+
+	return true;
+}//End Migrate
+
+bool SceneDatabase::EnableWriteAheadLog()
+{
+	sqlite3_stmt* statement = nullptr;
+	if (!m_connection || sqlite3_prepare_v2(m_connection, "PRAGMA journal_mode=WAL", -1, &statement, nullptr) != SQLITE_OK) return false;
+
+	//The pragma reports the mode actually in effect, which stays as it was if WAL isn't available
+	const bool enabled = sqlite3_step(statement) == SQLITE_ROW && sqlite3_strnicmp(reinterpret_cast<const char*>(sqlite3_column_text(statement, 0)), "wal", 4) == 0;
+	sqlite3_finalize(statement);
+	return enabled;
+}//End EnableWriteAheadLog
+
+int SceneDatabase::GetSchemaVersion() const
+{
+	sqlite3_stmt* statement = nullptr;
+	if (sqlite3_prepare_v2(m_connection, "PRAGMA user_version", -1, &statement, nullptr) != SQLITE_OK) return 0;
+
+	const int version = sqlite3_step(statement) == SQLITE_ROW ? sqlite3_column_int(statement, 0) : 0;
+	sqlite3_finalize(statement);
+	return version;
+}//End GetSchemaVersion
+
+bool SceneDatabase::LoadChunk(const int chunkID, ChunkObject& chunk)
+{
+	if (!m_connection || !Prepare(m_selectChunkStatement, SELECT_CHUNK_SQL)) return false;
+
+	//Column positions are looked up by name once, when the statement is first prepared
+	if (m_selectChunkColumns.empty()) m_selectChunkColumns = SceneSchema::ResolveColumns(m_selectChunkStatement, SceneSchema::CHUNKS);
+
+	sqlite3_bind_int(m_selectChunkStatement, 1, chunkID);
+	const bool found = sqlite3_step(m_selectChunkStatement) == SQLITE_ROW;
+	if (found) SceneSchema::Read(m_selectChunkStatement, SceneSchema::CHUNKS, m_selectChunkColumns, chunk);
+	sqlite3_reset(m_selectChunkStatement);
+
+	return found;
+}//End LoadChunk
+
+bool SceneDatabase::LoadObjects(const int chunkID, std::vector<SceneObject>& objects)
+{
+	if (!m_connection || !Prepare(m_selectObjectsStatement, SELECT_OBJECTS_SQL)) return false;
+	if (m_selectObjectsColumns.empty()) m_selectObjectsColumns = SceneSchema::ResolveColumns(m_selectObjectsStatement, SceneSchema::OBJECTS);
+
+	//Served by the chunk_ID index, so the cost is the size of this chunk rather than the whole world
+	sqlite3_bind_int(m_selectObjectsStatement, 1, chunkID);
+
+	int rc;
+	while ((rc = sqlite3_step(m_selectObjectsStatement)) == SQLITE_ROW)
+	{
+		objects.emplace_back();
+		SceneSchema::Read(m_selectObjectsStatement, SceneSchema::OBJECTS, m_selectObjectsColumns, objects.back());
+	}//End while
+	sqlite3_reset(m_selectObjectsStatement);
+
+	return rc == SQLITE_DONE;
+}//End LoadObjects
+
+//Run a one-off query and hand each row to the visitor, reading only the columns the table describes
+template <typename Record>
+static bool ForEachRow(sqlite3* connection, const std::string& sql, const int chunkID, const SceneSchema::Table<Record>& table, const std::function<bool(const Record&)>& visitor)
+{
+	//Bulk tools run this once, so the statement isn't worth caching
+	sqlite3_stmt* statement = nullptr;
+	if (!connection || sqlite3_prepare_v2(connection, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK) return false;
+
+	if (chunkID != SceneDatabase::ALL_CHUNKS) sqlite3_bind_int(statement, 1, chunkID);
+	const std::vector<int> resultColumns = SceneSchema::ResolveColumns(statement, table);
+
+	Record record;
+	int rc;
+	while ((rc = sqlite3_step(statement)) == SQLITE_ROW)
+	{
+		SceneSchema::Read(statement, table, resultColumns, record);
+		if (!visitor(record))
+		{
+			rc = SQLITE_DONE;
+			break;
+		}//End if
+	}//End while
+	sqlite3_finalize(statement);
+
+	return rc == SQLITE_DONE;
+}//End ForEachRow
+
+bool SceneDatabase::ForEachObject(const int chunkID, const std::function<bool(const SceneObject&)>& visitor)
+{
+	return ForEachRow(m_connection, chunkID == ALL_CHUNKS ? "SELECT * FROM Objects ORDER BY ID" : SELECT_OBJECTS_SQL, chunkID, SceneSchema::OBJECTS, visitor);
+}//End ForEachObject
+
+bool SceneDatabase::ForEachObjectWithoutCold(const int chunkID, const std::function<bool(const SceneObject&)>& visitor)
+{
+	const std::string sql = SceneSchema::SelectSQL(SceneSchema::OBJECTS, false) + (chunkID == ALL_CHUNKS ? " ORDER BY ID" : " WHERE chunk_ID=?");
+	return ForEachRow(m_connection, sql, chunkID, SceneSchema::OBJECTS, visitor);
+}//End ForEachObjectWithoutCold
+
+bool SceneDatabase::ForEachObjectWithID(const std::vector<int>& objectIDs, const std::function<bool(const SceneObject&)>& visitor)
+{
+	if (!m_connection || !Prepare(m_selectObjectStatement, SELECT_OBJECT_SQL)) return false;
+	if (m_selectObjectColumns.empty()) m_selectObjectColumns = SceneSchema::ResolveColumns(m_selectObjectStatement, SceneSchema::OBJECTS);
+
+	//One lookup on the ID index per object, so a handful of rows costs a handful of reads rather than a scan of the chunk
+	SceneObject object;
+	for (const int objectID : objectIDs)
+	{
+		sqlite3_bind_int(m_selectObjectStatement, 1, objectID);
+		const int rc = sqlite3_step(m_selectObjectStatement);
+		if (rc == SQLITE_ROW) SceneSchema::Read(m_selectObjectStatement, SceneSchema::OBJECTS, m_selectObjectColumns, object);
+		sqlite3_reset(m_selectObjectStatement);
+
+		if (rc != SQLITE_ROW && rc != SQLITE_DONE) return false;
+		if (rc == SQLITE_ROW && !visitor(object)) break;
+	}//End for
+
+	return true;
+}//End ForEachObjectWithID
+
+int64_t SceneDatabase::GetRevision()
+{
+	sqlite3_stmt* statement = nullptr;
+	if (!m_connection || sqlite3_prepare_v2(m_connection, "SELECT value FROM EditorMeta WHERE key='revision'", -1, &statement, nullptr) != SQLITE_OK) return -1;
+
+	//-1 means "unknown", which never matches a cached revision
+	const int64_t revision = sqlite3_step(statement) == SQLITE_ROW ? sqlite3_column_int64(statement, 0) : -1;
+	sqlite3_finalize(statement);
+	return revision;
+}//End GetRevision
+
+void SceneDatabase::BumpRevision() const
+{
+	//Databases that haven't been migrated have no revision row, and nothing can be cached against them either
+	Execute("UPDATE EditorMeta SET value = value + 1 WHERE key='revision'");
+}//End BumpRevision
+
+std::vector<int> SceneDatabase::GetChunkIDs()
+{
+	std::vector<int> chunkIDs;
+
+	sqlite3_stmt* statement = nullptr;
+	if (!m_connection || sqlite3_prepare_v2(m_connection, "SELECT ID FROM Chunks ORDER BY ID", -1, &statement, nullptr) != SQLITE_OK) return chunkIDs;
+
+	while (sqlite3_step(statement) == SQLITE_ROW)
+	{
+		chunkIDs.push_back(sqlite3_column_int(statement, 0));
+	}//End while
+	sqlite3_finalize(statement);
+
+	return chunkIDs;
+}//End GetChunkIDs
+
+int SceneDatabase::SaveAllObjects(const std::vector<SceneObject>& objects)
+{
+	if (!m_connection) return -1;
+
+	//Prepare the insert once and keep it for every subsequent save
+	if (!Prepare(m_insertObjectStatement, INSERT_OBJECT_SQL.c_str())) return -1;
+
+	//Everything happens inside one transaction so the journal is only synced once per save
+	if (!BeginTransaction()) return -1;
+
+	if (!Execute("DELETE FROM Objects") || (HasSpatialIndex() && !Execute("DELETE FROM ObjectBounds")))
+	{
+		RollbackTransaction();
+		return -1;
+	}//End if
+
+	const int numObjects = static_cast<int>(objects.size());
+	for (int i = 0; i < numObjects; i++)
+	{
+		const bool bound = SceneSchema::Bind(m_insertObjectStatement, SceneSchema::OBJECTS, objects[i]);
+		const int rc = bound ? sqlite3_step(m_insertObjectStatement) : SQLITE_ERROR;
+		sqlite3_reset(m_insertObjectStatement);
+
+		if (rc != SQLITE_DONE || !WriteObjectBounds(objects[i]))
+		{
+			RollbackTransaction();
+			return -1;
+		}//End if
+	}//End for
+
+	//Release the string bindings so the statement doesn't keep pointers into the caller's objects
+	sqlite3_clear_bindings(m_insertObjectStatement);
+
+	if (!ReserveSavedObjectIDs())
+	{
+		RollbackTransaction();
+		return -1;
+	}//End if
+
+	BumpRevision();
+
+	if (!CommitTransaction())
+	{
+		RollbackTransaction();
+		return -1;
+	}//End if
+
+	return numObjects;
+}//End SaveAllObjects
+
+int SceneDatabase::SaveObjectChanges(const std::vector<const SceneObject*>& modifiedObjects, const std::unordered_set<int>& removedObjectIDs)
+{
+	if (!m_connection) return -1;
+
+	if (!Prepare(m_insertObjectStatement, INSERT_OBJECT_SQL.c_str()) ||
+		!Prepare(m_updateObjectStatement, UPDATE_OBJECT_SQL.c_str()) ||
+		!Prepare(m_deleteObjectStatement, DELETE_OBJECT_SQL))
+	{
+		return -1;
+	}//End if
+
+	//Nothing to do - don't even open a transaction
+	if (modifiedObjects.empty() && removedObjectIDs.empty()) return 0;
+
+	//A caller that already opened a transaction (e.g. a bulk import) gets the rows added to it instead
+	//On failure only a transaction opened here is rolled back - the caller's is left for it to roll back
+	const bool ownTransaction = sqlite3_get_autocommit(m_connection) != 0;
+	if (ownTransaction && !BeginTransaction()) return -1;
+	const auto fail = [this, ownTransaction]()
+	{
+		if (ownTransaction) RollbackTransaction();
+		return -1;
+	};
+
+	int rowsTouched = 0;
+
+	for (const int objectID : removedObjectIDs)
+	{
+		sqlite3_bind_int(m_deleteObjectStatement, 1, objectID);
+		const int rc = sqlite3_step(m_deleteObjectStatement);
+		sqlite3_reset(m_deleteObjectStatement);
+
+		if (rc != SQLITE_DONE) return fail();
+
+		rowsTouched += sqlite3_changes(m_connection);
+
+		if (!RemoveObjectBounds(objectID) || !FreeObjectID(objectID)) return fail();
+	}//End for
+
+	for (const SceneObject* object : modifiedObjects)
+	{
+		if (!UpsertObject(*object) || !WriteObjectBounds(*object)) return fail();
+
+		rowsTouched++;
+	}//End for
+
+	sqlite3_clear_bindings(m_insertObjectStatement);
+	sqlite3_clear_bindings(m_updateObjectStatement);
+
+	if (!ReserveSavedObjectIDs()) return fail();
+
+	BumpRevision();
+
+	if (ownTransaction && !CommitTransaction()) return fail();
+
+	return rowsTouched;
+}//End SaveObjectChanges
+
+bool SceneDatabase::UpsertObject(const SceneObject& object)
+{
+	//Try to update the existing row first
+	int rc = SceneSchema::Bind(m_updateObjectStatement, SceneSchema::OBJECTS, object) ? sqlite3_step(m_updateObjectStatement) : SQLITE_ERROR;
+	sqlite3_reset(m_updateObjectStatement);
+
+	if (rc != SQLITE_DONE) return false;
+	if (sqlite3_changes(m_connection) > 0) return true;
+
+	//No row with this ID yet, so it's a new object
+	rc = SceneSchema::Bind(m_insertObjectStatement, SceneSchema::OBJECTS, object) ? sqlite3_step(m_insertObjectStatement) : SQLITE_ERROR;
+	sqlite3_reset(m_insertObjectStatement);
+
+	return rc == SQLITE_DONE;
+}//End UpsertObject
+
+ObjectBounds SceneDatabase::GetObjectBounds(const SceneObject& object, const float modelRadius)
+{
+	//Scaled bounding sphere, so the box holds whatever the rotation
+	const float radius = std::max(std::fabs(object.scaX), std::max(std::fabs(object.scaY), std::fabs(object.scaZ))) * modelRadius;
+
+	ObjectBounds bounds;
+	bounds.minX = object.posX - radius;	bounds.maxX = object.posX + radius;
+	bounds.minY = object.posY - radius;	bounds.maxY = object.posY + radius;
+	bounds.minZ = object.posZ - radius;	bounds.maxZ = object.posZ + radius;
+	return bounds;
+}//End GetObjectBounds
+
+float SceneDatabase::GetModelRadius(const std::string& modelPath)
+{
+	//A save's objects share a handful of models, so each is only looked up once
+	const auto cached = m_modelRadii.find(modelPath);
+	if (cached != m_modelRadii.end()) return cached->second;
+
+	//Only fails to prepare when the database predates migration 7
+	float radius = OBJECT_BOUNDS_RADIUS;
+	if (Prepare(m_selectModelRadiusStatement, SELECT_MODEL_RADIUS_SQL))
+	{
+		sqlite3_bind_text(m_selectModelRadiusStatement, 1, modelPath.c_str(), static_cast<int>(modelPath.size()), SQLITE_TRANSIENT);
+		if (sqlite3_step(m_selectModelRadiusStatement) == SQLITE_ROW) radius = static_cast<float>(sqlite3_column_double(m_selectModelRadiusStatement, 0));
+		sqlite3_reset(m_selectModelRadiusStatement);
+	}//End if
+
+	m_modelRadii.emplace(modelPath, radius);
+	return radius;
+}//End GetModelRadius
+
+bool SceneDatabase::SetModelRadius(const std::string& modelPath, const float radius)
+{
+	//Every load of a model reports its radius, but only the first for a database changes anything
+	if (!m_connection || !HasSpatialIndex()) return false;
+	m_modelRadii.erase(modelPath);
+	if (GetModelRadius(modelPath) == radius) return true;
+
+	const bool ownTransaction = sqlite3_get_autocommit(m_connection) != 0;
+	if (ownTransaction && !BeginTransaction()) return false;
+
+	//The model's objects are re-bounded in the same transaction, so the index never mixes the old radius with the new
+	bool written = true;
+	const char* const statements[] = { INSERT_MODEL_RADIUS_SQL, DELETE_MODEL_BOUNDS_SQL, INSERT_MODEL_BOUNDS_SQL };
+	for (const char* const sql : statements)
+	{
+		sqlite3_stmt* statement = nullptr;
+		written = sqlite3_prepare_v2(m_connection, sql, -1, &statement, nullptr) == SQLITE_OK;
+		if (written)
+		{
+			sqlite3_bind_text(statement, 1, modelPath.c_str(), static_cast<int>(modelPath.size()), SQLITE_TRANSIENT);
+			if (sqlite3_bind_parameter_count(statement) > 1) sqlite3_bind_double(statement, 2, radius);
+			written = sqlite3_step(statement) == SQLITE_DONE;
+		}//End if
+		sqlite3_finalize(statement);
+
+		if (!written) break;
+	}//End for
+
+	if (written) BumpRevision();
+	if (ownTransaction && (!written || !CommitTransaction()))
+	{
+		RollbackTransaction();
+		return false;
+	}//End if
+
+	//Only once it has committed - a rollback leaves the old radius in place
+	if (written) m_modelRadii[modelPath] = radius;
+	return written;
+}//End SetModelRadius
+
+bool SceneDatabase::HasSpatialIndex()
+{
+	//Only fails to prepare when the database predates migration 3
+	return Prepare(m_deleteBoundsStatement, DELETE_BOUNDS_SQL);
+}//End HasSpatialIndex
+
+bool SceneDatabase::RemoveObjectBounds(const int objectID)
+{
+	if (!HasSpatialIndex()) return true;
+
+	sqlite3_bind_int(m_deleteBoundsStatement, 1, objectID);
+	const int rc = sqlite3_step(m_deleteBoundsStatement);
+	sqlite3_reset(m_deleteBoundsStatement);
+
+	return rc == SQLITE_DONE;
+}//End RemoveObjectBounds
+
+bool SceneDatabase::WriteObjectBounds(const SceneObject& object)
+{
+	//The bundled R*Tree has no INSERT OR REPLACE, so any old entry is removed first
+	if (!HasSpatialIndex()) return true;
+	if (!RemoveObjectBounds(object.ID) || !Prepare(m_insertBoundsStatement, INSERT_BOUNDS_SQL)) return false;
+
+	const ObjectBounds bounds = GetObjectBounds(object, GetModelRadius(object.model_path));
+	sqlite3_bind_int(m_insertBoundsStatement, 1, object.ID);
+	sqlite3_bind_double(m_insertBoundsStatement, 2, bounds.minX);
+	sqlite3_bind_double(m_insertBoundsStatement, 3, bounds.maxX);
+	sqlite3_bind_double(m_insertBoundsStatement, 4, bounds.minY);
+	sqlite3_bind_double(m_insertBoundsStatement, 5, bounds.maxY);
+	sqlite3_bind_double(m_insertBoundsStatement, 6, bounds.minZ);
+	sqlite3_bind_double(m_insertBoundsStatement, 7, bounds.maxZ);
+	const int rc = sqlite3_step(m_insertBoundsStatement);
+	sqlite3_reset(m_insertBoundsStatement);
+
+	return rc == SQLITE_DONE;
+}//End WriteObjectBounds
+
+bool SceneDatabase::HasIDAllocation()
+{
+	//Only fails to prepare when the database predates migration 4
+	return Prepare(m_freeObjectIDStatement, FREE_OBJECT_ID_SQL);
+}//End HasIDAllocation
+
+bool SceneDatabase::FreeObjectID(const int objectID)
+{
+	if (!HasIDAllocation()) return true;
+
+	sqlite3_bind_int(m_freeObjectIDStatement, 1, objectID);
+	const int rc = sqlite3_step(m_freeObjectIDStatement);
+	sqlite3_reset(m_freeObjectIDStatement);
+
+	return rc == SQLITE_DONE;
+}//End FreeObjectID
+
+bool SceneDatabase::ReserveSavedObjectIDs()
+{
+	return !HasIDAllocation() || Execute(RESERVE_SAVED_OBJECT_IDS_SQL);
+}//End ReserveSavedObjectIDs
+
+bool SceneDatabase::BeginIDSession()
+{
+	return m_connection && HasIDAllocation() && Execute("UPDATE EditorMeta SET value = value + 1 WHERE key='id_session'");
+}//End BeginIDSession
+
+bool SceneDatabase::AllocateObjectIDs(const int count, std::vector<int>& objectIDs)
+{
+	if (!m_connection || count <= 0 || !HasIDAllocation() || !BeginTransaction()) return false;
+
+	const size_t firstAllocated = objectIDs.size();
+	bool allocated = true;
+
+	//IDs freed in earlier sessions go first, lowest first, so the ID space stays dense
+	sqlite3_stmt* statement = nullptr;
+	if (sqlite3_prepare_v2(m_connection, SELECT_FREE_OBJECT_IDS_SQL, -1, &statement, nullptr) == SQLITE_OK)
+	{
+		sqlite3_bind_int(statement, 1, count);
+
+		int rc;
+		while ((rc = sqlite3_step(statement)) == SQLITE_ROW) objectIDs.push_back(sqlite3_column_int(statement, 0));
+		allocated = rc == SQLITE_DONE;
+	}//End if
+	else
+	{
+		allocated = false;
+	}//End else
+	sqlite3_finalize(statement);
+	statement = nullptr;
+
+	const int numFreed = static_cast<int>(objectIDs.size() - firstAllocated);
+	if (allocated && numFreed > 0)
+	{
+		//The free IDs taken are exactly the usable ones up to the highest of them
+		allocated = sqlite3_prepare_v2(m_connection, DELETE_FREE_OBJECT_IDS_SQL, -1, &statement, nullptr) == SQLITE_OK;
+		if (allocated)
+		{
+			sqlite3_bind_int(statement, 1, objectIDs.back());
+			allocated = sqlite3_step(statement) == SQLITE_DONE;
+		}//End if
+		sqlite3_finalize(statement);
+		statement = nullptr;
+	}//End if
+
+	//The rest come from above the high-water mark
+	const int numNew = count - numFreed;
+	int nextID = 0;
+	if (allocated && numNew > 0 && SelectInt(m_connection, SELECT_NEXT_OBJECT_ID_SQL, nextID) &&
+		sqlite3_prepare_v2(m_connection, ADVANCE_NEXT_OBJECT_ID_SQL, -1, &statement, nullptr) == SQLITE_OK)
+	{
+		sqlite3_bind_int(statement, 1, numNew);
+		allocated = sqlite3_step(statement) == SQLITE_DONE;
+		for (int i = 0; i < numNew; i++) objectIDs.push_back(nextID + i);
+	}//End if
+	else if (numNew > 0)
+	{
+		allocated = false;
+	}//End else if
+	sqlite3_finalize(statement);
+
+	//Committed straight away, so an ID is never handed out twice even if its object is never saved
+	if (!allocated || !CommitTransaction())
+	{
+		RollbackTransaction();
+		objectIDs.resize(firstAllocated);
+		return false;
+	}//End if
+
+	return true;
+}//End AllocateObjectIDs
+
+bool SceneDatabase::CompactObjectIDs(int& numObjects, int& numRenumbered)
+{
+	numObjects = 0;
+	numRenumbered = 0;
+	if (!m_connection || !BeginTransaction()) return false;
+
+	const bool compacted =
+		Execute(BUILD_OBJECT_ID_MAP_SQL) &&
+		SelectInt(m_connection, "SELECT count(*) FROM ObjectIDMap", numObjects) &&
+		SelectInt(m_connection, "SELECT count(*) FROM ObjectIDMap WHERE new <> old", numRenumbered) &&
+		Execute(RENUMBER_OBJECTS_SQL) &&
+		(!HasSpatialIndex() || Execute(RENUMBER_BOUNDS_SQL)) &&
+		(!HasIDAllocation() || Execute(RESET_OBJECT_ID_ALLOCATION_SQL)) &&
+		Execute("DROP TABLE ObjectIDMap");
+
+	if (compacted) BumpRevision();
+
+	if (!compacted || !CommitTransaction())
+	{
+		//The temporary tables go with the rollback
+		RollbackTransaction();
+		numObjects = 0;
+		numRenumbered = 0;
+		return false;
+	}//End if
+
+	return true;
+}//End CompactObjectIDs
+
+void SceneDatabase::BindBox(sqlite3_stmt* statement, const ObjectBounds& box)
+{
+	sqlite3_bind_double(statement, 1, box.minX);
+	sqlite3_bind_double(statement, 2, box.maxX);
+	sqlite3_bind_double(statement, 3, box.minY);
+	sqlite3_bind_double(statement, 4, box.maxY);
+	sqlite3_bind_double(statement, 5, box.minZ);
+	sqlite3_bind_double(statement, 6, box.maxZ);
+}//End BindBox
+
+bool SceneDatabase::QueryObjectsInBox(const ObjectBounds& box, std::vector<int>& objectIDs)
+{
+	if (!m_connection || !Prepare(m_queryBoxStatement, QUERY_BOX_SQL)) return false;
+
+	BindBox(m_queryBoxStatement, box);
+
+	int rc;
+	while ((rc = sqlite3_step(m_queryBoxStatement)) == SQLITE_ROW)
+	{
+		objectIDs.push_back(sqlite3_column_int(m_queryBoxStatement, 0));
+	}//End while
+	sqlite3_reset(m_queryBoxStatement);
+
+	return rc == SQLITE_DONE;
+}//End QueryObjectsInBox
+
+bool SceneDatabase::QueryObjectsInSphere(const float centreX, const float centreY, const float centreZ, const float radius, std::vector<int>& objectIDs)
+{
+	if (!m_connection || !Prepare(m_queryBoxStatement, QUERY_BOX_SQL)) return false;
+
+	//The index narrows it down to the sphere's bounding box, then each candidate box is tested against the sphere itself
+	const ObjectBounds sphereBox = { centreX - radius, centreY - radius, centreZ - radius, centreX + radius, centreY + radius, centreZ + radius };
+	BindBox(m_queryBoxStatement, sphereBox);
+
+	int rc;
+	while ((rc = sqlite3_step(m_queryBoxStatement)) == SQLITE_ROW)
+	{
+		//Closest point of the box to the centre, one axis at a time
+		float distanceSquared = 0.0f;
+		const float centre[3] = { centreX, centreY, centreZ };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float boxMin = static_cast<float>(sqlite3_column_double(m_queryBoxStatement, 1 + axis * 2));
+			const float boxMax = static_cast<float>(sqlite3_column_double(m_queryBoxStatement, 2 + axis * 2));
+			const float delta = centre[axis] < boxMin ? boxMin - centre[axis] : centre[axis] > boxMax ? centre[axis] - boxMax : 0.0f;
+			distanceSquared += delta * delta;
+		}//End for
+
+		if (distanceSquared <= radius * radius) objectIDs.push_back(sqlite3_column_int(m_queryBoxStatement, 0));
+	}//End while
+	sqlite3_reset(m_queryBoxStatement);
+
+	return rc == SQLITE_DONE;
+}//End QueryObjectsInSphere
+
+bool SceneDatabase::LoadObjectsInBox(const int chunkID, const ObjectBounds& box, std::vector<SceneObject>& objects)
+{
+	if (!m_connection || !Prepare(m_selectObjectsInBoxStatement, SELECT_OBJECTS_IN_BOX_SQL)) return false;
+	if (m_selectObjectsInBoxColumns.empty()) m_selectObjectsInBoxColumns = SceneSchema::ResolveColumns(m_selectObjectsInBoxStatement, SceneSchema::OBJECTS);
+
+	BindBox(m_selectObjectsInBoxStatement, box);
+	sqlite3_bind_int(m_selectObjectsInBoxStatement, 7, chunkID);
+
+	int rc;
+	while ((rc = sqlite3_step(m_selectObjectsInBoxStatement)) == SQLITE_ROW)
+	{
+		objects.emplace_back();
+		SceneSchema::Read(m_selectObjectsInBoxStatement, SceneSchema::OBJECTS, m_selectObjectsInBoxColumns, objects.back());
+	}//End while
+	sqlite3_reset(m_selectObjectsInBoxStatement);
+
+	return rc == SQLITE_DONE;
+}//End LoadObjectsInBox
+
+bool SceneDatabase::BeginTransaction()
+{
+	//Another connection may have recorded model radii since this one last looked
+	m_modelRadii.clear();
+	return Execute("BEGIN IMMEDIATE TRANSACTION");
+}//End BeginTransaction
+
+bool SceneDatabase::CommitTransaction()
+{
+	return Execute("COMMIT TRANSACTION");
+}//End CommitTransaction
+
+void SceneDatabase::RollbackTransaction()
+{
+	Execute("ROLLBACK TRANSACTION");
+}//End RollbackTransaction
+
+bool SceneDatabase::Execute(const char* sql) const
+{
+	return sqlite3_exec(m_connection, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+}//End Execute
+
+bool SceneDatabase::Prepare(sqlite3_stmt*& statement, const char* sql) const
+{
+	if (statement) return true;
+
+	if (sqlite3_prepare_v2(m_connection, sql, -1, &statement, nullptr) != SQLITE_OK)
+	{
+		statement = nullptr;
+		return false;
+	}//End if
+
+	return true;
+}//End Prepare
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../SQLITE/sqlite3.h"
+#include "SceneObject.h"
+#include "ChunkObject.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+//Axis-aligned world-space box, as stored in the spatial index
+struct ObjectBounds
+{
+	float minX, minY, minZ;
+	float maxX, maxY, maxZ;
+};
+
+//Wraps the level database connection and the bulk read/write paths that operate on it
+//Deliberately free of any Win32/DirectX dependencies so it can be driven headlessly
+class SceneDatabase
+{
+public:
+	SceneDatabase();
+	~SceneDatabase();
+
+	bool		Open(const char* path, int flags);						//Open a connection to the database at the given path
+	void		Close();												//Close the connection, finalizing any cached statements
+	bool		IsOpen() const { return m_connection != nullptr; }
+	sqlite3*	GetConnection() const { return m_connection; }
+
+	//Bring the schema up to date - indices and tables the editor relies on are added here, tracked by PRAGMA user_version
+	bool		Migrate();
+
+	//Switch the database to write-ahead logging so one connection can read while another commits
+	bool		EnableWriteAheadLog();
+
+	//Load a single chunk and only the objects that belong to it
+	bool		LoadChunk(int chunkID, ChunkObject& chunk);
+	bool		LoadObjects(int chunkID, std::vector<SceneObject>& objects);
+	std::vector<int> GetChunkIDs();
+
+	//Stream objects one row at a time without holding them all in memory - ALL_CHUNKS visits the whole table
+	//The visitor returns false to stop early, and the object it is given is reused for the next row
+	static const int ALL_CHUNKS = -1;
+	bool		ForEachObject(int chunkID, const std::function<bool(const SceneObject&)>& visitor);
+	bool		ForEachObjectWithoutCold(int chunkID, const std::function<bool(const SceneObject&)>& visitor);	//Columns marked SceneSchema::COLD aren't read and keep their defaults
+	bool		ForEachObjectWithID(const std::vector<int>& objectIDs, const std::function<bool(const SceneObject&)>& visitor);	//In the order given, skipping IDs with no row
+
+	//Spatial queries, served by the ObjectBounds R*Tree which every save keeps in step with the Objects table
+	//Results reflect the database as of the last save
+	bool		QueryObjectsInBox(const ObjectBounds& box, std::vector<int>& objectIDs);
+	bool		QueryObjectsInSphere(float centreX, float centreY, float centreZ, float radius, std::vector<int>& objectIDs);
+	bool		LoadObjectsInBox(int chunkID, const ObjectBounds& box, std::vector<SceneObject>& objects);	//Partial load of a chunk
+
+	//World-space bounds the index stores for an object whose model has the given radius about its origin, at unit scale
+	static ObjectBounds GetObjectBounds(const SceneObject& object, float modelRadius);
+
+	//Record a model's radius, as CMOModel::GetBoundingRadius works it out, and re-bound every object using it
+	//Until a model has one its objects are assumed to fit a unit sphere. Needs migration 7
+	//Joins the caller's transaction if one is already open
+	bool		SetModelRadius(const std::string& modelPath, float radius);
+
+	//Incremented by every write made through this class - caches of the database compare against it to detect staleness
+	int64_t		GetRevision();
+
+	//Replace the contents of the Objects table with the given objects in a single transaction
+	//Returns the number of rows written, or -1 if the save failed and was rolled back
+	int			SaveAllObjects(const std::vector<SceneObject>& objects);
+
+	//Upsert the modified objects and delete the removed IDs in a single transaction
+	//Returns the number of rows touched, or -1 if the save failed and was rolled back
+	//Joins the caller's transaction if one is already open
+	int			SaveObjectChanges(const std::vector<const SceneObject*>& modifiedObjects, const std::unordered_set<int>& removedObjectIDs);
+
+	//Object IDs unique across every chunk, reserved in the database so two sessions or a crash never hand one out twice
+	//IDs freed by deletes in earlier ID sessions are used first, lowest first, then IDs from above the high-water mark
+	//Appends count IDs, or none on failure. Needs migration 4
+	bool		AllocateObjectIDs(int count, std::vector<int>& objectIDs);
+
+	//Start a new ID session - IDs freed from here on aren't reused until the next one, since undo can still bring their objects back
+	//The editor starts one each time it opens the database
+	bool		BeginIDSession();
+
+	//Renumber every object from 1 in its existing order, rewriting parent_ID references, the spatial index and the allocator
+	//in a single transaction. Parent references to objects that no longer exist are cleared
+	//Edit journals and other files keyed by the old IDs are invalid afterwards, so only run it with the editor closed
+	bool		CompactObjectIDs(int& numObjects, int& numRenumbered);
+
+	bool		BeginTransaction();
+	bool		CommitTransaction();
+	void		RollbackTransaction();
+
+private:
+	bool		Execute(const char* sql) const;							//Run a statement that returns no rows
+	bool		Prepare(sqlite3_stmt*& statement, const char* sql) const;	//Prepare a cached statement if it hasn't been already
+	bool		UpsertObject(const SceneObject& object);
+	int			GetSchemaVersion() const;
+	void		BumpRevision() const;
+	bool		WriteObjectBounds(const SceneObject& object);				//Replace the object's entry in the spatial index
+	bool		RemoveObjectBounds(int objectID);
+	float		GetModelRadius(const std::string& modelPath);				//The unit radius if none is recorded
+	bool		HasSpatialIndex();
+	bool		HasIDAllocation();
+	bool		FreeObjectID(int objectID);									//Put a deleted object's ID on the free list
+	bool		ReserveSavedObjectIDs();									//Keep the allocator clear of IDs the saved rows use
+	static void	BindBox(sqlite3_stmt* statement, const ObjectBounds& box);
+
+	sqlite3*		m_connection;
+	sqlite3_stmt*	m_insertObjectStatement;							//Reused for every row of a bulk save
+	sqlite3_stmt*	m_updateObjectStatement;
+	sqlite3_stmt*	m_deleteObjectStatement;
+	sqlite3_stmt*	m_selectChunkStatement;
+	sqlite3_stmt*	m_selectObjectsStatement;
+	sqlite3_stmt*	m_insertBoundsStatement;
+	sqlite3_stmt*	m_deleteBoundsStatement;
+	sqlite3_stmt*	m_queryBoxStatement;
+	sqlite3_stmt*	m_selectObjectsInBoxStatement;
+	sqlite3_stmt*	m_freeObjectIDStatement;
+	sqlite3_stmt*	m_selectObjectStatement;
+	sqlite3_stmt*	m_selectModelRadiusStatement;
+	std::vector<int>	m_selectChunkColumns;								//Result column of each schema field, resolved once per statement
+	std::vector<int>	m_selectObjectsColumns;
+	std::vector<int>	m_selectObjectsInBoxColumns;
+	std::vector<int>	m_selectObjectColumns;
+	std::unordered_map<std::string, float>	m_modelRadii;					//Radii looked up since the last transaction began
+};
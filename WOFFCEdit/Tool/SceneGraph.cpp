@@ -0,0 +1,388 @@
+#include "SceneGraph.h"
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+	//Each boolean column and the flag it is packed into
+	struct FlagField
+	{
+		bool SceneObject::*	field;
+		SceneObjectFlag		flag;
+	};
+
+	const FlagField FLAG_FIELDS[] =
+	{
+		{ &SceneObject::render,					RENDER },
+		{ &SceneObject::collision,				COLLISION },
+		{ &SceneObject::collectable,			COLLECTABLE },
+		{ &SceneObject::destructable,			DESTRUCTABLE },
+		{ &SceneObject::editor_render,			EDITOR_RENDER },
+		{ &SceneObject::editor_texture_vis,		EDITOR_TEXTURE_VIS },
+		{ &SceneObject::editor_normals_vis,		EDITOR_NORMALS_VIS },
+		{ &SceneObject::editor_collision_vis,	EDITOR_COLLISION_VIS },
+		{ &SceneObject::editor_pivot_vis,		EDITOR_PIVOT_VIS },
+		{ &SceneObject::snapToGround,			SNAP_TO_GROUND },
+		{ &SceneObject::camera,					CAMERA },
+		{ &SceneObject::editor_wireframe,		EDITOR_WIREFRAME },
+	};
+
+	LightComponent ReadLight(const SceneObject& object)
+	{
+		LightComponent light;
+		light.light_type =			object.light_type;
+		light.light_diffuse_r = object.light_diffuse_r;		light.light_diffuse_g = object.light_diffuse_g;		light.light_diffuse_b = object.light_diffuse_b;
+		light.light_specular_r = object.light_specular_r;	light.light_specular_g = object.light_specular_g;	light.light_specular_b = object.light_specular_b;
+		light.light_spot_cutoff =	object.light_spot_cutoff;
+		light.light_constant =		object.light_constant;
+		light.light_linear =		object.light_linear;
+		light.light_quadratic =		object.light_quadratic;
+		return light;
+	}//End ReadLight
+
+	void WriteLight(const LightComponent& light, SceneObject& object)
+	{
+		object.light_type =			light.light_type;
+		object.light_diffuse_r = light.light_diffuse_r;		object.light_diffuse_g = light.light_diffuse_g;		object.light_diffuse_b = light.light_diffuse_b;
+		object.light_specular_r = light.light_specular_r;	object.light_specular_g = light.light_specular_g;	object.light_specular_b = light.light_specular_b;
+		object.light_spot_cutoff =	light.light_spot_cutoff;
+		object.light_constant =		light.light_constant;
+		object.light_linear =		light.light_linear;
+		object.light_quadratic =	light.light_quadratic;
+	}//End WriteLight
+
+	bool HasLight(const SceneObject& object, const SceneObject& defaults)
+	{
+		return object.light_type != defaults.light_type ||
+			object.light_diffuse_r != defaults.light_diffuse_r || object.light_diffuse_g != defaults.light_diffuse_g || object.light_diffuse_b != defaults.light_diffuse_b ||
+			object.light_specular_r != defaults.light_specular_r || object.light_specular_g != defaults.light_specular_g || object.light_specular_b != defaults.light_specular_b ||
+			object.light_spot_cutoff != defaults.light_spot_cutoff || object.light_constant != defaults.light_constant ||
+			object.light_linear != defaults.light_linear || object.light_quadratic != defaults.light_quadratic;
+	}//End HasLight
+
+	AudioComponent ReadAudio(const SceneObject& object)
+	{
+		AudioComponent audio;
+		audio.audio_path =		AssetPathTable::GetInstance().Intern(object.audio_path);
+		audio.volume =			object.volume;
+		audio.pitch =			object.pitch;
+		audio.pan =				object.pan;
+		audio.min_dist =		object.min_dist;
+		audio.max_dist =		object.max_dist;
+		audio.one_shot =		object.one_shot;
+		audio.play_on_init =	object.play_on_init;
+		audio.play_in_editor =	object.play_in_editor;
+		return audio;
+	}//End ReadAudio
+
+	void WriteAudio(const AudioComponent& audio, SceneObject& object)
+	{
+		object.audio_path =		AssetPathTable::GetInstance().GetPath(audio.audio_path);
+		object.volume =			audio.volume;
+		object.pitch =			audio.pitch;
+		object.pan =			audio.pan;
+		object.min_dist =		audio.min_dist;
+		object.max_dist =		audio.max_dist;
+		object.one_shot =		audio.one_shot;
+		object.play_on_init =	audio.play_on_init;
+		object.play_in_editor =	audio.play_in_editor;
+	}//End WriteAudio
+
+	bool HasAudio(const SceneObject& object, const SceneObject& defaults)
+	{
+		return object.audio_path != defaults.audio_path || object.volume != defaults.volume || object.pitch != defaults.pitch || object.pan != defaults.pan ||
+			object.min_dist != defaults.min_dist || object.max_dist != defaults.max_dist ||
+			object.one_shot != defaults.one_shot || object.play_on_init != defaults.play_on_init || object.play_in_editor != defaults.play_in_editor;
+	}//End HasAudio
+
+	SceneObject JoinRecords(const SceneObjectHot& hot, const SceneObjectCold& cold, const LightComponent* light, const AudioComponent* audio, const bool aiNode,
+		const PathNodeComponent* pathNode)
+	{
+		//Fields of components the object doesn't have keep a new object's defaults
+		SceneObject object;
+		object.ID =					hot.ID;
+		object.chunk_ID =			hot.chunk_ID;
+		object.parent_id =			hot.parent_id;
+		object.posX = hot.posX;		object.posY = hot.posY;		object.posZ = hot.posZ;
+		object.rotX = hot.rotX;		object.rotY = hot.rotY;		object.rotZ = hot.rotZ;
+		object.scaX = hot.scaX;		object.scaY = hot.scaY;		object.scaZ = hot.scaZ;
+		for (const FlagField& flagField : FLAG_FIELDS) object.*flagField.field = hot.GetFlag(flagField.flag);
+
+		const AssetPathTable& assetPaths = AssetPathTable::GetInstance();
+		object.model_path =			assetPaths.GetPath(hot.model_path);
+		object.tex_diffuse_path =	assetPaths.GetPath(hot.tex_diffuse_path);
+
+		object.name =				cold.name;
+		object.collision_mesh =		assetPaths.GetPath(cold.collision_mesh);
+		object.health_amount =		cold.health_amount;
+		object.pivotX = cold.pivotX;	object.pivotY = cold.pivotY;	object.pivotZ = cold.pivotZ;
+
+		if (light) WriteLight(*light, object);
+		if (audio) WriteAudio(*audio, object);
+		object.AINode = aiNode;
+		if (pathNode)
+		{
+			object.path_node =			pathNode->path_node;
+			object.path_node_start =	pathNode->path_node_start;
+			object.path_node_end =		pathNode->path_node_end;
+		}//End if
+
+		return object;
+	}//End JoinRecords
+}
+
+void SceneGraph::Clear()
+{
+	m_hot.clear();
+	m_cold.clear();
+	m_coldSource = nullptr;
+	m_lights.Clear();
+	m_audio.Clear();
+	m_aiNodes.Clear();
+	m_pathNodes.Clear();
+}//End Clear
+
+void SceneGraph::Reserve(const int numObjects)
+{
+	m_hot.reserve(numObjects);
+	m_cold.reserve(numObjects);
+}//End Reserve
+
+void SceneGraph::Swap(SceneGraph& other)
+{
+	m_hot.swap(other.m_hot);
+	m_cold.swap(other.m_cold);
+	m_coldSource.swap(other.m_coldSource);
+	m_lights.Swap(other.m_lights);
+	m_audio.Swap(other.m_audio);
+	m_aiNodes.Swap(other.m_aiNodes);
+	m_pathNodes.Swap(other.m_pathNodes);
+}//End Swap
+
+int SceneGraph::Add(const SceneObject& object)
+{
+	return Append(Split(object, true));
+}//End Add
+
+int SceneGraph::AddHot(const SceneObject& object)
+{
+	return Append(Split(object, false));
+}//End AddHot
+
+int SceneGraph::Append(Entry entry)
+{
+	AddComponents(entry);
+	m_hot.push_back(entry.hot);
+	m_cold.push_back(std::move(entry.cold));
+	return GetSize() - 1;
+}//End Append
+
+void SceneGraph::Insert(const int index, Entry entry)
+{
+	AddComponents(entry);
+	m_hot.insert(m_hot.begin() + index, entry.hot);
+	m_cold.insert(m_cold.begin() + index, std::move(entry.cold));
+}//End Insert
+
+SceneGraph::Entry SceneGraph::Extract(const int index)
+{
+	Entry entry = MoveOut(index);
+	m_hot.erase(m_hot.begin() + index);
+	m_cold.erase(m_cold.begin() + index);
+	return entry;
+}//End Extract
+
+SceneGraph::Entry SceneGraph::MoveOut(const int index)
+{
+	Entry entry;
+	entry.hot = m_hot[index];
+	entry.cold = std::move(m_cold[index]);
+
+	const int objectID = entry.hot.ID;
+	entry.hasLight =	m_lights.Remove(objectID, &entry.light);
+	entry.hasAudio =	m_audio.Remove(objectID, &entry.audio);
+	entry.hasAINode =	m_aiNodes.Remove(objectID);
+	entry.hasPathNode =	m_pathNodes.Remove(objectID, &entry.pathNode);
+	return entry;
+}//End MoveOut
+
+SceneGraph::Entry SceneGraph::Duplicate(const int index)
+{
+	if (!m_cold[index]) LoadCold(std::vector<int>(1, index));
+
+	Entry entry;
+	entry.hot = m_hot[index];
+	entry.cold.reset(new SceneObjectCold(*m_cold[index]));
+
+	const int objectID = entry.hot.ID;
+	if (const LightComponent* light = m_lights.Get(objectID))			{ entry.hasLight = true;	entry.light = *light; }
+	if (const AudioComponent* audio = m_audio.Get(objectID))			{ entry.hasAudio = true;	entry.audio = *audio; }
+	if (const PathNodeComponent* pathNode = m_pathNodes.Get(objectID))	{ entry.hasPathNode = true;	entry.pathNode = *pathNode; }
+	entry.hasAINode = m_aiNodes.Has(objectID);
+	return entry;
+}//End Duplicate
+
+int SceneGraph::Find(const int objectID) const
+{
+	//Only the hot array is scanned, so this stays cheap even though it is linear
+	for (int i = 0; i < GetSize(); i++)
+	{
+		if (m_hot[i].ID == objectID) return i;
+	}//End for
+
+	return -1;
+}//End Find
+
+SceneObjectCold& SceneGraph::GetCold(const int index)
+{
+	if (!m_cold[index]) LoadCold();
+	return *m_cold[index];
+}//End GetCold
+
+SceneObject SceneGraph::Assemble(const int index)
+{
+	if (!m_cold[index]) LoadCold(std::vector<int>(1, index));
+
+	const int objectID = m_hot[index].ID;
+	return JoinRecords(m_hot[index], *m_cold[index], m_lights.Get(objectID), m_audio.Get(objectID), m_aiNodes.Has(objectID), m_pathNodes.Get(objectID));
+}//End Assemble
+
+void SceneGraph::LoadCold()
+{
+	std::unordered_map<int, int> missing;
+	for (int i = 0; i < GetSize(); i++)
+	{
+		if (!m_cold[i]) missing.emplace(m_hot[i].ID, i);
+	}//End for
+
+	//No IDs has the source stream the whole scene, which beats a lookup per object once most are missing
+	FetchCold(missing, std::vector<int>());
+}//End LoadCold
+
+void SceneGraph::LoadCold(const std::vector<int>& indices)
+{
+	std::unordered_map<int, int> missing;
+	std::vector<int> objectIDs;
+	for (const int index : indices)
+	{
+		if (!m_cold[index] && missing.emplace(m_hot[index].ID, index).second) objectIDs.push_back(m_hot[index].ID);
+	}//End for
+
+	FetchCold(missing, objectIDs);
+}//End LoadCold
+
+void SceneGraph::FetchCold(std::unordered_map<int, int>& missing, const std::vector<int>& objectIDs)
+{
+	if (missing.empty()) return;
+
+	//Objects the source doesn't have, such as ones created since loading, get the defaults a new object would
+	const SceneObject defaults;
+	if (m_coldSource)
+	{
+		m_coldSource(objectIDs, [this, &missing](const SceneObject& object)
+		{
+			const auto entry = missing.find(object.ID);
+			if (entry == missing.end()) return true;
+
+			m_cold[entry->second] = std::move(Split(object, true).cold);
+			missing.erase(entry);
+			return !missing.empty();
+		});
+	}//End if
+
+	for (const auto& entry : missing)
+	{
+		m_cold[entry.second] = std::move(Split(defaults, true).cold);
+	}//End for
+}//End FetchCold
+
+SceneGraph::MemoryUsage SceneGraph::GetMemoryUsage() const
+{
+	MemoryUsage usage = {};
+	usage.hotBytes = m_hot.capacity() * sizeof(SceneObjectHot);
+	usage.coldBytes = m_cold.capacity() * sizeof(std::unique_ptr<SceneObjectCold>);
+
+	for (const std::unique_ptr<SceneObjectCold>& cold : m_cold)
+	{
+		if (!cold) continue;
+		usage.coldBytes += sizeof(SceneObjectCold) + GetStringHeapBytes(cold->name);
+		usage.coldLoaded++;
+	}//End for
+
+	usage.componentBytes = m_lights.GetMemoryUsage() + m_audio.GetMemoryUsage() + m_aiNodes.GetMemoryUsage() + m_pathNodes.GetMemoryUsage();
+	return usage;
+}//End GetMemoryUsage
+
+SceneGraph::Entry SceneGraph::Split(const SceneObject& object, const bool withCold)
+{
+	Entry entry;
+	SceneObjectHot& hot = entry.hot;
+	hot.ID =				object.ID;
+	hot.chunk_ID =			object.chunk_ID;
+	hot.parent_id =			object.parent_id;
+	hot.flags =				0;
+	hot.posX = object.posX;	hot.posY = object.posY;	hot.posZ = object.posZ;
+	hot.rotX = object.rotX;	hot.rotY = object.rotY;	hot.rotZ = object.rotZ;
+	hot.scaX = object.scaX;	hot.scaY = object.scaY;	hot.scaZ = object.scaZ;
+	for (const FlagField& flagField : FLAG_FIELDS) hot.SetFlag(flagField.flag, object.*flagField.field);
+
+	AssetPathTable& assetPaths = AssetPathTable::GetInstance();
+	hot.model_path =		assetPaths.Intern(object.model_path);
+	hot.tex_diffuse_path =	assetPaths.Intern(object.tex_diffuse_path);
+
+	//Components are only made for fields that differ from a new object's, so the typical prop gets none
+	static const SceneObject defaults;
+	entry.hasLight = HasLight(object, defaults);
+	if (entry.hasLight) entry.light = ReadLight(object);
+	entry.hasAudio = HasAudio(object, defaults);
+	if (entry.hasAudio) entry.audio = ReadAudio(object);
+	entry.hasAINode = object.AINode;
+	entry.hasPathNode = object.path_node || object.path_node_start || object.path_node_end;
+	if (entry.hasPathNode) entry.pathNode = { object.path_node, object.path_node_start, object.path_node_end };
+
+	if (!withCold) return entry;
+
+	entry.cold.reset(new SceneObjectCold());
+	SceneObjectCold& cold = *entry.cold;
+	cold.name =					object.name;
+	cold.collision_mesh =		assetPaths.Intern(object.collision_mesh);
+	cold.health_amount =		object.health_amount;
+	cold.pivotX = object.pivotX;	cold.pivotY = object.pivotY;	cold.pivotZ = object.pivotZ;
+	return entry;
+}//End Split
+
+SceneObject SceneGraph::Join(const Entry& entry)
+{
+	//Missing cold records come back with a new object's defaults
+	static const SceneObjectCold defaults = *Split(SceneObject(), true).cold;
+	return JoinRecords(entry.hot, entry.cold ? *entry.cold : defaults, entry.hasLight ? &entry.light : nullptr, entry.hasAudio ? &entry.audio : nullptr,
+		entry.hasAINode, entry.hasPathNode ? &entry.pathNode : nullptr);
+}//End Join
+
+void SceneGraph::AddComponents(const Entry& entry)
+{
+	const int objectID = entry.hot.ID;
+	if (entry.hasLight)		m_lights.Add(objectID, entry.light);
+	if (entry.hasAudio)		m_audio.Add(objectID, entry.audio);
+	if (entry.hasAINode)	m_aiNodes.Add(objectID, AINodeComponent());
+	if (entry.hasPathNode)	m_pathNodes.Add(objectID, entry.pathNode);
+}//End AddComponents
+
+SceneGraph::Entry SceneGraph::Duplicate(const Entry& entry)
+{
+	Entry copy;
+	copy.hot =			entry.hot;
+	copy.cold.reset(entry.cold ? new SceneObjectCold(*entry.cold) : nullptr);
+	copy.hasLight =		entry.hasLight;		copy.light =	entry.light;
+	copy.hasAudio =		entry.hasAudio;		copy.audio =	entry.audio;
+	copy.hasAINode =	entry.hasAINode;
+	copy.hasPathNode =	entry.hasPathNode;	copy.pathNode =	entry.pathNode;
+	return copy;
+}//End Duplicate
+
+size_t SceneGraph::GetStringHeapBytes(const std::string& value)
+{
+	//Short strings live inside the object itself - anything over that capacity is a separate allocation, plus its terminator
+	static const size_t inlineCapacity = std::string().capacity();
+	return value.capacity() > inlineCapacity ? value.capacity() + 1 : 0;
+}//End GetStringHeapBytes
@@ -0,0 +1,171 @@
+#pragma once
+#include "SceneObject.h"
+#include "AssetPathTable.h"
+#include "ComponentPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Bit positions of SceneObject's boolean columns, packed into SceneObjectHot::flags
+enum SceneObjectFlag : uint32_t
+{
+	RENDER, COLLISION, COLLECTABLE, DESTRUCTABLE,
+	EDITOR_RENDER, EDITOR_TEXTURE_VIS, EDITOR_NORMALS_VIS, EDITOR_COLLISION_VIS, EDITOR_PIVOT_VIS,
+	SNAP_TO_GROUND, CAMERA, EDITOR_WIREFRAME
+};
+
+//What loading, building the display list and every edit touch - small and trivially copyable, stored contiguously
+struct SceneObjectHot
+{
+	int			ID;
+	int			chunk_ID;
+	int			parent_id;
+	uint32_t	flags;				//SceneObjectFlag bits
+	float		posX, posY, posZ;
+	float		rotX, rotY, rotZ;
+	float		scaX, scaY, scaZ;
+	AssetID		model_path;
+	AssetID		tex_diffuse_path;
+
+	bool GetFlag(const SceneObjectFlag flag) const { return (flags >> flag & 1u) != 0; }
+	void SetFlag(const SceneObjectFlag flag, const bool value) { if (value) flags |= 1u << flag; else flags &= ~(1u << flag); }
+};
+
+//The rest of the row - only saving, the select dialogue and tools read it, so it stays in the database until they ask
+struct SceneObjectCold
+{
+	std::string	name;
+	AssetID		collision_mesh;
+	int			health_amount;
+	float		pivotX, pivotY, pivotZ;
+};
+
+//Data only some objects use, kept in SceneGraph's component pools rather than on every object
+//An object has a component when any of its fields differ from a new object's, so splitting a row and joining it again loses nothing
+struct LightComponent
+{
+	int			light_type;
+	float		light_diffuse_r, light_diffuse_g, light_diffuse_b;
+	float		light_specular_r, light_specular_g, light_specular_b;
+	float		light_spot_cutoff;
+	float		light_constant;
+	float		light_linear;
+	float		light_quadratic;
+};
+
+struct AudioComponent
+{
+	AssetID		audio_path;
+	float		volume, pitch, pan;
+	int			min_dist, max_dist;
+	bool		one_shot;
+	bool		play_on_init;
+	bool		play_in_editor;
+};
+
+struct AINodeComponent {};							//Being in the pool is the whole of it
+
+struct PathNodeComponent
+{
+	bool		path_node;
+	bool		path_node_start;
+	bool		path_node_end;
+};
+
+//The editor's in-memory copy of a chunk's objects, split by how often each field is touched
+//Hot records sit in one packed array and cold records in a side table indexed the same way
+//Asset paths are held as AssetPathTable IDs, so the records carry no path strings of their own
+//Light, audio, AI and path data live in component pools keyed by object ID - the one key that survives reordering and is shared
+//with the display list - so a plain prop carries none of it and systems iterate only the objects that have it
+//Components are loaded with the hot records; cold records are fetched lazily - objects loaded without them get theirs from the cold source the first time any is read
+class SceneGraph
+{
+public:
+	//Streams the rows with the given IDs to the visitor, or every row of the scene when the list is empty, as SceneDatabase's
+	//ForEachObjectWithID and ForEachObject do - only the cold fields are taken from them
+	using ColdSource = std::function<bool(const std::vector<int>&, const std::function<bool(const SceneObject&)>&)>;
+
+	//One object's records, for moving objects between positions and graphs
+	struct Entry
+	{
+		SceneObjectHot						hot;
+		std::unique_ptr<SceneObjectCold>	cold;			//Null until fetched from the cold source
+		bool								hasLight = false;
+		bool								hasAudio = false;
+		bool								hasAINode = false;
+		bool								hasPathNode = false;
+		LightComponent						light = {};
+		AudioComponent						audio = {};
+		PathNodeComponent					pathNode = {};
+	};
+
+	struct MemoryUsage
+	{
+		size_t	hotBytes;
+		size_t	coldBytes;									//Records plus string heap, for those loaded
+		size_t	coldLoaded;									//Objects with their cold record in memory
+		size_t	componentBytes;								//Every component pool
+
+		size_t	GetTotal() const { return hotBytes + coldBytes + componentBytes; }
+	};
+
+	void	Clear();										//Also forgets the cold source
+	void	Reserve(int numObjects);
+	void	Swap(SceneGraph& other);
+	int		GetSize() const { return static_cast<int>(m_hot.size()); }
+	bool	IsEmpty() const { return m_hot.empty(); }
+
+	void	SetColdSource(ColdSource source) { m_coldSource = std::move(source); }
+	const ColdSource& GetColdSource() const { return m_coldSource; }
+
+	int		Add(const SceneObject& object);					//Append with every field
+	int		AddHot(const SceneObject& object);				//Append the hot fields only - cold comes from the cold source
+	int		Append(Entry entry);
+	void	Insert(int index, Entry entry);
+	Entry	Extract(int index);								//Remove the object, handing back its records and components
+	Entry	MoveOut(int index);								//Take the object's records and components, leaving an empty entry in its place
+	Entry	Duplicate(int index);							//Copy of the object's records and components, fetching its cold record first
+	int		Find(int objectID) const;						//Index of the object with the ID, -1 if there isn't one - linear
+
+	SceneObjectHot&				GetHot(const int index)			{ return m_hot[index]; }
+	const SceneObjectHot&		GetHot(const int index) const	{ return m_hot[index]; }
+	SceneObjectCold&			GetCold(int index);			//Fetches every missing cold record on first use
+	bool						IsColdLoaded(const int index) const { return m_cold[index] != nullptr; }
+
+	ComponentPool<LightComponent>&			GetLights()				{ return m_lights; }
+	const ComponentPool<LightComponent>&	GetLights() const		{ return m_lights; }
+	ComponentPool<AudioComponent>&			GetAudio()				{ return m_audio; }
+	const ComponentPool<AudioComponent>&	GetAudio() const		{ return m_audio; }
+	ComponentPool<AINodeComponent>&			GetAINodes()			{ return m_aiNodes; }
+	const ComponentPool<AINodeComponent>&	GetAINodes() const		{ return m_aiNodes; }
+	ComponentPool<PathNodeComponent>&		GetPathNodes()			{ return m_pathNodes; }
+	const ComponentPool<PathNodeComponent>&	GetPathNodes() const	{ return m_pathNodes; }
+
+	SceneObject	Assemble(int index);						//The full row with its components, e.g. for saving - fetches its cold record alone
+	void		LoadCold();									//Fetch every missing cold record now, in one pass over the source
+	void		LoadCold(const std::vector<int>& indices);	//Fetch the missing cold records of these objects only, one lookup each
+
+	MemoryUsage	GetMemoryUsage() const;							//The shared AssetPathTable is not counted
+
+	static Entry			Split(const SceneObject& object, bool withCold);
+	static SceneObject		Join(const Entry& entry);
+	static Entry			Duplicate(const Entry& entry);
+	static size_t			GetStringHeapBytes(const std::string& value);	//What a string holds beyond its own footprint
+
+private:
+	void	AddComponents(const Entry& entry);
+	void	FetchCold(std::unordered_map<int, int>& missing, const std::vector<int>& objectIDs);	//missing maps ID to index
+
+	std::vector<SceneObjectHot>						m_hot;
+	std::vector<std::unique_ptr<SceneObjectCold>>	m_cold;
+	ColdSource										m_coldSource;
+
+	ComponentPool<LightComponent>					m_lights;
+	ComponentPool<AudioComponent>					m_audio;
+	ComponentPool<AINodeComponent>					m_aiNodes;
+	ComponentPool<PathNodeComponent>				m_pathNodes;
+};
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "../SQLITE/sqlite3.h"
+#include "SceneObject.h"
+#include "ChunkObject.h"
+#include <string>
+#include <vector>
+
+//Compile-time description of how SceneObject and ChunkObject map onto their database tables
+//Binding, extraction and the generated SQL all come from these tables, so adding a column is a one-line change
+namespace SceneSchema
+{
+	//How a field is stored in memory - each maps to the matching native sqlite3_bind/sqlite3_column call
+	enum class FieldType { INTEGER, REAL, BOOLEAN, TEXT };
+
+	//Columns SceneGraph leaves in the database at load, fetched on demand into its cold records - see SceneGraph
+	constexpr bool COLD = true;
+
+	template <typename Record>
+	struct Column
+	{
+		const char*				name;					//Column name in the database
+		FieldType				type;
+		int Record::*			intField;				//Exactly one of these is set, matching type
+		float Record::*			floatField;
+		bool Record::*			boolField;
+		std::string Record::*	textField;
+		bool					cold;
+
+		constexpr Column(const char* columnName, int Record::* field, const bool isCold = false) :
+		name(columnName), type(FieldType::INTEGER), intField(field), floatField(nullptr), boolField(nullptr), textField(nullptr), cold(isCold) {}
+		constexpr Column(const char* columnName, float Record::* field, const bool isCold = false) :
+		name(columnName), type(FieldType::REAL), intField(nullptr), floatField(field), boolField(nullptr), textField(nullptr), cold(isCold) {}
+		constexpr Column(const char* columnName, bool Record::* field, const bool isCold = false) :
+		name(columnName), type(FieldType::BOOLEAN), intField(nullptr), floatField(nullptr), boolField(field), textField(nullptr), cold(isCold) {}
+		constexpr Column(const char* columnName, std::string Record::* field, const bool isCold = false) :
+		name(columnName), type(FieldType::TEXT), intField(nullptr), floatField(nullptr), boolField(nullptr), textField(field), cold(isCold) {}
+	};
+
+	template <typename Record>
+	struct Table
+	{
+		const char*				name;
+		const Column<Record>*	columns;				//The first column is the row's key
+		int						numColumns;
+	};
+
+	//Objects table, in table order
+	constexpr Column<SceneObject> OBJECT_COLUMNS[] =
+	{
+		{ "ID",						&SceneObject::ID },
+		{ "chunk_ID",				&SceneObject::chunk_ID },
+		{ "mesh",					&SceneObject::model_path },
+		{ "tex_diffuse",			&SceneObject::tex_diffuse_path },
+		{ "position_x",				&SceneObject::posX },
+		{ "position_y",				&SceneObject::posY },
+		{ "position_z",				&SceneObject::posZ },
+		{ "rotation_x",				&SceneObject::rotX },
+		{ "rotation_y",				&SceneObject::rotY },
+		{ "rotation_z",				&SceneObject::rotZ },
+		{ "scale_x",				&SceneObject::scaX },
+		{ "scale_y",				&SceneObject::scaY },
+		{ "scale_z",				&SceneObject::scaZ },
+		{ "render",					&SceneObject::render },
+		{ "collision",				&SceneObject::collision },
+		{ "collision_mesh",			&SceneObject::collision_mesh, COLD },
+		{ "collectable",			&SceneObject::collectable },
+		{ "destructable",			&SceneObject::destructable },
+		{ "health_amount",			&SceneObject::health_amount, COLD },
+		{ "editor_render",			&SceneObject::editor_render },
+		{ "editor_texture_vis",		&SceneObject::editor_texture_vis },
+		{ "editor_normals_vis",		&SceneObject::editor_normals_vis },
+		{ "editor_collision_vis",	&SceneObject::editor_collision_vis },
+		{ "editor_pivot_vis",		&SceneObject::editor_pivot_vis },
+		{ "pivot_x",				&SceneObject::pivotX, COLD },
+		{ "pivot_y",				&SceneObject::pivotY, COLD },
+		{ "pivot_z",				&SceneObject::pivotZ, COLD },
+		{ "snap_to_ground",			&SceneObject::snapToGround },
+		{ "AI_node",				&SceneObject::AINode },
+		{ "audio_file",				&SceneObject::audio_path },
+		{ "volume",					&SceneObject::volume },
+		{ "pitch",					&SceneObject::pitch },
+		{ "pan",					&SceneObject::pan },
+		{ "one_shot",				&SceneObject::one_shot },
+		{ "play_on_init",			&SceneObject::play_on_init },
+		{ "play_in_editor",			&SceneObject::play_in_editor },
+		{ "min_dist",				&SceneObject::min_dist },
+		{ "max_dist",				&SceneObject::max_dist },
+		{ "camera",					&SceneObject::camera },
+		{ "path_node",				&SceneObject::path_node },
+		{ "path_node_start",		&SceneObject::path_node_start },
+		{ "path_node_end",			&SceneObject::path_node_end },
+		{ "parent_ID",				&SceneObject::parent_id },
+		{ "editor_wireframe",		&SceneObject::editor_wireframe },
+		{ "name",					&SceneObject::name, COLD },
+		{ "light_type",				&SceneObject::light_type },
+		{ "light_diffuse_r",		&SceneObject::light_diffuse_r },
+		{ "light_diffuse_g",		&SceneObject::light_diffuse_g },
+		{ "light_diffuse_b",		&SceneObject::light_diffuse_b },
+		{ "light_specular_r",		&SceneObject::light_specular_r },
+		{ "light_specular_g",		&SceneObject::light_specular_g },
+		{ "light_specular_b",		&SceneObject::light_specular_b },
+		{ "light_spot_cutoff",		&SceneObject::light_spot_cutoff },
+		{ "light_constant",			&SceneObject::light_constant },
+		{ "light_linear",			&SceneObject::light_linear },
+		{ "light_quadratic",		&SceneObject::light_quadratic },
+	};
+
+	//Chunks table, in table order - the names are the database's own, typos included
+	constexpr Column<ChunkObject> CHUNK_COLUMNS[] =
+	{
+		{ "ID",						&ChunkObject::ID },
+		{ "name",					&ChunkObject::name },
+		{ "chunk_x_size_metres",	&ChunkObject::chunk_x_size_metres },
+		{ "chunk_z_size_metres",	&ChunkObject::chunk_y_size_metres },
+		{ "chunk_base_resolution",	&ChunkObject::chunk_base_resolution },
+		{ "heightmap",				&ChunkObject::heightmap_path },
+		{ "tex_diffuse",			&ChunkObject::tex_diffuse_path },
+		{ "tex_spat_alpha",			&ChunkObject::tex_splat_alpha_path },
+		{ "tex_splat_1",			&ChunkObject::tex_splat_1_path },
+		{ "tex_splat_2",			&ChunkObject::tex_splat_2_path },
+		{ "tex_splat_3",			&ChunkObject::tex_splat_3_path },
+		{ "tex_splat_4",			&ChunkObject::tex_splat_4_path },
+		{ "render_wireframe",		&ChunkObject::render_wireframe },
+		{ "render_normals",			&ChunkObject::render_normals },
+		{ "diffuse_tiling",			&ChunkObject::tex_diffuse_tiling },
+		{ "tex_splat_1_tiling",		&ChunkObject::tex_splat_1_tiling },
+		{ "tex_splat_2_tiling",		&ChunkObject::tex_splat_2_tiling },
+		{ "tex_splat_3_tiling",		&ChunkObject::tex_splat_3_tiling },
+		{ "tex_splat_4_tiling",		&ChunkObject::tex_splat_4_tiling },
+	};
+
+	constexpr Table<SceneObject> OBJECTS = { "Objects", OBJECT_COLUMNS, sizeof(OBJECT_COLUMNS) / sizeof(OBJECT_COLUMNS[0]) };
+	constexpr Table<ChunkObject> CHUNKS = { "Chunks", CHUNK_COLUMNS, sizeof(CHUNK_COLUMNS) / sizeof(CHUNK_COLUMNS[0]) };
+
+	static_assert(sizeof(OBJECT_COLUMNS) / sizeof(OBJECT_COLUMNS[0]) == 56, "Objects table has 56 columns");
+	static_assert(sizeof(CHUNK_COLUMNS) / sizeof(CHUNK_COLUMNS[0]) == 19, "Chunks table has 19 columns");
+
+	template <typename Record, int N>
+	constexpr int CountColdColumns(const Column<Record> (&columns)[N])
+	{
+		int numCold = 0;
+		for (int i = 0; i < N; i++) numCold += columns[i].cold ? 1 : 0;
+		return numCold;
+	}//End CountColdColumns
+
+	static_assert(CountColdColumns(OBJECT_COLUMNS) == 6, "SceneObjectCold holds the name, collision mesh, health and pivot - six columns");
+
+	//CREATE TABLE <table> (<column> <type>, ...) - for building databases from scratch, e.g. benchmarks and tests
+	template <typename Record>
+	std::string CreateTableSQL(const Table<Record>& table)
+	{
+		static const char* TYPE_NAMES[] = { "INTEGER", "REAL", "BOOLEAN", "STRING" };
+
+		std::string columns;
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			if (i > 0) columns += ", ";
+			columns += std::string(table.columns[i].name) + " " + TYPE_NAMES[static_cast<int>(table.columns[i].type)];
+		}//End for
+
+		return std::string("CREATE TABLE IF NOT EXISTS ") + table.name + " (" + columns + ")";
+	}//End CreateTableSQL
+
+	//Copy one field between records
+	template <typename Record>
+	void CopyField(const Column<Record>& column, const Record& from, Record& to)
+	{
+		switch (column.type)
+		{
+			case FieldType::INTEGER:	to.*column.intField = from.*column.intField;		break;
+			case FieldType::REAL:		to.*column.floatField = from.*column.floatField;	break;
+			case FieldType::BOOLEAN:	to.*column.boolField = from.*column.boolField;		break;
+			case FieldType::TEXT:		to.*column.textField = from.*column.textField;		break;
+		}//End switch
+	}//End CopyField
+
+	//SELECT <columns> FROM <table> - every column, or all but the cold ones. Read leaves the fields of columns not selected untouched
+	template <typename Record>
+	std::string SelectSQL(const Table<Record>& table, const bool withCold = true)
+	{
+		std::string columns;
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			if (table.columns[i].cold && !withCold) continue;
+			if (!columns.empty()) columns += ", ";
+			columns += table.columns[i].name;
+		}//End for
+
+		return "SELECT " + columns + " FROM " + table.name;
+	}//End SelectSQL
+
+	//INSERT INTO <table> (<columns>) VALUES (?1, ?2, ...) - parameter N is column N - 1 of the descriptor
+	template <typename Record>
+	std::string InsertSQL(const Table<Record>& table)
+	{
+		std::string columns, values;
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			if (i > 0) { columns += ", "; values += ", "; }
+			columns += table.columns[i].name;
+			values += "?" + std::to_string(i + 1);
+		}//End for
+
+		return std::string("INSERT INTO ") + table.name + " (" + columns + ") VALUES (" + values + ")";
+	}//End InsertSQL
+
+	//UPDATE <table> SET <column>=?N, ... WHERE <key>=?1 - numbered to match InsertSQL so both share one bind
+	template <typename Record>
+	std::string UpdateSQL(const Table<Record>& table)
+	{
+		std::string assignments;
+		for (int i = 1; i < table.numColumns; i++)
+		{
+			if (i > 1) assignments += ", ";
+			assignments += std::string(table.columns[i].name) + "=?" + std::to_string(i + 1);
+		}//End for
+
+		return std::string("UPDATE ") + table.name + " SET " + assignments + " WHERE " + table.columns[0].name + "=?1";
+	}//End UpdateSQL
+
+	//Bind every field of the record to parameters 1..N of a statement built by InsertSQL or UpdateSQL
+	//Strings are bound SQLITE_STATIC - the record must outlive the step that consumes them
+	template <typename Record>
+	bool Bind(sqlite3_stmt* statement, const Table<Record>& table, const Record& record)
+	{
+		int rc = SQLITE_OK;
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			const Column<Record>& column = table.columns[i];
+			switch (column.type)
+			{
+				case FieldType::INTEGER:	rc |= sqlite3_bind_int(statement, i + 1, record.*column.intField);							break;
+				case FieldType::REAL:		rc |= sqlite3_bind_double(statement, i + 1, record.*column.floatField);						break;
+				case FieldType::BOOLEAN:	rc |= sqlite3_bind_int(statement, i + 1, record.*column.boolField ? 1 : 0);					break;
+				case FieldType::TEXT:		rc |= sqlite3_bind_text(statement, i + 1, (record.*column.textField).c_str(), -1, SQLITE_STATIC);	break;
+			}//End switch
+		}//End for
+
+		return rc == SQLITE_OK;
+	}//End Bind
+
+	//Find where each descriptor column sits in a statement's result set, -1 if the query doesn't return it
+	//Done once per prepared statement so per-row extraction never compares names
+	template <typename Record>
+	std::vector<int> ResolveColumns(sqlite3_stmt* statement, const Table<Record>& table)
+	{
+		std::vector<int> resultColumns(table.numColumns, -1);
+
+		const int numResultColumns = sqlite3_column_count(statement);
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			for (int resultColumn = 0; resultColumn < numResultColumns; resultColumn++)
+			{
+				const char* resultName = sqlite3_column_name(statement, resultColumn);
+				if (resultName && sqlite3_strnicmp(resultName, table.columns[i].name, 64) == 0)
+				{
+					resultColumns[i] = resultColumn;
+					break;
+				}//End if
+			}//End for
+		}//End for
+
+		return resultColumns;
+	}//End ResolveColumns
+
+	//Read the current row into the record using columns resolved by ResolveColumns - fields the query lacks are left untouched
+	template <typename Record>
+	void Read(sqlite3_stmt* statement, const Table<Record>& table, const std::vector<int>& resultColumns, Record& record)
+	{
+		for (int i = 0; i < table.numColumns; i++)
+		{
+			const int resultColumn = resultColumns[i];
+			if (resultColumn < 0) continue;
+
+			const Column<Record>& column = table.columns[i];
+			switch (column.type)
+			{
+				case FieldType::INTEGER:	record.*column.intField = sqlite3_column_int(statement, resultColumn);						break;
+				case FieldType::REAL:		record.*column.floatField = static_cast<float>(sqlite3_column_double(statement, resultColumn));	break;
+				case FieldType::BOOLEAN:	record.*column.boolField = sqlite3_column_int(statement, resultColumn) != 0;				break;
+				case FieldType::TEXT:
+				{
+					//Text columns can be NULL, which std::string can't be assigned from
+					const unsigned char* text = sqlite3_column_text(statement, resultColumn);
+					if (text) (record.*column.textField).assign(reinterpret_cast<const char*>(text), sqlite3_column_bytes(statement, resultColumn));
+					else (record.*column.textField).clear();
+					break;
+				}
+			}//End switch
+		}//End for
+	}//End Read
+}
@@ -0,0 +1,448 @@
+#include "SceneSnapshot.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+	const char SNAPSHOT_MAGIC[4] = { 'W', 'F', 'S', 'S' };
+
+	struct SnapshotHeader
+	{
+		char		magic[4];
+		uint32_t	formatVersion;
+		int64_t		databaseRevision;
+		int32_t		chunkID;
+		uint32_t	objectCount;
+		uint32_t	objectRecordSize;
+		uint32_t	stringTableSize;
+		uint32_t	lightCount;
+		uint32_t	audioCount;
+		uint32_t	aiNodeCount;
+		uint32_t	pathNodeCount;
+	};
+
+	//Every string is stored as an offset into the string table
+	struct ChunkRecord
+	{
+		int32_t		ID;
+		int32_t		chunk_x_size_metres, chunk_y_size_metres;
+		int32_t		chunk_base_resolution;
+		uint32_t	flags;
+		int32_t		tex_diffuse_tiling;
+		int32_t		tex_splat_tiling[4];
+		uint32_t	name;
+		uint32_t	heightmap_path;
+		uint32_t	tex_diffuse_path;
+		uint32_t	tex_splat_alpha_path;
+		uint32_t	tex_splat_path[4];
+	};
+
+	//The hot record as SceneGraph holds it, with its asset paths as string offsets - asset IDs don't survive the process
+	struct ObjectRecord
+	{
+		SceneObjectHot	hot;
+		uint32_t		model_path;
+		uint32_t		tex_diffuse_path;
+	};
+
+	//Component records name their owner by object ID
+	struct LightRecord
+	{
+		int32_t			objectID;
+		LightComponent	light;
+	};
+
+	struct AudioRecord
+	{
+		int32_t		objectID;
+		uint32_t	audio_path;
+		float		volume, pitch, pan;
+		int32_t		min_dist, max_dist;
+		uint32_t	flags;
+	};
+
+	struct PathNodeRecord
+	{
+		int32_t		objectID;
+		uint32_t	flags;
+	};
+
+	static_assert(sizeof(SnapshotHeader) == 48, "Snapshot header layout changed - bump FORMAT_VERSION");
+	static_assert(sizeof(ChunkRecord) == 72, "Chunk record layout changed - bump FORMAT_VERSION");
+	static_assert(sizeof(ObjectRecord) == 68, "Object record layout changed - bump FORMAT_VERSION");
+	static_assert(sizeof(LightRecord) == 48, "Light record layout changed - bump FORMAT_VERSION");
+	static_assert(sizeof(AudioRecord) == 32, "Audio record layout changed - bump FORMAT_VERSION");
+	static_assert(sizeof(PathNodeRecord) == 8, "Path node record layout changed - bump FORMAT_VERSION");
+
+	enum ChunkFlag : uint32_t
+	{
+		RENDER_WIREFRAME, RENDER_NORMALS
+	};
+
+	enum AudioFlag : uint32_t
+	{
+		ONE_SHOT, PLAY_ON_INIT, PLAY_IN_EDITOR
+	};
+
+	enum PathNodeFlag : uint32_t
+	{
+		PATH_NODE, PATH_NODE_START, PATH_NODE_END
+	};
+
+	//Walks one component section alongside the objects - records are in object order, so each object only checks the next one
+	template <typename Record>
+	class SectionReader
+	{
+	public:
+		SectionReader(const uint8_t* records, const uint32_t count) : m_records(records), m_count(count), m_next(0) {}
+
+		bool Take(const int objectID, Record& record)
+		{
+			if (m_next >= m_count) return false;
+
+			memcpy(&record, m_records + m_next * sizeof(Record), sizeof(Record));
+			if (record.objectID != objectID) return false;
+
+			m_next++;
+			return true;
+		}//End Take
+
+		bool IsFinished() const { return m_next == m_count; }
+
+	private:
+		const uint8_t*	m_records;
+		uint32_t		m_count;
+		uint32_t		m_next;
+	};
+
+	inline void SetFlag(uint32_t& flags, const uint32_t bit, const bool value)
+	{
+		if (value) flags |= 1u << bit;
+	}//End SetFlag
+
+	inline bool GetFlag(const uint32_t flags, const uint32_t bit)
+	{
+		return (flags >> bit & 1u) != 0;
+	}//End GetFlag
+
+	//Builds the string table, storing each distinct string once - asset paths repeat across most objects
+	class StringTableWriter
+	{
+	public:
+		uint32_t Add(const std::string& value)
+		{
+			const auto existing = m_offsets.find(value);
+			if (existing != m_offsets.end()) return existing->second;
+
+			const uint32_t offset = static_cast<uint32_t>(m_table.size());
+			m_table.insert(m_table.end(), value.c_str(), value.c_str() + value.size() + 1);
+			m_offsets.emplace(value, offset);
+			return offset;
+		}//End Add
+
+		const std::vector<char>& GetTable() const { return m_table; }
+
+	private:
+		std::vector<char>							m_table;
+		std::unordered_map<std::string, uint32_t>	m_offsets;
+	};
+
+	//Resolves string offsets against a mapped string table, rejecting anything out of bounds
+	class StringTableReader
+	{
+	public:
+		StringTableReader(const char* table, const uint32_t size) : m_table(table), m_size(size) {}
+
+		bool Get(const uint32_t offset, std::string& value) const
+		{
+			if (offset >= m_size) return false;
+			value.assign(m_table + offset);
+			return true;
+		}//End Get
+
+	private:
+		const char*	m_table;
+		uint32_t	m_size;
+	};
+}
+
+std::string SceneSnapshot::GetPath(const std::string& databasePath, const int chunkID)
+{
+	return databasePath + ".chunk" + std::to_string(chunkID) + ".snapshot";
+}//End GetPath
+
+bool SceneSnapshot::Read(const std::string& path, const int64_t databaseRevision, const int chunkID, ChunkObject& chunk, SceneGraph& objects)
+{
+	MappedFile file;
+	if (databaseRevision < 0 || !file.Open(path.c_str())) return false;
+
+	const uint8_t* data = file.GetData();
+	const size_t size = file.GetSize();
+	if (size < sizeof(SnapshotHeader) + sizeof(ChunkRecord)) return false;
+
+	SnapshotHeader header;
+	memcpy(&header, data, sizeof(header));
+
+	//Anything that doesn't match exactly means the snapshot is stale or from another build
+	if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+		header.formatVersion != FORMAT_VERSION ||
+		header.objectRecordSize != sizeof(ObjectRecord) ||
+		header.databaseRevision != databaseRevision ||
+		header.chunkID != chunkID)
+	{
+		return false;
+	}//End if
+
+	const size_t recordsOffset = sizeof(SnapshotHeader) + sizeof(ChunkRecord);
+	const size_t lightsOffset = recordsOffset + static_cast<size_t>(header.objectCount) * sizeof(ObjectRecord);
+	const size_t audioOffset = lightsOffset + static_cast<size_t>(header.lightCount) * sizeof(LightRecord);
+	const size_t aiNodesOffset = audioOffset + static_cast<size_t>(header.audioCount) * sizeof(AudioRecord);
+	const size_t pathNodesOffset = aiNodesOffset + static_cast<size_t>(header.aiNodeCount) * sizeof(int32_t);
+	const size_t stringsOffset = pathNodesOffset + static_cast<size_t>(header.pathNodeCount) * sizeof(PathNodeRecord);
+	if (stringsOffset + header.stringTableSize != size || header.stringTableSize == 0 || data[size - 1] != '\0') return false;
+
+	const StringTableReader strings(reinterpret_cast<const char*>(data + stringsOffset), header.stringTableSize);
+	bool valid = true;
+
+	ChunkRecord chunkRecord;
+	memcpy(&chunkRecord, data + sizeof(SnapshotHeader), sizeof(chunkRecord));
+	chunk.ID =						chunkRecord.ID;
+	chunk.chunk_x_size_metres =		chunkRecord.chunk_x_size_metres;
+	chunk.chunk_y_size_metres =		chunkRecord.chunk_y_size_metres;
+	chunk.chunk_base_resolution =	chunkRecord.chunk_base_resolution;
+	chunk.render_wireframe =		GetFlag(chunkRecord.flags, RENDER_WIREFRAME);
+	chunk.render_normals =			GetFlag(chunkRecord.flags, RENDER_NORMALS);
+	chunk.tex_diffuse_tiling =		chunkRecord.tex_diffuse_tiling;
+	chunk.tex_splat_1_tiling =		chunkRecord.tex_splat_tiling[0];
+	chunk.tex_splat_2_tiling =		chunkRecord.tex_splat_tiling[1];
+	chunk.tex_splat_3_tiling =		chunkRecord.tex_splat_tiling[2];
+	chunk.tex_splat_4_tiling =		chunkRecord.tex_splat_tiling[3];
+	valid &= strings.Get(chunkRecord.name,						chunk.name);
+	valid &= strings.Get(chunkRecord.heightmap_path,			chunk.heightmap_path);
+	valid &= strings.Get(chunkRecord.tex_diffuse_path,			chunk.tex_diffuse_path);
+	valid &= strings.Get(chunkRecord.tex_splat_alpha_path,		chunk.tex_splat_alpha_path);
+	valid &= strings.Get(chunkRecord.tex_splat_path[0],			chunk.tex_splat_1_path);
+	valid &= strings.Get(chunkRecord.tex_splat_path[1],			chunk.tex_splat_2_path);
+	valid &= strings.Get(chunkRecord.tex_splat_path[2],			chunk.tex_splat_3_path);
+	valid &= strings.Get(chunkRecord.tex_splat_path[3],			chunk.tex_splat_4_path);
+
+	const int firstObject = objects.GetSize();
+	objects.Reserve(firstObject + static_cast<int>(header.objectCount));
+
+	//Objects share a handful of assets, so each distinct string is only interned once
+	AssetPathTable& assetPaths = AssetPathTable::GetInstance();
+	std::unordered_map<uint32_t, AssetID> offsetAssets;
+	auto getAsset = [&](const uint32_t offset, AssetID& asset)
+	{
+		const auto existing = offsetAssets.find(offset);
+		if (existing != offsetAssets.end())
+		{
+			asset = existing->second;
+			return true;
+		}//End if
+
+		std::string path;
+		if (!strings.Get(offset, path)) return false;
+		asset = assetPaths.Intern(path);
+		offsetAssets.emplace(offset, asset);
+		return true;
+	};
+
+	SectionReader<LightRecord> lights(data + lightsOffset, header.lightCount);
+	SectionReader<AudioRecord> audio(data + audioOffset, header.audioCount);
+	SectionReader<PathNodeRecord> pathNodes(data + pathNodesOffset, header.pathNodeCount);
+	uint32_t nextAINode = 0;
+
+	for (uint32_t i = 0; i < header.objectCount && valid; i++)
+	{
+		ObjectRecord record;
+		memcpy(&record, data + recordsOffset + i * sizeof(ObjectRecord), sizeof(record));
+
+		SceneGraph::Entry entry;
+		entry.hot = record.hot;
+		valid &= getAsset(record.model_path,		entry.hot.model_path);
+		valid &= getAsset(record.tex_diffuse_path,	entry.hot.tex_diffuse_path);
+
+		LightRecord lightRecord;
+		entry.hasLight = lights.Take(entry.hot.ID, lightRecord);
+		if (entry.hasLight) entry.light = lightRecord.light;
+
+		AudioRecord audioRecord;
+		entry.hasAudio = audio.Take(entry.hot.ID, audioRecord);
+		if (entry.hasAudio)
+		{
+			valid &= getAsset(audioRecord.audio_path, entry.audio.audio_path);
+			entry.audio.volume =			audioRecord.volume;
+			entry.audio.pitch =				audioRecord.pitch;
+			entry.audio.pan =				audioRecord.pan;
+			entry.audio.min_dist =			audioRecord.min_dist;
+			entry.audio.max_dist =			audioRecord.max_dist;
+			entry.audio.one_shot =			GetFlag(audioRecord.flags, ONE_SHOT);
+			entry.audio.play_on_init =		GetFlag(audioRecord.flags, PLAY_ON_INIT);
+			entry.audio.play_in_editor =	GetFlag(audioRecord.flags, PLAY_IN_EDITOR);
+		}//End if
+
+		if (nextAINode < header.aiNodeCount)
+		{
+			int32_t aiNodeID;
+			memcpy(&aiNodeID, data + aiNodesOffset + nextAINode * sizeof(int32_t), sizeof(aiNodeID));
+			entry.hasAINode = aiNodeID == entry.hot.ID;
+			if (entry.hasAINode) nextAINode++;
+		}//End if
+
+		PathNodeRecord pathNodeRecord;
+		entry.hasPathNode = pathNodes.Take(entry.hot.ID, pathNodeRecord);
+		if (entry.hasPathNode)
+		{
+			entry.pathNode.path_node =			GetFlag(pathNodeRecord.flags, PATH_NODE);
+			entry.pathNode.path_node_start =	GetFlag(pathNodeRecord.flags, PATH_NODE_START);
+			entry.pathNode.path_node_end =		GetFlag(pathNodeRecord.flags, PATH_NODE_END);
+		}//End if
+
+		objects.Append(std::move(entry));
+	}//End for
+
+	//A component left over belongs to no object in the file
+	valid &= lights.IsFinished() && audio.IsFinished() && nextAINode == header.aiNodeCount && pathNodes.IsFinished();
+
+	//Leave the caller's graph as it was rather than half-filled
+	while (!valid && objects.GetSize() > firstObject) objects.Extract(objects.GetSize() - 1);
+
+	return valid;
+}//End Read
+
+bool SceneSnapshot::Write(const std::string& path, const int64_t databaseRevision, const ChunkObject& chunk, const SceneGraph& objects)
+{
+	if (databaseRevision < 0) return false;
+
+	StringTableWriter strings;
+
+	ChunkRecord chunkRecord = {};
+	chunkRecord.ID =					chunk.ID;
+	chunkRecord.chunk_x_size_metres =	chunk.chunk_x_size_metres;
+	chunkRecord.chunk_y_size_metres =	chunk.chunk_y_size_metres;
+	chunkRecord.chunk_base_resolution =	chunk.chunk_base_resolution;
+	SetFlag(chunkRecord.flags, RENDER_WIREFRAME,	chunk.render_wireframe);
+	SetFlag(chunkRecord.flags, RENDER_NORMALS,		chunk.render_normals);
+	chunkRecord.tex_diffuse_tiling =	chunk.tex_diffuse_tiling;
+	chunkRecord.tex_splat_tiling[0] =	chunk.tex_splat_1_tiling;
+	chunkRecord.tex_splat_tiling[1] =	chunk.tex_splat_2_tiling;
+	chunkRecord.tex_splat_tiling[2] =	chunk.tex_splat_3_tiling;
+	chunkRecord.tex_splat_tiling[3] =	chunk.tex_splat_4_tiling;
+	chunkRecord.name =					strings.Add(chunk.name);
+	chunkRecord.heightmap_path =		strings.Add(chunk.heightmap_path);
+	chunkRecord.tex_diffuse_path =		strings.Add(chunk.tex_diffuse_path);
+	chunkRecord.tex_splat_alpha_path =	strings.Add(chunk.tex_splat_alpha_path);
+	chunkRecord.tex_splat_path[0] =		strings.Add(chunk.tex_splat_1_path);
+	chunkRecord.tex_splat_path[1] =		strings.Add(chunk.tex_splat_2_path);
+	chunkRecord.tex_splat_path[2] =		strings.Add(chunk.tex_splat_3_path);
+	chunkRecord.tex_splat_path[3] =		strings.Add(chunk.tex_splat_4_path);
+
+	const AssetPathTable& assetPaths = AssetPathTable::GetInstance();
+	std::unordered_map<AssetID, uint32_t> assetOffsets;
+	auto addAsset = [&](const AssetID asset)
+	{
+		const auto existing = assetOffsets.find(asset);
+		if (existing != assetOffsets.end()) return existing->second;
+
+		const uint32_t offset = strings.Add(assetPaths.GetPath(asset));
+		assetOffsets.emplace(asset, offset);
+		return offset;
+	};
+
+	std::vector<ObjectRecord> records(objects.GetSize());
+	std::vector<LightRecord> lightRecords;
+	std::vector<AudioRecord> audioRecords;
+	std::vector<int32_t> aiNodeRecords;
+	std::vector<PathNodeRecord> pathNodeRecords;
+	for (int i = 0; i < objects.GetSize(); i++)
+	{
+		ObjectRecord& record = records[i];
+		memset(&record, 0, sizeof(record));
+
+		record.hot =				objects.GetHot(i);
+		record.model_path =			addAsset(record.hot.model_path);
+		record.tex_diffuse_path =	addAsset(record.hot.tex_diffuse_path);
+
+		//Sections are written in object order, which is what lets Read match them up in one pass
+		const int objectID = record.hot.ID;
+		if (const LightComponent* light = objects.GetLights().Get(objectID))
+		{
+			LightRecord lightRecord;
+			memset(&lightRecord, 0, sizeof(lightRecord));
+			lightRecord.objectID =	objectID;
+			lightRecord.light =		*light;
+			lightRecords.push_back(lightRecord);
+		}//End if
+
+		if (const AudioComponent* audio = objects.GetAudio().Get(objectID))
+		{
+			AudioRecord audioRecord = {};
+			audioRecord.objectID =		objectID;
+			audioRecord.audio_path =	addAsset(audio->audio_path);
+			audioRecord.volume =		audio->volume;
+			audioRecord.pitch =			audio->pitch;
+			audioRecord.pan =			audio->pan;
+			audioRecord.min_dist =		audio->min_dist;
+			audioRecord.max_dist =		audio->max_dist;
+			SetFlag(audioRecord.flags, ONE_SHOT,		audio->one_shot);
+			SetFlag(audioRecord.flags, PLAY_ON_INIT,	audio->play_on_init);
+			SetFlag(audioRecord.flags, PLAY_IN_EDITOR,	audio->play_in_editor);
+			audioRecords.push_back(audioRecord);
+		}//End if
+
+		if (objects.GetAINodes().Has(objectID)) aiNodeRecords.push_back(objectID);
+
+		if (const PathNodeComponent* pathNode = objects.GetPathNodes().Get(objectID))
+		{
+			PathNodeRecord pathNodeRecord = {};
+			pathNodeRecord.objectID = objectID;
+			SetFlag(pathNodeRecord.flags, PATH_NODE,		pathNode->path_node);
+			SetFlag(pathNodeRecord.flags, PATH_NODE_START,	pathNode->path_node_start);
+			SetFlag(pathNodeRecord.flags, PATH_NODE_END,	pathNode->path_node_end);
+			pathNodeRecords.push_back(pathNodeRecord);
+		}//End if
+	}//End for
+
+	SnapshotHeader header = {};
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.formatVersion =		FORMAT_VERSION;
+	header.databaseRevision =	databaseRevision;
+	header.chunkID =			chunk.ID;
+	header.objectCount =		static_cast<uint32_t>(records.size());
+	header.objectRecordSize =	sizeof(ObjectRecord);
+	header.stringTableSize =	static_cast<uint32_t>(strings.GetTable().size());
+	header.lightCount =			static_cast<uint32_t>(lightRecords.size());
+	header.audioCount =			static_cast<uint32_t>(audioRecords.size());
+	header.aiNodeCount =		static_cast<uint32_t>(aiNodeRecords.size());
+	header.pathNodeCount =		static_cast<uint32_t>(pathNodeRecords.size());
+
+	//Write to a temporary file first so a crash mid-write can never leave a truncated snapshot behind
+	const std::string temporaryPath = path + ".tmp";
+	std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(&chunkRecord), sizeof(chunkRecord));
+	file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(ObjectRecord));
+	file.write(reinterpret_cast<const char*>(lightRecords.data()), lightRecords.size() * sizeof(LightRecord));
+	file.write(reinterpret_cast<const char*>(audioRecords.data()), audioRecords.size() * sizeof(AudioRecord));
+	file.write(reinterpret_cast<const char*>(aiNodeRecords.data()), aiNodeRecords.size() * sizeof(int32_t));
+	file.write(reinterpret_cast<const char*>(pathNodeRecords.data()), pathNodeRecords.size() * sizeof(PathNodeRecord));
+	file.write(strings.GetTable().data(), strings.GetTable().size());
+	file.close();
+	const bool written = !file.fail();
+
+	if (!written)
+	{
+		remove(temporaryPath.c_str());
+		return false;
+	}//End if
+
+	//rename won't replace an existing file on Windows
+	remove(path.c_str());
+	return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}//End Write
@@ -0,0 +1,22 @@
+#pragma once
+#include "SceneGraph.h"
+#include "ChunkObject.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Binary copy of one chunk and its objects, written next to the database so startup can skip SQLite entirely
+//Layout: header, one chunk record, fixed-size object records, a section per component type, then a table of NUL-terminated strings
+//Component sections list only the objects that have that component, in object order
+//Only the hot records, components and asset paths are kept - cold fields are left to the database, which the snapshot matches by revision
+//A snapshot is only trusted if its database revision matches the database's current one
+namespace SceneSnapshot
+{
+	const uint32_t FORMAT_VERSION = 4;
+
+	std::string	GetPath(const std::string& databasePath, int chunkID);
+
+	//Returns false if the snapshot is missing, corrupt, or was written for a different revision/chunk
+	bool		Read(const std::string& path, int64_t databaseRevision, int chunkID, ChunkObject& chunk, SceneGraph& objects);
+	bool		Write(const std::string& path, int64_t databaseRevision, const ChunkObject& chunk, const SceneGraph& objects);
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Reference to an entry in a SlotMap - the generation tells a handle to the current entry from one to a slot that has since been reused
+struct ObjectHandle
+{
+	uint32_t	index = UINT32_MAX;
+	uint32_t	generation = 0;
+
+	bool IsNull() const { return index == UINT32_MAX; }
+	bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+//Storage with O(1) insert and remove behind generational handles
+//Entries stay in their slot once inserted, so iterating by slot index gives a stable order and nothing is shifted on removal
+//Remove takes an entry out but keeps its slot reserved, so Restore can put it back under the same handle - this is what
+//keeps the selection and other commands' handles valid across undo/redo. Release frees the slot and retires the handle
+//Pointers returned by Get are only good until the next Insert
+template <typename T>
+class SlotMap
+{
+public:
+	SlotMap() : m_numLive(0) {}
+
+	ObjectHandle Insert(T&& value)
+	{
+		uint32_t index;
+		if (!m_freeSlots.empty())
+		{
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}//End if
+		else
+		{
+			index = static_cast<uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}//End else
+
+		Slot& slot = m_slots[index];
+		slot.value = std::move(value);
+		slot.state = SlotState::LIVE;
+		m_numLive++;
+		return { index, slot.generation };
+	}//End Insert
+
+	//Take a live entry out, leaving its slot reserved for Restore
+	bool Remove(const ObjectHandle handle, T& removed)
+	{
+		Slot* slot = Find(handle, SlotState::LIVE);
+		if (!slot) return false;
+
+		removed = std::move(slot->value);
+		slot->value = T();
+		slot->state = SlotState::RESERVED;
+		m_numLive--;
+		return true;
+	}//End Remove
+
+	//Put a removed entry back under its old handle - fails if the slot has been released since
+	bool Restore(const ObjectHandle handle, T&& value)
+	{
+		Slot* slot = Find(handle, SlotState::RESERVED);
+		if (!slot) return false;
+
+		slot->value = std::move(value);
+		slot->state = SlotState::LIVE;
+		m_numLive++;
+		return true;
+	}//End Restore
+
+	//Give up a removed entry's slot for reuse - every handle to it goes stale. Does nothing to live entries or released slots,
+	//returning false, so whatever else the entry held is only freed by whoever frees the slot
+	bool Release(const ObjectHandle handle)
+	{
+		Slot* slot = Find(handle, SlotState::RESERVED);
+		if (!slot) return false;
+
+		slot->state = SlotState::FREE;
+		slot->generation++;
+		m_freeSlots.push_back(handle.index);
+		return true;
+	}//End Release
+
+	//Empty the map - slots are kept, with their generations moved on, so handles from before stay detectably stale
+	void Clear()
+	{
+		m_freeSlots.clear();
+		for (uint32_t index = static_cast<uint32_t>(m_slots.size()); index-- > 0;)
+		{
+			Slot& slot = m_slots[index];
+			if (slot.state != SlotState::FREE)
+			{
+				slot.value = T();
+				slot.state = SlotState::FREE;
+				slot.generation++;
+			}//End if
+			m_freeSlots.push_back(index);
+		}//End for
+		m_numLive = 0;
+	}//End Clear
+
+	//nullptr for null, stale, or removed handles
+	T* Get(const ObjectHandle handle)
+	{
+		Slot* slot = Find(handle, SlotState::LIVE);
+		return slot ? &slot->value : nullptr;
+	}//End Get
+
+	const T* Get(const ObjectHandle handle) const
+	{
+		return const_cast<SlotMap*>(this)->Get(handle);
+	}//End Get
+
+	uint32_t	GetSize() const		{ return m_numLive; }
+	uint32_t	GetNumSlots() const	{ return static_cast<uint32_t>(m_slots.size()); }
+
+	//Iteration by slot index - slots without a live entry give nullptr
+	T*			GetAt(const uint32_t index)			{ return m_slots[index].state == SlotState::LIVE ? &m_slots[index].value : nullptr; }
+	const T*	GetAt(const uint32_t index) const	{ return m_slots[index].state == SlotState::LIVE ? &m_slots[index].value : nullptr; }
+	ObjectHandle GetHandleAt(const uint32_t index) const { return { index, m_slots[index].generation }; }
+
+	//Slots and the free list - not anything the entries point to
+	size_t		GetMemoryUsage() const	{ return m_slots.capacity() * sizeof(Slot) + m_freeSlots.capacity() * sizeof(uint32_t); }
+
+private:
+	enum class SlotState : uint8_t { FREE, LIVE, RESERVED };
+
+	struct Slot
+	{
+		T			value;
+		uint32_t	generation = 0;
+		SlotState	state = SlotState::FREE;
+	};
+
+	Slot* Find(const ObjectHandle handle, const SlotState state)
+	{
+		if (handle.index >= m_slots.size()) return nullptr;
+
+		Slot& slot = m_slots[handle.index];
+		return slot.generation == handle.generation && slot.state == state ? &slot : nullptr;
+	}//End Find
+
+	std::vector<Slot>		m_slots;
+	std::vector<uint32_t>	m_freeSlots;				//Reused last-in first-out
+	uint32_t				m_numLive;
+};
@@ -1,15 +1,30 @@
 #include "ToolMain.h"
 #include "../Resources/resource.h"
+#include "SceneSnapshot.h"
+#include "EditJournal.h"
 #include <vector>
-#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <ctime>
+
+//Level database, relative to the working directory
+static const char* DATABASE_PATH = "database/test.db";
+
+//Default time between background saves, in seconds
+static const double DEFAULT_AUTOSAVE_INTERVAL = 60.0;
 
 //ToolMain Class
 ToolMain::ToolMain()
 {
 	m_currentChunk = 0;				//Default chunk value
-	m_selectedObject = 0;			//Initial selection ID
-	m_sceneGraph.clear();			//Clear the vector for the scenegraph
-	m_databaseConnection = nullptr;
+	m_dialogueSelectionID = -1;		//Nothing selected initially
+	m_saveRequested = false;
+	m_autosaveInterval = DEFAULT_AUTOSAVE_INTERVAL;
+	m_lastSaveTime = std::chrono::steady_clock::now();
+	m_saveStatusText = L"No changes";
+	m_sceneGraph.Clear();			//Clear the scenegraph
+	m_sceneGraphMemory = MemoryTracker::GetInstance().Register(MemoryCategory::SCENE_RECORDS, "scene graph", [this]() { return m_sceneGraph.GetMemoryUsage().GetTotal(); });
 
 	m_executeOnce = false;
 
@@ -30,21 +45,67 @@ ToolMain::ToolMain()
 	m_toolInputCommands.increaseMoveSpeed		= false;
 	m_toolInputCommands.save					= false;
 	m_toolInputCommands.wireframeMode			= false;
+	m_toolInputCommands.dumpMemory				= false;
 	m_toolInputCommands.mouseX					= 0.0f;
 	m_toolInputCommands.mouseY					= 0.0f;
 }//End default constructor
 
 ToolMain::~ToolMain()
 {
+	//Let any save in flight finish before the connections go away
+	m_autosave.Stop();
+	PollSave();
+
 	//Close the database connection
-	sqlite3_close(m_databaseConnection);
+	m_database.Close();
 }//End destructor
 
 int ToolMain::getCurrentSelectionID()
 {
-	return m_selectedObject;
+	return m_d3dRenderer.GetObjectID(m_selectedObject);
 }//End getCurrentSelectionID
 
+const std::wstring& ToolMain::getSaveStatusText() const
+{
+	return m_saveStatusText;
+}//End getSaveStatusText
+
+void ToolMain::setAutosaveInterval(const double seconds)
+{
+	m_autosaveInterval = seconds > 0.0 ? seconds : 0.0;
+}//End setAutosaveInterval
+
+double ToolMain::getAutosaveInterval() const
+{
+	return m_autosaveInterval;
+}//End getAutosaveInterval
+
+std::vector<int> ToolMain::getChunkIDs()
+{
+	return m_database.GetChunkIDs();
+}//End getChunkIDs
+
+int ToolMain::getCurrentChunkID() const
+{
+	return m_currentChunk;
+}//End getCurrentChunkID
+
+std::vector<int> ToolMain::getObjectsInBox(const DirectX::SimpleMath::Vector3& min, const DirectX::SimpleMath::Vector3& max)
+{
+	//Answered by the database's spatial index, so edits show up once they have been saved
+	const ObjectBounds box = { min.x, min.y, min.z, max.x, max.y, max.z };
+	std::vector<int> objectIDs;
+	if (!m_database.QueryObjectsInBox(box, objectIDs)) TRACE("Spatial query failed\n");
+	return objectIDs;
+}//End getObjectsInBox
+
+std::vector<int> ToolMain::getObjectsInSphere(const DirectX::SimpleMath::Vector3& centre, const float radius)
+{
+	std::vector<int> objectIDs;
+	if (!m_database.QueryObjectsInSphere(centre.x, centre.y, centre.z, radius, objectIDs)) TRACE("Spatial query failed\n");
+	return objectIDs;
+}//End getObjectsInSphere
+
 void ToolMain::onActionInitialise(HWND handle, int width, int height)
 {
 	//Window size, handle etc. for DirectX
@@ -53,15 +114,26 @@ void ToolMain::onActionInitialise(HWND handle, int width, int height)
 	m_d3dRenderer.Initialize(handle, m_width, m_height);
 
 	//Establish database connection
-	const int rc = sqlite3_open_v2("database/test.db", &m_databaseConnection, SQLITE_OPEN_READWRITE, NULL);
-
-	if (rc) 
+	if (!m_database.Open(DATABASE_PATH, SQLITE_OPEN_READWRITE)) 
 	{
 		TRACE("Can't open database\n");
 	}//End if
 	else 
 	{
 		TRACE("Opened database successfully\n");
+
+		//Older databases are missing the indices chunk-scoped loading relies on
+		if (!m_database.Migrate()) TRACE("Database schema migration failed\n");
+
+		//IDs this session frees stay out of use until the next, while undo could still bring their objects back
+		if (!m_database.BeginIDSession()) TRACE("Object ID allocation unavailable\n");
+		m_idAllocator.SetDatabase(&m_database);
+		m_d3dRenderer.SetObjectIDAllocator(&m_idAllocator);
+		m_d3dRenderer.SetSceneDatabase(&m_database);
+
+		//WAL lets this connection keep reading while the autosave worker commits
+		if (!m_database.EnableWriteAheadLog()) TRACE("Write-ahead logging unavailable\n");
+		if (!m_autosave.Start(DATABASE_PATH)) TRACE("Autosave could not be started\n");
 	}//End else
 
 	onActionLoad();
@@ -70,223 +142,267 @@ void ToolMain::onActionInitialise(HWND handle, int width, int height)
 void ToolMain::onActionLoad()
 {
 	//Load current chunk and objects into lists
-	if (!m_sceneGraph.empty())
+	if (!m_sceneGraph.IsEmpty())
+	{
+		m_sceneGraph.Clear();
+	}//End if
+
+	//A save still being written would otherwise be missed by the read below
+	m_autosave.Flush();
+	PollSave();
+
+	//The journal belongs to the chunk being replaced
+	EditJournal& journal = m_d3dRenderer.GetEditJournal();
+	journal.Close();
+
+	const auto loadStart = std::chrono::steady_clock::now();
+
+	//Try the binary snapshot first - it is only trusted if nothing has been written to the database since it was taken
+	const std::string snapshotPath = SceneSnapshot::GetPath(DATABASE_PATH, m_currentChunk);
+	const int64_t databaseRevision = m_database.GetRevision();
+
+	if (!SceneSnapshot::Read(snapshotPath, databaseRevision, m_currentChunk, m_chunk, m_sceneGraph))
 	{
-		m_sceneGraph.clear();
+		//THE WORLD CHUNK
+		if (!m_database.LoadChunk(m_currentChunk, m_chunk))
+		{
+			TRACE("Chunk %d not found in database\n", m_currentChunk);
+			return;
+		}//End if
+
+		//Only objects belonging to the current chunk are loaded, and none of their cold columns
+		if (!m_database.ForEachObjectWithoutCold(m_currentChunk, [this](const SceneObject& object) { m_sceneGraph.AddHot(object); return true; }))
+		{
+			TRACE("Failed to load objects for chunk %d\n", m_currentChunk);
+		}//End if
+
+		//Cache what was just read so the next startup can skip SQLite
+		SceneSnapshot::Write(snapshotPath, databaseRevision, m_chunk, m_sceneGraph);
 	}//End if
-	
-	sqlite3_stmt *pResults;
-	sqlite3_stmt *pResultsChunk;
-
-	//SQL command which will return all records from the objects table.
-	const char* sqlCommand = "SELECT * from Objects";				
-	//Send command and fill result object
-	int rc = sqlite3_prepare_v2(m_databaseConnection, sqlCommand, -1, &pResults, 0);
-	
-	//Loop for each row in results until there are no more rows
-	//For every row in the results, we create an object
-	while (sqlite3_step(pResults) == SQLITE_ROW)
-	{	
-		SceneObject newSceneObject;
-		newSceneObject.ID =						sqlite3_column_int(pResults,								0);
-		newSceneObject.chunk_ID =				sqlite3_column_int(pResults,								1);
-		newSceneObject.model_path =				reinterpret_cast<const char*>(sqlite3_column_text(pResults, 2));
-		newSceneObject.tex_diffuse_path =		reinterpret_cast<const char*>(sqlite3_column_text(pResults, 3));
-		newSceneObject.posX =					sqlite3_column_double(pResults,								4);
-		newSceneObject.posY =					sqlite3_column_double(pResults,								5);
-		newSceneObject.posZ =					sqlite3_column_double(pResults,								6);
-		newSceneObject.rotX =					sqlite3_column_double(pResults,								7);
-		newSceneObject.rotY =					sqlite3_column_double(pResults,								8);
-		newSceneObject.rotZ =					sqlite3_column_double(pResults,								9);
-		newSceneObject.scaX =					sqlite3_column_double(pResults,								10);
-		newSceneObject.scaY =					sqlite3_column_double(pResults,								11);
-		newSceneObject.scaZ =					sqlite3_column_double(pResults,								12);
-		newSceneObject.render =					sqlite3_column_int(pResults,								13);
-		newSceneObject.collision =				sqlite3_column_int(pResults,								14);
-		newSceneObject.collision_mesh =			reinterpret_cast<const char*>(sqlite3_column_text(pResults, 15));
-		newSceneObject.collectable =			sqlite3_column_int(pResults,								16);
-		newSceneObject.destructable =			sqlite3_column_int(pResults,								17);
-		newSceneObject.health_amount =			sqlite3_column_int(pResults,								18);
-		newSceneObject.editor_render =			sqlite3_column_int(pResults,								19);
-		newSceneObject.editor_texture_vis =		sqlite3_column_int(pResults,								20);
-		newSceneObject.editor_normals_vis =		sqlite3_column_int(pResults,								21);
-		newSceneObject.editor_collision_vis =	sqlite3_column_int(pResults,								22);
-		newSceneObject.editor_pivot_vis =		sqlite3_column_int(pResults,								23);
-		newSceneObject.pivotX =					sqlite3_column_double(pResults,								24);
-		newSceneObject.pivotY =					sqlite3_column_double(pResults,								25);
-		newSceneObject.pivotZ =					sqlite3_column_double(pResults,								26);
-		newSceneObject.snapToGround =			sqlite3_column_int(pResults,								27);
-		newSceneObject.AINode =					sqlite3_column_int(pResults,								28);
-		newSceneObject.audio_path =				reinterpret_cast<const char*>(sqlite3_column_text(pResults, 29));
-		newSceneObject.volume =					sqlite3_column_double(pResults,								30);
-		newSceneObject.pitch =					sqlite3_column_double(pResults,								31);
-		newSceneObject.pan =					sqlite3_column_int(pResults,								32);
-		newSceneObject.one_shot =				sqlite3_column_int(pResults,								33);
-		newSceneObject.play_on_init =			sqlite3_column_int(pResults,								34);
-		newSceneObject.play_in_editor =			sqlite3_column_int(pResults,								35);
-		newSceneObject.min_dist =				sqlite3_column_double(pResults,								36);
-		newSceneObject.max_dist =				sqlite3_column_double(pResults,								37);
-		newSceneObject.camera =					sqlite3_column_int(pResults,								38);
-		newSceneObject.path_node =				sqlite3_column_int(pResults,								39);
-		newSceneObject.path_node_start =		sqlite3_column_int(pResults,								40);
-		newSceneObject.path_node_end =			sqlite3_column_int(pResults,								41);
-		newSceneObject.parent_id =				sqlite3_column_int(pResults,								42);
-		newSceneObject.editor_wireframe =		sqlite3_column_int(pResults,								43);
-		newSceneObject.name =					reinterpret_cast<const char*>(sqlite3_column_text(pResults, 44));
-		newSceneObject.light_type =				sqlite3_column_int(pResults,								45);
-		newSceneObject.light_diffuse_r =		sqlite3_column_double(pResults,								46);
-		newSceneObject.light_diffuse_g =		sqlite3_column_double(pResults,								47);
-		newSceneObject.light_diffuse_b =		sqlite3_column_double(pResults,								48);
-		newSceneObject.light_specular_r =		sqlite3_column_double(pResults,								49);
-		newSceneObject.light_specular_g =		sqlite3_column_double(pResults,								50);
-		newSceneObject.light_specular_b =		sqlite3_column_double(pResults,								51);
-		newSceneObject.light_spot_cutoff =		sqlite3_column_double(pResults,								52);
-		newSceneObject.light_constant =			sqlite3_column_double(pResults,								53);
-		newSceneObject.light_linear =			sqlite3_column_double(pResults,								54);
-		newSceneObject.light_quadratic =		sqlite3_column_double(pResults,								55);
-
-		//Send completed object to scenegraph
-		m_sceneGraph.push_back(newSceneObject);
-	}//End while
-
-	//THE WORLD CHUNK
-	//SQL command which will return all records from the chunks table.
-	sqlCommand = "SELECT * from Chunks";
-	rc = sqlite3_prepare_v2(m_databaseConnection, sqlCommand, -1, &pResultsChunk, nullptr);
-	
-	sqlite3_step(pResultsChunk);
-	m_chunk.ID =						sqlite3_column_int(pResultsChunk,									0);
-	m_chunk.name =						reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	1));
-	m_chunk.chunk_x_size_metres =		sqlite3_column_int(pResultsChunk,									2);
-	m_chunk.chunk_y_size_metres =		sqlite3_column_int(pResultsChunk,									3);
-	m_chunk.chunk_base_resolution =		sqlite3_column_int(pResultsChunk,									4);
-	m_chunk.heightmap_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	5));
-	m_chunk.tex_diffuse_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	6));
-	m_chunk.tex_splat_alpha_path =		reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	7));
-	m_chunk.tex_splat_1_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	8));
-	m_chunk.tex_splat_2_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	9));
-	m_chunk.tex_splat_3_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	10));
-	m_chunk.tex_splat_4_path =			reinterpret_cast<const char*>(sqlite3_column_text(pResultsChunk,	11));
-	m_chunk.render_wireframe =			sqlite3_column_int(pResultsChunk,									12);
-	m_chunk.render_normals =			sqlite3_column_int(pResultsChunk,									13);
-	m_chunk.tex_diffuse_tiling =		sqlite3_column_int(pResultsChunk,									14);
-	m_chunk.tex_splat_1_tiling =		sqlite3_column_int(pResultsChunk,									15);
-	m_chunk.tex_splat_2_tiling =		sqlite3_column_int(pResultsChunk,									16);
-	m_chunk.tex_splat_3_tiling =		sqlite3_column_int(pResultsChunk,									17);
-	m_chunk.tex_splat_4_tiling =		sqlite3_column_int(pResultsChunk,									18);
+
+	const std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - loadStart;
+	TRACE("Loaded %d objects in %.3fs\n", m_sceneGraph.GetSize(), loadTime.count());
+
+	//Names and the other cold columns are read from the database the first time anything asks for them
+	//Saves and copies look up just the rows they need - the whole chunk is only read for something like the select dialogue
+	const int chunkID = m_currentChunk;
+	m_sceneGraph.SetColdSource([this, chunkID](const std::vector<int>& objectIDs, const std::function<bool(const SceneObject&)>& visitor)
+	{
+		return objectIDs.empty() ? m_database.ForEachObject(chunkID, visitor) : m_database.ForEachObjectWithID(objectIDs, visitor);
+	});
+
+	//Anything left in the journal was edited after the last save, e.g. before a crash
+	const std::string journalPath = EditJournal::GetPath(DATABASE_PATH, m_currentChunk);
+	const std::unordered_set<int> recoveredObjects = ReplayJournal(journalPath);
 
 	//Process results into renderable
-	m_d3dRenderer.BuildDisplayList(&m_sceneGraph);
+	m_d3dRenderer.BuildDisplayList(m_sceneGraph);
+
+	//Building the display list reset the change tracker, so flag the recovered edits again for the next save
+	if (!recoveredObjects.empty())
+	{
+		std::unordered_set<int> loadedObjects;
+		loadedObjects.reserve(m_sceneGraph.GetSize());
+		for (int i = 0; i < m_sceneGraph.GetSize(); i++) loadedObjects.insert(m_sceneGraph.GetHot(i).ID);
+
+		SceneChangeTracker& changeTracker = m_d3dRenderer.GetChangeTracker();
+		for (const int objectID : recoveredObjects)
+		{
+			if (loadedObjects.count(objectID)) changeTracker.ObjectModified(objectID);
+			else changeTracker.ObjectRemoved(objectID);
+		}//End for
+
+		m_saveStatusText = L"Recovered unsaved edits to " + std::to_wstring(recoveredObjects.size()) + L" objects";
+	}//End if
+
+	if (!journal.Open(journalPath)) TRACE("Can't open edit journal\n");
 	//Build the renderable chunk 
 	m_d3dRenderer.BuildDisplayChunk(&m_chunk);
 }//End onActionLoad
 
+void ToolMain::onActionLoadChunk(const int chunkID)
+{
+	if (chunkID == m_currentChunk) return;
+
+	//Edits to the outgoing chunk are saved on the way out rather than left in its journal until it is next opened
+	m_autosave.Flush();
+	PollSave();
+	SubmitSave();
+
+	//Switching chunk discards the current one's display list, so selection no longer applies
+	m_currentChunk = chunkID;
+	m_selectedObject = ObjectHandle();
+	onActionLoad();
+}//End onActionLoadChunk
+
 void ToolMain::onActionSave()
 {
-	//Update the scene graph with the current data
-	m_sceneGraph.clear();
-	const std::vector<DisplayObject> currentDisplayList = m_d3dRenderer.GetDisplayList();
+	//Menu commands arrive between ticks, so the save is deferred to the end of the next one where the scene is consistent
+	m_saveRequested = true;
+}//End onActionSave
+
+void ToolMain::SubmitSave()
+{
+	//Still writing the previous save - try again on a later tick
+	if (m_autosave.IsBusy()) return;
 
-	//Go through every member of the display list
-	for(int i = 0; i < currentDisplayList.size(); i++)
+	SceneChangeTracker& changeTracker = m_d3dRenderer.GetChangeTracker();
+	if (!changeTracker.HasChanges())
 	{
-		SceneObject newSceneObject;
-        newSceneObject.ID = currentDisplayList.at(i).m_ID;
-        newSceneObject.chunk_ID = currentDisplayList.at(i).m_ID;
-        newSceneObject.model_path = WCHARTToString(currentDisplayList.at(i).m_model_path);
-        newSceneObject.tex_diffuse_path =  WCHARTToString(currentDisplayList.at(i).m_texture_diffuse_path);
-        newSceneObject.posX = currentDisplayList.at(i).m_position.x;
-        newSceneObject.posY = currentDisplayList.at(i).m_position.y;
-        newSceneObject.posZ = currentDisplayList.at(i).m_position.z;
-        newSceneObject.rotX = currentDisplayList.at(i).m_orientation.x;
-        newSceneObject.rotY = currentDisplayList.at(i).m_orientation.y;
-        newSceneObject.rotZ = currentDisplayList.at(i).m_orientation.z;
-        newSceneObject.scaX = currentDisplayList.at(i).m_scale.x;
-        newSceneObject.scaY = currentDisplayList.at(i).m_scale.y;
-        newSceneObject.scaZ = currentDisplayList.at(i).m_scale.z;
-
-        m_sceneGraph.push_back(newSceneObject);
+		if (m_saveRequested) m_saveStatusText = L"No changes to save";
+		m_saveRequested = false;
+		m_lastSaveTime = std::chrono::steady_clock::now();
+		return;
+	}//End if
+
+	//Edits have already been written into the scene graph, so only the flagged rows are assembled - the worker never sees the live scene
+	//Their missing cold records are fetched together first, by ID, rather than reading the whole chunk
+	std::vector<int> modifiedIndices;
+	modifiedIndices.reserve(changeTracker.GetModifiedObjects().size());
+	for (int i = 0; i < m_sceneGraph.GetSize(); i++)
+	{
+		if (changeTracker.IsModified(m_sceneGraph.GetHot(i).ID)) modifiedIndices.push_back(i);
 	}//End for
+	m_sceneGraph.LoadCold(modifiedIndices);
 
-	sqlite3_stmt *pResults;
+	SaveJob job;
+	job.chunkID = m_currentChunk;
+	job.removedObjectIDs = changeTracker.GetRemovedObjects();
+	job.modifiedObjects.reserve(modifiedIndices.size());
+	for (const int index : modifiedIndices) job.modifiedObjects.push_back(m_sceneGraph.Assemble(index));
 
-	//Delete all in-world objects
-	const char* sqlCommand = "DELETE FROM Objects";	
-	int rc = sqlite3_prepare_v2(m_databaseConnection, sqlCommand, -1, &pResults, 0);
-	sqlite3_step(pResults);
+	if (!m_autosave.Submit(std::move(job))) return;
 
-	//Populate with new objects
-	const int numObjects = m_sceneGraph.size();
-	std::string sqlCommand2;
+	//Edits from here on go to a fresh journal - the rotated one is only dropped once this save commits
+	if (!m_d3dRenderer.GetEditJournal().Rotate()) TRACE("Can't rotate edit journal\n");
+
+	//Edits made while the save runs are tracked afresh for the next one
+	changeTracker.Clear();
+	m_saveRequested = false;
+	m_lastSaveTime = std::chrono::steady_clock::now();
+	m_saveStatusText = L"Saving...";
+}//End SubmitSave
+
+void ToolMain::PollSave()
+{
+	AutosaveService::Status status;
+	int rowsWritten;
+	SaveJob failedJob;
+	if (!m_autosave.PollCompletion(status, rowsWritten, failedJob)) return;
 
-	//Loop through the scene graph
-	for (int i = 0; i < numObjects; i++)
+	if (status == AutosaveService::Status::FAILED)
 	{
-		std::stringstream command;
-		command << "INSERT INTO Objects " 
-			<<"VALUES(" << m_sceneGraph.at(i).ID << ","
-			<< m_sceneGraph.at(i).chunk_ID  << ","
-			<< "'" << m_sceneGraph.at(i).model_path <<"'" << ","
-			<< "'" << m_sceneGraph.at(i).tex_diffuse_path << "'" << ","
-			<< m_sceneGraph.at(i).posX << ","
-			<< m_sceneGraph.at(i).posY << ","
-			<< m_sceneGraph.at(i).posZ << ","
-			<< m_sceneGraph.at(i).rotX << ","
-			<< m_sceneGraph.at(i).rotY << ","
-			<< m_sceneGraph.at(i).rotZ << ","
-			<< m_sceneGraph.at(i).scaX << ","
-			<< m_sceneGraph.at(i).scaY << ","
-			<< m_sceneGraph.at(i).scaZ << ","
-			<< m_sceneGraph.at(i).render << ","
-			<< m_sceneGraph.at(i).collision << ","
-			<< "'" << m_sceneGraph.at(i).collision_mesh << "'" << ","
-			<< m_sceneGraph.at(i).collectable << ","
-			<< m_sceneGraph.at(i).destructable << ","
-			<< m_sceneGraph.at(i).health_amount << ","
-			<< m_sceneGraph.at(i).editor_render << ","
-			<< m_sceneGraph.at(i).editor_texture_vis << ","
-			<< m_sceneGraph.at(i).editor_normals_vis << ","
-			<< m_sceneGraph.at(i).editor_collision_vis << ","
-			<< m_sceneGraph.at(i).editor_pivot_vis << ","
-			<< m_sceneGraph.at(i).pivotX << ","
-			<< m_sceneGraph.at(i).pivotY << ","
-			<< m_sceneGraph.at(i).pivotZ << ","
-			<< m_sceneGraph.at(i).snapToGround << ","
-			<< m_sceneGraph.at(i).AINode << ","
-			<< "'" << m_sceneGraph.at(i).audio_path << "'" << ","
-			<< m_sceneGraph.at(i).volume << ","
-			<< m_sceneGraph.at(i).pitch << ","
-			<< m_sceneGraph.at(i).pan << ","
-			<< m_sceneGraph.at(i).one_shot << ","
-			<< m_sceneGraph.at(i).play_on_init << ","
-			<< m_sceneGraph.at(i).play_in_editor << ","
-			<< m_sceneGraph.at(i).min_dist << ","
-			<< m_sceneGraph.at(i).max_dist << ","
-			<< m_sceneGraph.at(i).camera << ","
-			<< m_sceneGraph.at(i).path_node << ","
-			<< m_sceneGraph.at(i).path_node_start << ","
-			<< m_sceneGraph.at(i).path_node_end << ","
-			<< m_sceneGraph.at(i).parent_id << ","
-			<< m_sceneGraph.at(i).editor_wireframe << ","
-			<< "'" << m_sceneGraph.at(i).name << "'" << ","
-			<< m_sceneGraph.at(i).light_type << ","
-			<< m_sceneGraph.at(i).light_diffuse_r << ","
-			<< m_sceneGraph.at(i).light_diffuse_g << ","
-			<< m_sceneGraph.at(i).light_diffuse_b << ","
-			<< m_sceneGraph.at(i).light_specular_r << ","
-			<< m_sceneGraph.at(i).light_specular_g << ","
-			<< m_sceneGraph.at(i).light_specular_b << ","
-			<< m_sceneGraph.at(i).light_spot_cutoff << ","
-			<< m_sceneGraph.at(i).light_constant << ","
-			<< m_sceneGraph.at(i).light_linear << ","
-			<< m_sceneGraph.at(i).light_quadratic
-			<< ")";
-		sqlCommand2 = command.str();
-		sqlite3_prepare_v2(m_databaseConnection, sqlCommand2.c_str(), -1, &pResults, nullptr);
-		sqlite3_step(pResults);	
-	}
-	MessageBox(nullptr, L"Objects Saved", L"Notification", MB_OK);
-}//End onActionSave
+		//Re-flag the rows that didn't make it, unless they have been edited again since
+		SceneChangeTracker& changeTracker = m_d3dRenderer.GetChangeTracker();
+		for (const SceneObject& sceneObject : failedJob.modifiedObjects)
+		{
+			if (!changeTracker.IsModified(sceneObject.ID) && !changeTracker.IsRemoved(sceneObject.ID)) changeTracker.ObjectModified(sceneObject.ID);
+		}//End for
+		for (const int objectID : failedJob.removedObjectIDs)
+		{
+			if (!changeTracker.IsModified(objectID) && !changeTracker.IsRemoved(objectID)) changeTracker.ObjectRemoved(objectID);
+		}//End for
+
+		TRACE("Save failed - changes rolled back\n");
+		m_saveStatusText = L"Save failed - will retry";
+		return;
+	}//End if
+
+	m_d3dRenderer.GetEditJournal().DiscardPending();
+	TRACE("Saved %d changed rows\n", rowsWritten);
+
+	const std::time_t now = std::time(nullptr);
+	std::tm localTime;
+	localtime_s(&localTime, &now);
+	wchar_t timeText[16];
+	wcsftime(timeText, 16, L"%H:%M:%S", &localTime);
+	m_saveStatusText = L"Saved " + std::to_wstring(rowsWritten) + L" rows at " + timeText;
+}//End PollSave
+
+std::unordered_set<int> ToolMain::ReplayJournal(const std::string& journalPath)
+{
+	std::unordered_set<int> touchedObjects;
+
+	std::vector<JournalEntry> entries;
+	EditJournal::Read(journalPath, entries);
+	if (entries.empty()) return touchedObjects;
+
+	//Records of objects removed during replay, so re-adding one (undoing a delete) keeps its other columns
+	std::unordered_map<int, SceneGraph::Entry> removedObjects;
+
+	//Where each object sits in the scene graph, built once rather than searched for every record
+	//Removing or inserting already shifts everything after it, so only that tail is re-indexed
+	std::unordered_map<int, int> sceneIndices;
+	sceneIndices.reserve(m_sceneGraph.GetSize());
+	const auto indexFrom = [this, &sceneIndices](const int first)
+	{
+		for (int i = first; i < m_sceneGraph.GetSize(); i++) sceneIndices[m_sceneGraph.GetHot(i).ID] = i;
+	};
+	indexFrom(0);
+
+	for (const JournalEntry& entry : entries)
+	{
+		touchedObjects.insert(entry.objectID);
+
+		const auto sceneIndex = sceneIndices.find(entry.objectID);
+		const int sceneObject = sceneIndex != sceneIndices.end() ? sceneIndex->second : -1;
+
+		switch (entry.type)
+		{
+			case JournalEntry::Type::MOVED:
+				if (sceneObject != -1)
+				{
+					SceneObjectHot& hot = m_sceneGraph.GetHot(sceneObject);
+					hot.posX = entry.position[0];
+					hot.posY = entry.position[1];
+					hot.posZ = entry.position[2];
+				}//End if
+				break;
+
+			case JournalEntry::Type::REMOVED:
+				if (sceneObject != -1)
+				{
+					removedObjects[entry.objectID] = m_sceneGraph.Extract(sceneObject);
+					sceneIndices.erase(sceneIndex);
+					indexFrom(sceneObject);
+				}//End if
+				break;
+
+			case JournalEntry::Type::ADDED:
+			{
+				//The record has the whole row, components included - only cold fields it never had loaded are kept from before
+				//Already present means the save this record belongs to made it, so it is re-added in place
+				//Cold fields nobody loaded stay unloaded, so the first read fetches them from the database under the same ID,
+				//falling back to a new object's defaults if it was never saved
+				std::unique_ptr<SceneObjectCold> previousCold;
+				const auto removedObject = removedObjects.find(entry.objectID);
+				if (sceneObject != -1)
+				{
+					previousCold = std::move(m_sceneGraph.Extract(sceneObject).cold);
+					sceneIndices.erase(sceneIndex);
+					indexFrom(sceneObject);
+				}//End if
+				else if (removedObject != removedObjects.end())
+				{
+					previousCold = std::move(removedObject->second.cold);
+					removedObjects.erase(removedObject);
+				}//End else if
+
+				SceneGraph::Entry addedObject = SceneGraph::Split(entry.object, entry.objectHasCold);
+				if (!entry.objectHasCold) addedObject.cold = std::move(previousCold);
+
+				const bool validIndex = entry.index >= 0 && entry.index <= m_sceneGraph.GetSize();
+				const int addedIndex = validIndex ? entry.index : m_sceneGraph.GetSize();
+				m_sceneGraph.Insert(addedIndex, std::move(addedObject));
+				indexFrom(addedIndex);
+				break;
+			}
+		}//End switch
+	}//End for
+
+	TRACE("Replayed %d journaled edits\n", static_cast<int>(entries.size()));
+	return touchedObjects;
+}//End ReplayJournal
 
 void ToolMain::onActionSaveTerrain()
 {
@@ -328,7 +444,13 @@ void ToolMain::onActionWireframe()
 	m_d3dRenderer.ToggleWireframe();
 }//End onActionWireframe
 
-void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindowPreviousSelected)
+void ToolMain::onActionDumpMemory()
+{
+	const std::string path = "database/memory_report.json";
+	m_saveStatusText = MemoryTracker::GetInstance().WriteJSON(path) ? L"Memory report written to " + AssetPathTable::Utf8ToWide(path) : L"Couldn't write the memory report";
+}//End onActionDumpMemory
+
+void ToolMain::Tick(MSG *msg, const bool selectWindowOpen)
 {
 	//Do we have a selection
 	//Do we have a mode
@@ -383,9 +505,6 @@ void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindo
 			m_executeOnce = true;
 			m_toolInputCommands.save = false;
 			onActionSave();
-			//Due to the separate window opening, need to manually disable both keys
-			m_keyArray[VK_CONTROL] = false;
-			m_keyArray['S'] = false;
 		}//End if
 
 		if(m_toolInputCommands.wireframeMode)
@@ -393,6 +512,12 @@ void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindo
 			m_executeOnce = true;
 			m_d3dRenderer.ToggleWireframe();
 		}//End if
+
+		if(m_toolInputCommands.dumpMemory)
+		{
+			m_executeOnce = true;
+			onActionDumpMemory();
+		}//End if
 	}//End if
 
 	//There is definitely a better way to do this, but this works, so it's staying for now
@@ -405,7 +530,8 @@ void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindo
 		m_toolInputCommands.deleteObject		||
 		m_toolInputCommands.mousePickingActive	||
 		m_toolInputCommands.save				||
-		m_toolInputCommands.wireframeMode))
+		m_toolInputCommands.wireframeMode		||
+		m_toolInputCommands.dumpMemory))
 	{
 		m_executeOnce = false;
 	}//End else if
@@ -416,11 +542,20 @@ void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindo
 		m_d3dRenderer.MoveSelectedObject(m_selectedObject);
 	}//End if
 
-	//Update the highlighted object when the select window is open
+	//The select window picks by database ID - look the object up when it changes, and keep the window's copy current otherwise
 	if(selectWindowOpen)
 	{
-		m_d3dRenderer.HighlightSelectedObject(selectWindowPreviousSelected, m_selectedObject);
+		if(m_dialogueSelectionID != m_d3dRenderer.GetObjectID(m_selectedObject))
+		{
+			const ObjectHandle previousSelected = m_selectedObject;
+			m_selectedObject = m_d3dRenderer.FindObject(m_dialogueSelectionID);
+			m_d3dRenderer.HighlightSelectedObject(previousSelected, m_selectedObject);
+		}//End if
 	}//End if
+	else
+	{
+		m_dialogueSelectionID = m_d3dRenderer.GetObjectID(m_selectedObject);
+	}//End else
 
 	//Has something changed
 		//Update scenegraph
@@ -429,6 +564,15 @@ void ToolMain::Tick(MSG *msg, const bool selectWindowOpen, const int selectWindo
 
 	//Renderer Update Call
 	m_d3dRenderer.Tick(&m_toolInputCommands);
+
+	//End of the frame - the scene is consistent, so this is where this frame's edits are journaled and saves handed off
+	if (!m_d3dRenderer.GetEditJournal().Flush()) TRACE("Edit journal write failed\n");
+	PollSave();
+	const std::chrono::duration<double> sinceLastSave = std::chrono::steady_clock::now() - m_lastSaveTime;
+	if (m_saveRequested || (m_autosaveInterval > 0.0 && sinceLastSave.count() >= m_autosaveInterval))
+	{
+		SubmitSave();
+	}//End if
 }//End Tick
 
 void ToolMain::UpdateInput(const MSG* msg)
@@ -493,6 +637,7 @@ void ToolMain::UpdateInput(const MSG* msg)
 	//MFC interface keyboard commands
 	m_toolInputCommands.save =			m_keyArray[VK_CONTROL] && m_keyArray['S'] ? true : false;
 	m_toolInputCommands.wireframeMode = m_keyArray['1'] || m_keyArray[VK_NUMPAD1] ? true : false;
+	m_toolInputCommands.dumpMemory =	m_keyArray[VK_CONTROL] && m_keyArray['M'] ? true : false;
 
 	//WASD movement (disabled when holding control)
 	if(!m_keyArray[VK_CONTROL])
@@ -3,10 +3,17 @@
 #include <afxext.h>
 #include "../Renderer/pch.h"
 #include "../Renderer/Game.h"
-#include "../SQLITE/sqlite3.h"
-#include "SceneObject.h"
+#include "SceneDatabase.h"
+#include "AutosaveService.h"
+#include "SceneGraph.h"
+#include "SlotMap.h"
+#include "MemoryTracker.h"
+#include "ObjectIDAllocator.h"
 #include "InputCommands.h"
 #include <vector>
+#include <unordered_set>
+#include <string>
+#include <chrono>
 
 class ToolMain
 {
@@ -17,10 +24,18 @@ public:
 
 	//onAction - These are the interface to MFC
 	int				getCurrentSelectionID();								//Returns the selection number of currently selected object so that it can be displayed
+	const std::wstring& getSaveStatusText() const;							//Returns the save state, with the rows the last save wrote, for the status bar
+	void			setAutosaveInterval(double seconds);					//How often pending changes are saved in the background - 0 disables autosave
+	double			getAutosaveInterval() const;
+	std::vector<int> getChunkIDs();											//Every chunk in the database, in ID order
+	int				getCurrentChunkID() const;
+	std::vector<int> getObjectsInBox(const DirectX::SimpleMath::Vector3& min, const DirectX::SimpleMath::Vector3& max);	//IDs of saved objects whose bounds intersect the box
+	std::vector<int> getObjectsInSphere(const DirectX::SimpleMath::Vector3& centre, float radius);						//IDs of saved objects whose bounds intersect the sphere
 	void			onActionInitialise(HWND handle, int width, int height);	//Passes through handle and hieght and width to initialise DirectX renderer and SQL LITE
 	void			onActionFocusCamera();
 	void			onActionLoad();											//Load the current chunk
-	afx_msg	void	onActionSave();											//Save the current chunk
+	void			onActionLoadChunk(int chunkID);							//Save the current chunk's edits, then switch to and load another
+	afx_msg	void	onActionSave();											//Queue a save of the current chunk for the next frame boundary
 	afx_msg void	onActionSaveTerrain();									//Save chunk geometry
 	afx_msg void	onActionUndo();											//Undo an action
 	afx_msg void	onActionRedo();											//Redo an undone action
@@ -29,32 +44,46 @@ public:
 	afx_msg void	onActionPaste();										//Paste an object
 	afx_msg void	onActionDelete();										//Delete an object
 	afx_msg void	onActionWireframe();									//Toggle wireframe rendering
+	void			onActionDumpMemory();									//Write the memory report out as JSON
 
-	void	Tick(MSG* msg, bool selectWindowOpen, const int selectWindowPreviousSelected);
+	void	Tick(MSG* msg, bool selectWindowOpen);
 	void	UpdateInput(const MSG* msg);
 
 private:	
 	void	onContentAdded();
+	void	SubmitSave();													//Hand the changes made since the last save to the autosave worker
+	void	PollSave();														//Pick up the result of a finished background save
+	std::unordered_set<int> ReplayJournal(const std::string& journalPath);	//Reapply edits that never made it into a save, returns the IDs they touched
 #pragma endregion
 
 #pragma region Variables
 public:
-	std::vector<SceneObject>    m_sceneGraph;		//Our SceneGraph storing all the objects in the current chunk
+	SceneGraph					m_sceneGraph;		//The one store of the current chunk's objects - the renderer, saving and the select dialogue all read it
 	ChunkObject					m_chunk;			//Our landscape chunk
-	int							m_selectedObject;	//ID of current selection
+	int							m_dialogueSelectionID;	//Database ID the select dialogue reads and writes, kept in step with the selection
 
 private:
 	HWND			m_toolHandle;					//Handle to the window
+	ObjectHandle	m_selectedObject;				//Handle of the current selection in the renderer's display list
 	Game			m_d3dRenderer;					//Instance of D3D rendering system for our tool
 	InputCommands	m_toolInputCommands;			//Input commands that we want to use and possibly pass over to the renderer
 	CRect			WindowRECT;						//Window area rectangle
 	char			m_keyArray[256];
-	sqlite3*		m_databaseConnection;			//SQL database handle
+	SceneDatabase	m_database;						//SQL database connection and bulk save path
+	AutosaveService	m_autosave;						//Writes saves on a worker thread with its own connection
+	ObjectIDAllocator	m_idAllocator;				//IDs for new objects, reserved through m_database
+	MemoryTracker::Registration	m_sceneGraphMemory;	//Reports the scene graph's size - declared after it so it unregisters first
 
 	int m_width;									//Dimensions passed to directX
 	int m_height;
 	int m_currentChunk;								//The current chunk of the database that we are operating on - dictates loading and saving
 
+	//Autosave
+	bool									m_saveRequested;		//Save explicitly asked for - submitted at the end of the next tick
+	double									m_autosaveInterval;		//Seconds between autosaves, 0 to disable
+	std::chrono::steady_clock::time_point	m_lastSaveTime;
+	std::wstring							m_saveStatusText;
+
 	bool m_executeOnce;								//Hard-stop to prevent multiple commands activating when only one is intended
 #pragma endregion
 };
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include "TransformStore.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+	//Same pi the renderer converted with when it built matrices per draw, so nothing shifts
+	const float DEGREES_TO_RADIANS = 3.14159f / 180.0f;
+
+	//Quaternion for an orientation in degrees, as Quaternion::CreateFromYawPitchRoll(y, x, z) builds it
+	//Yaw turns about Y, pitch about X and roll about Z
+	inline void OrientationToQuaternion(const float orientation[3], float rotation[4])
+	{
+		const float halfPitch = orientation[0] * DEGREES_TO_RADIANS * 0.5f;
+		const float halfYaw = orientation[1] * DEGREES_TO_RADIANS * 0.5f;
+		const float halfRoll = orientation[2] * DEGREES_TO_RADIANS * 0.5f;
+
+		const float cp = cosf(halfPitch), sp = sinf(halfPitch);
+		const float cy = cosf(halfYaw), sy = sinf(halfYaw);
+		const float cr = cosf(halfRoll), sr = sinf(halfRoll);
+
+		rotation[0] = cr * sp * cy + sr * cp * sy;
+		rotation[1] = cr * cp * sy - sr * sp * cy;
+		rotation[2] = sr * cp * cy - cr * sp * sy;
+		rotation[3] = cr * cp * cy + sr * sp * sy;
+	}//End OrientationToQuaternion
+
+	//Scale * Rotation * Translation, as XMMatrixTransformation builds it with no scaling or rotation origin
+	//Only multiplies and adds, written out over plain floats so the per-frame loop vectorises
+	inline void WriteWorldMatrix(const float px, const float py, const float pz, const float qx, const float qy, const float qz, const float qw,
+		const float scaleX, const float scaleY, const float scaleZ, float* matrix)
+	{
+		const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+		const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+		const float xw = qx * qw, yw = qy * qw, zw = qz * qw;
+
+		matrix[0] = scaleX * (1.0f - 2.0f * (yy + zz));	matrix[1] = scaleX * 2.0f * (xy + zw);			matrix[2] = scaleX * 2.0f * (xz - yw);			matrix[3] = 0.0f;
+		matrix[4] = scaleY * 2.0f * (xy - zw);			matrix[5] = scaleY * (1.0f - 2.0f * (xx + zz));	matrix[6] = scaleY * 2.0f * (yz + xw);			matrix[7] = 0.0f;
+		matrix[8] = scaleZ * 2.0f * (xz + yw);			matrix[9] = scaleZ * 2.0f * (yz - xw);			matrix[10] = scaleZ * (1.0f - 2.0f * (xx + yy));	matrix[11] = 0.0f;
+		matrix[12] = px;								matrix[13] = py;								matrix[14] = pz;								matrix[15] = 1.0f;
+	}//End WriteWorldMatrix
+
+	//Inverse of the matrix above, built from the same components rather than by general inversion
+	//The rotation's inverse is its transpose, so this is (1/Scale) applied after the transposed rotation and negated translation
+	inline void WriteInverseWorldMatrix(const float px, const float py, const float pz, const float qx, const float qy, const float qz, const float qw,
+		const float scaleX, const float scaleY, const float scaleZ, float* matrix)
+	{
+		const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+		const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+		const float xw = qx * qw, yw = qy * qw, zw = qz * qw;
+
+		//Rows of the unscaled rotation
+		const float r00 = 1.0f - 2.0f * (yy + zz),	r01 = 2.0f * (xy + zw),			r02 = 2.0f * (xz - yw);
+		const float r10 = 2.0f * (xy - zw),			r11 = 1.0f - 2.0f * (xx + zz),	r12 = 2.0f * (yz + xw);
+		const float r20 = 2.0f * (xz + yw),			r21 = 2.0f * (yz - xw),			r22 = 1.0f - 2.0f * (xx + yy);
+		const float ix = 1.0f / scaleX, iy = 1.0f / scaleY, iz = 1.0f / scaleZ;
+
+		matrix[0] = r00 * ix;	matrix[1] = r10 * iy;	matrix[2] = r20 * iz;	matrix[3] = 0.0f;
+		matrix[4] = r01 * ix;	matrix[5] = r11 * iy;	matrix[6] = r21 * iz;	matrix[7] = 0.0f;
+		matrix[8] = r02 * ix;	matrix[9] = r12 * iy;	matrix[10] = r22 * iz;	matrix[11] = 0.0f;
+		matrix[12] = -(px * r00 + py * r01 + pz * r02) * ix;
+		matrix[13] = -(px * r10 + py * r11 + pz * r12) * iy;
+		matrix[14] = -(px * r20 + py * r21 + pz * r22) * iz;
+		matrix[15] = 1.0f;
+	}//End WriteInverseWorldMatrix
+
+	//result = left * right, for affine matrices in the layout above - result may not alias either input
+	inline void MultiplyAffine(const float* left, const float* right, float* result)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			const float l0 = left[row * 4], l1 = left[row * 4 + 1], l2 = left[row * 4 + 2], l3 = left[row * 4 + 3];
+			for (int column = 0; column < 4; column++)
+			{
+				result[row * 4 + column] = l0 * right[column] + l1 * right[4 + column] + l2 * right[8 + column] + l3 * right[12 + column];
+			}//End for
+		}//End for
+	}//End MultiplyAffine
+
+	//Levels smaller than this are rebuilt on the calling thread - waking workers costs more than a few hundred matrices
+	const int MIN_PARALLEL_BATCH = 256;
+}
+
+const int TransformStore::NO_PARENT;
+
+int TransformStore::Allocate()
+{
+	//Released slots were reset when they were given back, so they can be handed out as they are
+	if (!m_freeSlots.empty())
+	{
+		const int slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		return slot;
+	}//End if
+
+	const int slot = GetNumSlots();
+
+	m_positionX.push_back(0.0f);	m_positionY.push_back(0.0f);	m_positionZ.push_back(0.0f);
+	m_orientationX.push_back(0.0f);	m_orientationY.push_back(0.0f);	m_orientationZ.push_back(0.0f);
+	m_rotationX.push_back(0.0f);	m_rotationY.push_back(0.0f);	m_rotationZ.push_back(0.0f);	m_rotationW.push_back(1.0f);
+	m_scaleX.push_back(1.0f);		m_scaleY.push_back(1.0f);		m_scaleZ.push_back(1.0f);
+	m_worldMatrices.resize(m_worldMatrices.size() + 16);
+	m_inverseMatrices.resize(m_inverseMatrices.size() + 16);
+	m_dirty.push_back(0);
+	m_parents.push_back(NO_PARENT);
+	m_numChildren.push_back(0);
+	m_orderChanged = true;
+
+	//Identity is its own inverse
+	WriteWorldMatrix(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, &m_worldMatrices[slot * 16]);
+	WriteWorldMatrix(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, &m_inverseMatrices[slot * 16]);
+	return slot;
+}//End Allocate
+
+void TransformStore::Release(const int slot)
+{
+	//Children are rare here - delete and cut take them too - so finding them can afford a pass over the parents
+	if (m_numChildren[slot] != 0)
+	{
+		for (int child = 0; child < GetNumSlots(); child++)
+		{
+			if (m_parents[child] == slot) SetParent(child, NO_PARENT);
+		}//End for
+	}//End if
+	SetParent(slot, NO_PARENT);
+
+	//Not dirty, so an update doesn't rebuild it and the next owner's first change queues it
+	if (m_dirty[slot])
+	{
+		m_dirty[slot] = 0;
+		m_dirtySlots.erase(std::find(m_dirtySlots.begin(), m_dirtySlots.end(), slot));
+	}//End if
+
+	m_positionX[slot] = m_positionY[slot] = m_positionZ[slot] = 0.0f;
+	m_orientationX[slot] = m_orientationY[slot] = m_orientationZ[slot] = 0.0f;
+	m_rotationX[slot] = m_rotationY[slot] = m_rotationZ[slot] = 0.0f;
+	m_rotationW[slot] = 1.0f;
+	m_scaleX[slot] = m_scaleY[slot] = m_scaleZ[slot] = 1.0f;
+	WriteWorldMatrix(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, &m_worldMatrices[slot * 16]);
+	WriteWorldMatrix(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, &m_inverseMatrices[slot * 16]);
+	m_freeSlots.push_back(slot);
+}//End Release
+
+void TransformStore::Clear()
+{
+	m_positionX.clear();	m_positionY.clear();	m_positionZ.clear();
+	m_orientationX.clear();	m_orientationY.clear();	m_orientationZ.clear();
+	m_rotationX.clear();	m_rotationY.clear();	m_rotationZ.clear();	m_rotationW.clear();
+	m_scaleX.clear();		m_scaleY.clear();		m_scaleZ.clear();
+	m_worldMatrices.clear();
+	m_inverseMatrices.clear();
+	m_dirty.clear();
+	m_dirtySlots.clear();
+	m_parents.clear();
+	m_numChildren.clear();
+	m_order.clear();
+	m_levelStarts.clear();
+	m_orderChanged = false;
+	m_freeSlots.clear();
+}//End Clear
+
+void TransformStore::SetPosition(const int slot, const float position[3])
+{
+	m_positionX[slot] = position[0];
+	m_positionY[slot] = position[1];
+	m_positionZ[slot] = position[2];
+	MarkDirty(slot);
+}//End SetPosition
+
+void TransformStore::SetOrientation(const int slot, const float orientation[3])
+{
+	m_orientationX[slot] = orientation[0];
+	m_orientationY[slot] = orientation[1];
+	m_orientationZ[slot] = orientation[2];
+
+	float rotation[4];
+	OrientationToQuaternion(orientation, rotation);
+	m_rotationX[slot] = rotation[0];
+	m_rotationY[slot] = rotation[1];
+	m_rotationZ[slot] = rotation[2];
+	m_rotationW[slot] = rotation[3];
+	MarkDirty(slot);
+}//End SetOrientation
+
+void TransformStore::SetScale(const int slot, const float scale[3])
+{
+	m_scaleX[slot] = scale[0];
+	m_scaleY[slot] = scale[1];
+	m_scaleZ[slot] = scale[2];
+	MarkDirty(slot);
+}//End SetScale
+
+void TransformStore::CopyTransform(const int fromSlot, const int toSlot)
+{
+	m_positionX[toSlot] = m_positionX[fromSlot];		m_positionY[toSlot] = m_positionY[fromSlot];		m_positionZ[toSlot] = m_positionZ[fromSlot];
+	m_orientationX[toSlot] = m_orientationX[fromSlot];	m_orientationY[toSlot] = m_orientationY[fromSlot];	m_orientationZ[toSlot] = m_orientationZ[fromSlot];
+	m_rotationX[toSlot] = m_rotationX[fromSlot];		m_rotationY[toSlot] = m_rotationY[fromSlot];		m_rotationZ[toSlot] = m_rotationZ[fromSlot];		m_rotationW[toSlot] = m_rotationW[fromSlot];
+	m_scaleX[toSlot] = m_scaleX[fromSlot];				m_scaleY[toSlot] = m_scaleY[fromSlot];				m_scaleZ[toSlot] = m_scaleZ[fromSlot];
+
+	//The source's matrices can be taken as they are if they are current, apply under the same parent and have nothing below to pass on to
+	//Otherwise the destination is left to the next update
+	const bool sameParent = m_parents[toSlot] == m_parents[fromSlot];
+	SetParent(toSlot, m_parents[fromSlot]);
+	if (!sameParent || IsDirty(fromSlot) || m_numChildren[toSlot] != 0)
+	{
+		MarkDirty(toSlot);
+		return;
+	}//End if
+	memcpy(&m_worldMatrices[toSlot * 16], &m_worldMatrices[fromSlot * 16], 16 * sizeof(float));
+	memcpy(&m_inverseMatrices[toSlot * 16], &m_inverseMatrices[fromSlot * 16], 16 * sizeof(float));
+}//End CopyTransform
+
+void TransformStore::GetPosition(const int slot, float position[3]) const
+{
+	position[0] = m_positionX[slot];
+	position[1] = m_positionY[slot];
+	position[2] = m_positionZ[slot];
+}//End GetPosition
+
+void TransformStore::GetOrientation(const int slot, float orientation[3]) const
+{
+	orientation[0] = m_orientationX[slot];
+	orientation[1] = m_orientationY[slot];
+	orientation[2] = m_orientationZ[slot];
+}//End GetOrientation
+
+void TransformStore::GetScale(const int slot, float scale[3]) const
+{
+	scale[0] = m_scaleX[slot];
+	scale[1] = m_scaleY[slot];
+	scale[2] = m_scaleZ[slot];
+}//End GetScale
+
+bool TransformStore::SetParent(const int slot, const int parentSlot)
+{
+	if (parentSlot == m_parents[slot]) return true;
+
+	//Walking up from the new parent must not lead back here, or the hierarchy would have a cycle
+	for (int ancestor = parentSlot; ancestor != NO_PARENT; ancestor = m_parents[ancestor])
+	{
+		if (ancestor == slot) return false;
+	}//End for
+
+	if (m_parents[slot] != NO_PARENT) m_numChildren[m_parents[slot]]--;
+	m_parents[slot] = parentSlot;
+	if (parentSlot != NO_PARENT) m_numChildren[parentSlot]++;
+
+	m_orderChanged = true;
+	MarkDirty(slot);
+	return true;
+}//End SetParent
+
+int TransformStore::GetNumLevels()
+{
+	if (m_orderChanged) RebuildOrder();
+	return static_cast<int>(m_levelStarts.size()) - 1;
+}//End GetNumLevels
+
+int TransformStore::UpdateWorldMatrices(WorkerPool* workers)
+{
+	//Leaves can be rebuilt on their own - their parents are either clean or, having children, send this down the level pass
+	bool reachesChildren = false;
+	for (const int slot : m_dirtySlots)
+	{
+		if (m_numChildren[slot] != 0)
+		{
+			reachesChildren = true;
+			break;
+		}//End if
+	}//End for
+
+	if (reachesChildren)
+	{
+		m_numRecomputed = PropagateLevels(workers);
+		std::fill(m_dirty.begin(), m_dirty.end(), static_cast<uint8_t>(0));
+	}//End if
+	else
+	{
+		for (const int slot : m_dirtySlots)
+		{
+			UpdateSlot(slot);
+			m_dirty[slot] = 0;
+		}//End for
+		m_numRecomputed = static_cast<int>(m_dirtySlots.size());
+	}//End else
+
+	m_dirtySlots.clear();
+	return m_numRecomputed;
+}//End UpdateWorldMatrices
+
+void TransformStore::UpdateAllWorldMatrices()
+{
+	//Raw pointers keep the loop free of vector bookkeeping so the compiler can keep everything in registers
+	const float* px = m_positionX.data();	const float* py = m_positionY.data();	const float* pz = m_positionZ.data();
+	const float* qx = m_rotationX.data();	const float* qy = m_rotationY.data();	const float* qz = m_rotationZ.data();	const float* qw = m_rotationW.data();
+	const float* sx = m_scaleX.data();		const float* sy = m_scaleY.data();		const float* sz = m_scaleZ.data();
+	float* matrices = m_worldMatrices.data();
+	float* inverses = m_inverseMatrices.data();
+
+	const int numSlots = GetNumSlots();
+	for (int i = 0; i < numSlots; i++)
+	{
+		WriteWorldMatrix(px[i], py[i], pz[i], qx[i], qy[i], qz[i], qw[i], sx[i], sy[i], sz[i], matrices + i * 16);
+		WriteInverseWorldMatrix(px[i], py[i], pz[i], qx[i], qy[i], qz[i], qw[i], sx[i], sy[i], sz[i], inverses + i * 16);
+	}//End for
+
+	//Those were local matrices - children then take on their parent's, level by level below the roots
+	if (m_orderChanged) RebuildOrder();
+	const int firstChild = m_levelStarts.size() > 1 ? m_levelStarts[1] : numSlots;
+	for (int i = firstChild; i < numSlots; i++) ApplyParent(m_order[i]);
+
+	for (const int slot : m_dirtySlots) m_dirty[slot] = 0;
+	m_dirtySlots.clear();
+	m_numRecomputed = numSlots;
+}//End UpdateAllWorldMatrices
+
+void TransformStore::ComposeWorldMatrix(const float position[3], const float orientation[3], const float scale[3], float matrix[16])
+{
+	float rotation[4];
+	OrientationToQuaternion(orientation, rotation);
+	WriteWorldMatrix(position[0], position[1], position[2], rotation[0], rotation[1], rotation[2], rotation[3], scale[0], scale[1], scale[2], matrix);
+}//End ComposeWorldMatrix
+
+size_t TransformStore::GetMemoryUsage() const
+{
+	const std::vector<float>* floatArrays[] = { &m_positionX, &m_positionY, &m_positionZ, &m_orientationX, &m_orientationY, &m_orientationZ,
+		&m_rotationX, &m_rotationY, &m_rotationZ, &m_rotationW, &m_scaleX, &m_scaleY, &m_scaleZ, &m_worldMatrices, &m_inverseMatrices };
+	const std::vector<int>* intArrays[] = { &m_dirtySlots, &m_parents, &m_numChildren, &m_order, &m_levelStarts, &m_freeSlots };
+
+	size_t bytes = m_dirty.capacity() * sizeof(uint8_t);
+	for (const std::vector<float>* floats : floatArrays) bytes += floats->capacity() * sizeof(float);
+	for (const std::vector<int>* ints : intArrays) bytes += ints->capacity() * sizeof(int);
+	return bytes;
+}//End GetMemoryUsage
+
+void TransformStore::MarkDirty(const int slot)
+{
+	if (m_dirty[slot]) return;
+
+	m_dirty[slot] = 1;
+	m_dirtySlots.push_back(slot);
+}//End MarkDirty
+
+void TransformStore::UpdateSlot(const int slot)
+{
+	WriteWorldMatrix(m_positionX[slot], m_positionY[slot], m_positionZ[slot], m_rotationX[slot], m_rotationY[slot], m_rotationZ[slot], m_rotationW[slot],
+		m_scaleX[slot], m_scaleY[slot], m_scaleZ[slot], &m_worldMatrices[slot * 16]);
+	WriteInverseWorldMatrix(m_positionX[slot], m_positionY[slot], m_positionZ[slot], m_rotationX[slot], m_rotationY[slot], m_rotationZ[slot], m_rotationW[slot],
+		m_scaleX[slot], m_scaleY[slot], m_scaleZ[slot], &m_inverseMatrices[slot * 16]);
+	if (m_parents[slot] != NO_PARENT) ApplyParent(slot);
+}//End UpdateSlot
+
+void TransformStore::ApplyParent(const int slot)
+{
+	//World is local then parent, so its inverse is the parent's inverse then the local inverse
+	const int parent = m_parents[slot];
+	float local[16];
+	memcpy(local, &m_worldMatrices[slot * 16], sizeof(local));
+	MultiplyAffine(local, &m_worldMatrices[parent * 16], &m_worldMatrices[slot * 16]);
+	memcpy(local, &m_inverseMatrices[slot * 16], sizeof(local));
+	MultiplyAffine(&m_inverseMatrices[parent * 16], local, &m_inverseMatrices[slot * 16]);
+}//End ApplyParent
+
+void TransformStore::RebuildOrder()
+{
+	const int numSlots = GetNumSlots();
+
+	//Children of each slot, packed contiguously - childStarts[slot] up to childStarts[slot + 1]
+	std::vector<int> childStarts(numSlots + 1, 0);
+	for (int slot = 0; slot < numSlots; slot++)
+	{
+		if (m_parents[slot] != NO_PARENT) childStarts[m_parents[slot] + 1]++;
+	}//End for
+	for (int slot = 0; slot < numSlots; slot++) childStarts[slot + 1] += childStarts[slot];
+
+	std::vector<int> children(childStarts[numSlots]);
+	std::vector<int> nextChild(childStarts.begin(), childStarts.end() - 1);
+	for (int slot = 0; slot < numSlots; slot++)
+	{
+		if (m_parents[slot] != NO_PARENT) children[nextChild[m_parents[slot]]++] = slot;
+	}//End for
+
+	//Roots first, then each level's children after it - slots stay in slot order within a level
+	m_order.clear();
+	m_order.reserve(numSlots);
+	for (int slot = 0; slot < numSlots; slot++)
+	{
+		if (m_parents[slot] == NO_PARENT) m_order.push_back(slot);
+	}//End for
+
+	m_levelStarts.assign(1, 0);
+	while (m_levelStarts.back() < static_cast<int>(m_order.size()))
+	{
+		const int levelBegin = m_levelStarts.back();
+		const int levelEnd = static_cast<int>(m_order.size());
+		for (int i = levelBegin; i < levelEnd; i++)
+		{
+			const int slot = m_order[i];
+			m_order.insert(m_order.end(), children.begin() + childStarts[slot], children.begin() + childStarts[slot + 1]);
+		}//End for
+		m_levelStarts.push_back(levelEnd);
+	}//End while
+
+	m_orderChanged = false;
+}//End RebuildOrder
+
+int TransformStore::PropagateLevels(WorkerPool* workers)
+{
+	if (m_orderChanged) RebuildOrder();
+
+	//A slot is rebuilt if it changed or its parent was rebuilt one level up, which the parent records by staying flagged dirty
+	//Each level only reads flags of the level above and writes its own, so a level's slots can be shared out freely
+	uint8_t* dirty = m_dirty.data();
+	const int* parents = m_parents.data();
+	const int* order = m_order.data();
+	std::atomic<int> numRebuilt(0);
+	int levelBegin = 0;
+
+	const std::function<void(int, int)> rebuildRange = [this, dirty, parents, order, &numRebuilt, &levelBegin](const int first, const int last)
+	{
+		int rebuilt = 0;
+		for (int i = levelBegin + first; i < levelBegin + last; i++)
+		{
+			const int slot = order[i];
+			const int parent = parents[slot];
+			if (dirty[slot] || (parent != NO_PARENT && dirty[parent]))
+			{
+				UpdateSlot(slot);
+				dirty[slot] = 1;
+				rebuilt++;
+			}//End if
+		}//End for
+		numRebuilt += rebuilt;
+	};
+
+	for (size_t level = 0; level + 1 < m_levelStarts.size(); level++)
+	{
+		levelBegin = m_levelStarts[level];
+		const int levelSize = m_levelStarts[level + 1] - levelBegin;
+		if (workers) workers->ParallelFor(levelSize, MIN_PARALLEL_BATCH, rebuildRange);
+		else rebuildRange(0, levelSize);
+	}//End for
+
+	return numRebuilt;
+}//End PropagateLevels
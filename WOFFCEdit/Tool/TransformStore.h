@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+
+//Object transforms kept as a structure of arrays - one contiguous array per component, plus world matrices and their inverses
+//Display objects refer to a slot rather than carrying their own transform, so per-frame passes stream through
+//tightly packed floats instead of striding over models, paths and light data
+//Rotations are turned into quaternions when the orientation is set, so rebuilding matrices needs no trigonometry
+//Matrices are 16 floats, row-major with row vectors, laid out exactly as an XMFLOAT4X4
+//Matrices are cached - setting a component marks the slot dirty, and only dirty slots are rebuilt, so a frame without edits does no transform math
+//Slots can have a parent, in which case their components are relative to it and changing a parent rebuilds everything below it
+//The hierarchy is kept in breadth-first order, so matrices propagate a level at a time and each level can be split across threads
+class TransformStore
+{
+public:
+	int		Allocate();											//New root slot at the origin with unit scale - released slots are reused first
+	void	Release(int slot);									//Give the slot back for reuse - any children are left as roots
+	void	Clear();											//Drop every slot - previously returned slots become invalid
+
+	int		GetNumSlots() const { return static_cast<int>(m_positionX.size()); }
+
+	//Position and scale in the parent's units, orientation in degrees as stored in the database
+	void	SetPosition(int slot, const float position[3]);
+	void	SetOrientation(int slot, const float orientation[3]);
+	void	SetScale(int slot, const float scale[3]);
+	void	CopyTransform(int fromSlot, int toSlot);			//Components and parent
+
+	//NO_PARENT makes the slot a root. Fails, changing nothing, if the parent is the slot itself or one of its descendants
+	static const int NO_PARENT = -1;
+	bool	SetParent(int slot, int parentSlot);
+	int		GetParent(const int slot) const { return m_parents[slot]; }
+	int		GetNumLevels();										//Depth of the deepest slot plus one
+
+	void	GetPosition(int slot, float position[3]) const;
+	void	GetOrientation(int slot, float orientation[3]) const;
+	void	GetScale(int slot, float scale[3]) const;
+
+	//Rebuild the world and inverse world matrices of every slot changed since the last update, and of everything below them
+	//Returns how many were rebuilt. Matrices read before the update still describe the slot's previous transform
+	//Given a pool, levels big enough to be worth it are split across its threads
+	int		UpdateWorldMatrices(WorkerPool* workers = nullptr);
+	void	UpdateAllWorldMatrices();							//Rebuild every slot regardless, e.g. to time the full pass
+	int		GetNumRecomputed() const { return m_numRecomputed; }	//Slots rebuilt by the last update
+	bool	IsDirty(const int slot) const { return m_dirty[slot] != 0; }
+
+	const float* GetWorldMatrix(const int slot) const			{ return &m_worldMatrices[slot * 16]; }
+	const float* GetInverseWorldMatrix(const int slot) const	{ return &m_inverseMatrices[slot * 16]; }	//World to object space, for ray tests
+
+	//The matrix the renderer has always drawn with - scale, then yaw/pitch/roll rotation, then translation
+	static void ComposeWorldMatrix(const float position[3], const float orientation[3], const float scale[3], float matrix[16]);
+
+	size_t	GetMemoryUsage() const;								//Every per-slot array and the hierarchy order
+
+private:
+	void	MarkDirty(int slot);
+	void	UpdateSlot(int slot);
+	void	ApplyParent(int slot);								//Turn the slot's local matrices into world ones - the parent's must be current
+	void	RebuildOrder();										//Sort slots breadth-first from the roots
+	int		PropagateLevels(WorkerPool* workers);				//Rebuild dirty slots and their descendants level by level
+
+	std::vector<float>	m_positionX, m_positionY, m_positionZ;
+	std::vector<float>	m_orientationX, m_orientationY, m_orientationZ;		//Degrees, kept exactly as set for saving
+	std::vector<float>	m_rotationX, m_rotationY, m_rotationZ, m_rotationW;	//The same orientation as a quaternion
+	std::vector<float>	m_scaleX, m_scaleY, m_scaleZ;
+	std::vector<float>	m_worldMatrices;
+	std::vector<float>	m_inverseMatrices;
+	std::vector<uint8_t>	m_dirty;										//Per slot, so a slot is only queued once
+	std::vector<int>	m_dirtySlots;
+	int					m_numRecomputed = 0;
+
+	std::vector<int>	m_parents;
+	std::vector<int>	m_numChildren;
+	std::vector<int>	m_order;										//Every slot, breadth-first from the roots
+	std::vector<int>	m_levelStarts;									//Where each level begins in m_order, plus the end
+	bool				m_orderChanged = false;							//m_order needs rebuilding before it is next used
+	std::vector<int>	m_freeSlots;									//Released slots, kept as clean roots at the origin
+};
@@ -0,0 +1,84 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+const int WorkerPool::DEFAULT_WORKERS;
+
+WorkerPool::WorkerPool(const int numWorkers) : m_generation(0), m_activeWorkers(0), m_stopping(false), m_body(nullptr), m_count(0), m_batchSize(1), m_nextBatch(0)
+{
+	const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+	const int workers = numWorkers == DEFAULT_WORKERS ? std::max(hardwareThreads - 1, 0) : std::max(numWorkers, 0);
+
+	m_workers.reserve(workers);
+	for (int i = 0; i < workers; i++) m_workers.emplace_back(&WorkerPool::WorkerLoop, this);
+}//End constructor
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers) worker.join();
+}//End destructor
+
+void WorkerPool::ParallelFor(const int count, const int minBatch, const std::function<void(int, int)>& body)
+{
+	if (count <= 0) return;
+	if (m_workers.empty() || count <= minBatch)
+	{
+		body(0, count);
+		return;
+	}//End if
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_body = &body;
+		m_count = count;
+
+		//A few batches per thread lets fast threads pick up the slack of slow ones
+		const int numBatches = GetNumThreads() * 4;
+		m_batchSize = std::max(minBatch, (count + numBatches - 1) / numBatches);
+		m_nextBatch = 0;
+		m_activeWorkers = static_cast<int>(m_workers.size());
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	RunBatches();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this] { return m_activeWorkers == 0; });
+	m_body = nullptr;
+}//End ParallelFor
+
+void WorkerPool::WorkerLoop()
+{
+	uint64_t finishedGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this, finishedGeneration] { return m_stopping || m_generation != finishedGeneration; });
+			if (m_stopping) return;
+			finishedGeneration = m_generation;
+		}
+
+		RunBatches();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_activeWorkers == 0) m_done.notify_one();
+	}//End for
+}//End WorkerLoop
+
+void WorkerPool::RunBatches()
+{
+	for (;;)
+	{
+		const int begin = m_nextBatch.fetch_add(m_batchSize);
+		if (begin >= m_count) return;
+
+		(*m_body)(begin, std::min(begin + m_batchSize, m_count));
+	}//End for
+}//End RunBatches
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of worker threads for splitting a loop across cores - the calling thread takes batches too
+//Workers sleep between loops, so a pool can be kept for the life of the editor and used every frame
+//One loop runs at a time; ParallelFor must not be called from inside a batch
+class WorkerPool
+{
+public:
+	static const int DEFAULT_WORKERS = -1;					//One per hardware thread beyond the caller's
+
+	explicit WorkerPool(int numWorkers = DEFAULT_WORKERS);
+	~WorkerPool();
+
+	int		GetNumThreads() const { return static_cast<int>(m_workers.size()) + 1; }
+
+	//Run body(begin, end) over batches covering [0, count) and return once all are done
+	//Loops of no more than minBatch items run on the calling thread alone, as waking the workers would cost more than it saves
+	void	ParallelFor(int count, int minBatch, const std::function<void(int, int)>& body);
+
+private:
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	void	WorkerLoop();
+	void	RunBatches();
+
+	std::vector<std::thread>				m_workers;
+	std::mutex								m_mutex;
+	std::condition_variable					m_wake;
+	std::condition_variable					m_done;
+	uint64_t								m_generation;		//Bumped for each loop, so a worker knows it has new work
+	int										m_activeWorkers;	//Workers yet to finish the current loop
+	bool									m_stopping;
+
+	const std::function<void(int, int)>*	m_body;
+	int										m_count;
+	int										m_batchSize;
+	std::atomic<int>						m_nextBatch;
+};